@@ -7,23 +7,37 @@
 #include <string>
 
 class Arc : public Segment { /*!< Arc is a Segment consisting of a center Point2, radius and start and end angles.
-    You can flip the direction by setting forwards */
+    It always runs from start_angle to end_angle, counter clockwise if end_angle is larger. forwards is stored and
+    compared but does not change the direction, swap the angles to reverse an arc (see Contour::reverseElement).
+    Read only after construction, so the end points cached by Segment stay those of the arc; build a new Arc to change one. */
 public:
-    Point2 center;
-    double radius;
-    double start_angle;
-    double end_angle;
-    bool forwards = true;
-    unsigned int resolution;
-
     Arc(const Point2& c, double r, double start, double end, unsigned int resolution = 20, bool fw=true);
 
+    const Point2& getCenter() const { return center; }
+    double getRadius() const { return radius; }
+    double getStartAngle() const { return start_angle; }
+    double getEndAngle() const { return end_angle; }
+    bool isForwards() const { return forwards; }
+    unsigned int getResolution() const { return resolution; }
+
     Point2 getCoordinate(double t) const override;
     bool operator==(const Segment& other) const override;
     void print(const std::string& padding) const override;
     std::vector<Point2> getLineStrip() const override;
+    BoundingBox getBounds() const override;
+    double getClosestParameter(const Point2& point) const override;
+
+    // Angle at t<-[0,1], following the same direction as getCoordinate
+    double getAngle(double t) const;
 
 private:
     Point2 getPoint(double t) const;
+
+    Point2 center;
+    double radius;
+    double start_angle;
+    double end_angle;
+    bool forwards = true;
+    unsigned int resolution;
 };
 #endif
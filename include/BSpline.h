@@ -0,0 +1,48 @@
+#pragma once
+#ifndef BSPLINE_H
+#define BSPLINE_H
+
+#include <Config.h>
+#include <Segment.h>
+#include <string>
+#include <vector>
+
+#include "CubicBezier.h"
+
+class BSpline : public Segment { /*!< BSpline is a clamped B-spline Segment of degree 1 to 3 with uniform or non-uniform knots.
+    The curve is split into Bezier pieces once at construction (knot insertion), evaluation and flattening run on those. */
+public:
+    double flatness;
+
+    // Uniform clamped knot vector
+    BSpline(std::vector<Point2> control_points, unsigned int degree = 3, double flatness = 1E-3);
+    // Clamped knot vector of control_points.size() + degree + 1 knots
+    BSpline(std::vector<Point2> control_points, std::vector<double> knots, unsigned int degree = 3, double flatness = 1E-3);
+
+    Point2 getCoordinate(double t) const override;
+    bool operator==(const Segment& other) const override;
+    void print(const std::string& padding) const override;
+    std::vector<Point2> getLineStrip() const override;
+    BoundingBox getBounds() const override;
+    double getClosestParameter(const Point2& point) const override;
+
+    std::vector<Point2> getLineStrip(double tolerance) const;
+    // First derivative with respect to t
+    Point2 getDerivative(double t) const;
+
+    const std::vector<Point2>& getControlPoints() const { return _control_points; }
+    const std::vector<double>& getKnots() const { return _knots; }
+    unsigned int getDegree() const { return _degree; }
+    // One cubic per non-empty knot span, lower degrees are elevated
+    const std::vector<CubicBezier>& getBezierPieces() const { return _pieces; }
+
+private:
+    void buildPieces();
+
+    std::vector<Point2> _control_points;
+    std::vector<double> _knots;
+    unsigned int _degree;
+    std::vector<CubicBezier> _pieces;
+    std::vector<double> _breakpoints; // distinct knots of the domain, piece i spans [_breakpoints[i], _breakpoints[i + 1]]
+};
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef BOUNDINGBOX_H
+#define BOUNDINGBOX_H
+
+#include <algorithm>
+#include <limits>
+#include "Point2.h"
+
+struct BoundingBox { /*!< Axis aligned bounding box. A default constructed box is empty and grows with expand. */
+	Point2 min{ std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+	Point2 max{ -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+
+	[[nodiscard]] bool isEmpty() const
+	{
+		return min.x > max.x || min.y > max.y;
+	}
+
+	void expand(const Point2& point)
+	{
+		min.x = std::min(min.x, point.x);
+		min.y = std::min(min.y, point.y);
+		max.x = std::max(max.x, point.x);
+		max.y = std::max(max.y, point.y);
+	}
+
+	void expand(const BoundingBox& box)
+	{
+		min.x = std::min(min.x, box.min.x);
+		min.y = std::min(min.y, box.min.y);
+		max.x = std::max(max.x, box.max.x);
+		max.y = std::max(max.y, box.max.y);
+	}
+
+	[[nodiscard]] bool contains(const Point2& point) const
+	{
+		return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+	}
+
+	[[nodiscard]] bool overlaps(const BoundingBox& box) const
+	{
+		return min.x <= box.max.x && box.min.x <= max.x && min.y <= box.max.y && box.min.y <= max.y;
+	}
+
+	// Squared distance from a point to the box, zero inside. Used as a lower bound when pruning.
+	[[nodiscard]] double distanceSquaredTo(const Point2& point) const
+	{
+		const double dx = std::max({ min.x - point.x, 0.0, point.x - max.x });
+		const double dy = std::max({ min.y - point.y, 0.0, point.y - max.y });
+		return dx * dx + dy * dy;
+	}
+};
+
+#endif
@@ -0,0 +1,456 @@
+#pragma once
+#ifndef CHUNKEDVECTOR_H
+#define CHUNKEDVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* Sequence container stored as a list of contiguous chunks of at most ChunkSize elements.
+ * A Fenwick tree over the chunk sizes finds the chunk holding an index in O(log C), so a positional
+ * insert or erase moves at most ChunkSize elements instead of every later element of a std::vector.
+ * Splitting or dropping a chunk rebuilds the tree in O(C), which happens once every ~ChunkSize / 2 edits.
+ * Iteration walks each chunk linearly and stays cache friendly.
+ * The interface follows std::vector where Contour needs it, iterators are invalidated by every modification.
+ */
+template <typename T, size_t ChunkSize = 256>
+class ChunkedVector {
+	static_assert(ChunkSize >= 4, "ChunkSize must be at least 4");
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+
+	template <bool Const>
+	class Iterator { /*!< Random access iterator, keeps the global index and the chunk position */
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, const T*, T*>;
+		using reference = std::conditional_t<Const, const T&, T&>;
+		using container_type = std::conditional_t<Const, const ChunkedVector, ChunkedVector>;
+
+		Iterator() = default;
+		Iterator(container_type* owner, size_t index) : _owner(owner), _index(index)
+		{
+			_owner->locate(index, _chunk, _offset);
+		}
+		Iterator(container_type* owner, size_t index, size_t chunk, size_t offset)
+			: _owner(owner), _index(index), _chunk(chunk), _offset(offset) {}
+
+		// iterator converts to const_iterator
+		template <bool C = Const, typename = std::enable_if_t<C>>
+		Iterator(const Iterator<false>& other) : _owner(other._owner), _index(other._index), _chunk(other._chunk), _offset(other._offset) {}
+
+		reference operator*() const { return _owner->_chunks[_chunk][_offset]; }
+		pointer operator->() const { return &_owner->_chunks[_chunk][_offset]; }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		Iterator& operator++()
+		{
+			++_index;
+			if (++_offset == _owner->_chunks[_chunk].size() && _chunk + 1 < _owner->_chunks.size())
+			{
+				++_chunk;
+				_offset = 0;
+			}
+			return *this;
+		}
+		Iterator operator++(int) { Iterator copy = *this; ++(*this); return copy; }
+		Iterator& operator--()
+		{
+			--_index;
+			if (_offset == 0)
+			{
+				--_chunk;
+				_offset = _owner->_chunks[_chunk].size();
+			}
+			--_offset;
+			return *this;
+		}
+		Iterator operator--(int) { Iterator copy = *this; --(*this); return copy; }
+
+		Iterator& operator+=(difference_type n)
+		{
+			_index += n;
+			_owner->locate(_index, _chunk, _offset);
+			return *this;
+		}
+		Iterator& operator-=(difference_type n) { return *this += -n; }
+		friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+		friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+		friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+		friend difference_type operator-(const Iterator& a, const Iterator& b)
+		{
+			return static_cast<difference_type>(a._index) - static_cast<difference_type>(b._index);
+		}
+
+		friend bool operator==(const Iterator& a, const Iterator& b) { return a._index == b._index; }
+		friend bool operator!=(const Iterator& a, const Iterator& b) { return a._index != b._index; }
+		friend bool operator<(const Iterator& a, const Iterator& b) { return a._index < b._index; }
+		friend bool operator>(const Iterator& a, const Iterator& b) { return a._index > b._index; }
+		friend bool operator<=(const Iterator& a, const Iterator& b) { return a._index <= b._index; }
+		friend bool operator>=(const Iterator& a, const Iterator& b) { return a._index >= b._index; }
+
+		size_t index() const { return _index; }
+
+	private:
+		friend class ChunkedVector;
+		template <bool> friend class Iterator;
+
+		container_type* _owner = nullptr;
+		size_t _index = 0;
+		size_t _chunk = 0;
+		size_t _offset = 0;
+	};
+
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	ChunkedVector() = default;
+	ChunkedVector(const ChunkedVector&) = default;
+	ChunkedVector& operator=(const ChunkedVector&) = default;
+	// A moved from container is left empty, like std::vector
+	ChunkedVector(ChunkedVector&& other) noexcept
+		: _chunks(std::move(other._chunks)), _fenwick(std::move(other._fenwick)), _size(std::exchange(other._size, 0))
+	{
+		other.clear();
+	}
+	ChunkedVector& operator=(ChunkedVector&& other) noexcept
+	{
+		if (this != &other)
+		{
+			_chunks = std::move(other._chunks);
+			_fenwick = std::move(other._fenwick);
+			_size = std::exchange(other._size, 0);
+			other.clear();
+		}
+		return *this;
+	}
+	ChunkedVector(std::initializer_list<T> items) { insert(end(), items.begin(), items.end()); }
+	template <typename InputIt>
+	ChunkedVector(InputIt first, InputIt last) { insert(end(), first, last); }
+
+	size_t size() const { return _size; }
+	bool empty() const { return _size == 0; }
+	size_t chunkCount() const { return _chunks.size(); }
+	void reserve(size_t) {} // chunks are allocated on demand
+
+	void clear()
+	{
+		_chunks.clear();
+		_fenwick.clear();
+		_size = 0;
+	}
+
+	T& operator[](size_t index)
+	{
+		size_t chunk, offset;
+		locate(index, chunk, offset);
+		return _chunks[chunk][offset];
+	}
+	const T& operator[](size_t index) const
+	{
+		size_t chunk, offset;
+		locate(index, chunk, offset);
+		return _chunks[chunk][offset];
+	}
+	T& at(size_t index)
+	{
+		if (index >= _size) throw std::out_of_range("Index is out of bounds");
+		return (*this)[index];
+	}
+	const T& at(size_t index) const
+	{
+		if (index >= _size) throw std::out_of_range("Index is out of bounds");
+		return (*this)[index];
+	}
+
+	T& front() { return _chunks.front().front(); }
+	const T& front() const { return _chunks.front().front(); }
+	T& back() { return _chunks.back().back(); }
+	const T& back() const { return _chunks.back().back(); }
+
+	iterator begin() { return iterator(this, 0, 0, 0); }
+	iterator end() { return endIterator<false>(this); }
+	const_iterator begin() const { return const_iterator(this, 0, 0, 0); }
+	const_iterator end() const { return endIterator<true>(this); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+	void push_back(const T& value) { emplace_back(value); }
+	void push_back(T&& value) { emplace_back(std::move(value)); }
+
+	template <typename... Args>
+	T& emplace_back(Args&&... args)
+	{
+		if (_chunks.empty() || _chunks.back().size() == ChunkSize)
+		{
+			_chunks.emplace_back();
+			_chunks.back().reserve(ChunkSize);
+			_fenwick.push_back(0);
+			// The new Fenwick node covers the sizes of the chunks in (i - lowbit(i), i]
+			const size_t i = _chunks.size();
+			const size_t low = i - (i & (~i + 1));
+			size_t covered = 0;
+			for (size_t c = low; c + 1 < i; ++c)
+			{
+				covered += _chunks[c].size();
+			}
+			_fenwick.back() = covered;
+		}
+		_chunks.back().emplace_back(std::forward<Args>(args)...);
+		fenwickAdd(_chunks.size() - 1, 1);
+		++_size;
+		return _chunks.back().back();
+	}
+
+	iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+	iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+	template <typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args)
+	{
+		const size_t index = pos._index;
+		if (index == _size)
+		{
+			emplace_back(std::forward<Args>(args)...);
+			return iterator(this, index);
+		}
+
+		size_t chunk, offset;
+		locate(index, chunk, offset);
+		if (_chunks[chunk].size() == ChunkSize)
+		{
+			splitChunk(chunk);
+			if (offset >= _chunks[chunk].size())
+			{
+				offset -= _chunks[chunk].size();
+				++chunk;
+			}
+		}
+		_chunks[chunk].emplace(_chunks[chunk].begin() + offset, std::forward<Args>(args)...);
+		fenwickAdd(chunk, 1);
+		++_size;
+		return iterator(this, index, chunk, offset);
+	}
+
+	// Range insert: the chunk at pos is split once and the new elements are packed into fresh chunks
+	template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+	iterator insert(const_iterator pos, InputIt first, InputIt last)
+	{
+		const size_t index = pos._index;
+		std::vector<T> items(first, last);
+		if (items.empty())
+		{
+			return iterator(this, index);
+		}
+
+		std::vector<std::vector<T>> chunks;
+		chunks.reserve(_chunks.size() + items.size() / ChunkSize + 2);
+		size_t chunk = _chunks.size();
+		size_t offset = 0;
+		if (index < _size)
+		{
+			locate(index, chunk, offset);
+		}
+		for (size_t c = 0; c < chunk; ++c)
+		{
+			chunks.emplace_back(std::move(_chunks[c]));
+		}
+		std::vector<T> tail;
+		if (chunk < _chunks.size())
+		{
+			tail.assign(std::make_move_iterator(_chunks[chunk].begin() + offset), std::make_move_iterator(_chunks[chunk].end()));
+			_chunks[chunk].erase(_chunks[chunk].begin() + offset, _chunks[chunk].end());
+			if (!_chunks[chunk].empty())
+			{
+				chunks.emplace_back(std::move(_chunks[chunk]));
+			}
+		}
+		appendPacked(chunks, items);
+		if (!tail.empty())
+		{
+			appendPacked(chunks, tail);
+		}
+		for (size_t c = chunk + 1; c < _chunks.size(); ++c)
+		{
+			chunks.emplace_back(std::move(_chunks[c]));
+		}
+		_chunks = std::move(chunks);
+		_size += items.size();
+		rebuildFenwick();
+		return iterator(this, index);
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		const size_t index = pos._index;
+		size_t chunk, offset;
+		locate(index, chunk, offset);
+		_chunks[chunk].erase(_chunks[chunk].begin() + offset);
+		--_size;
+
+		if (_chunks[chunk].empty())
+		{
+			_chunks.erase(_chunks.begin() + chunk);
+			rebuildFenwick();
+		}
+		else if (_chunks[chunk].size() < ChunkSize / 4 && chunk + 1 < _chunks.size() &&
+			_chunks[chunk].size() + _chunks[chunk + 1].size() <= ChunkSize)
+		{
+			// Keep chunks reasonably full so locate and iteration stay fast
+			auto& next = _chunks[chunk + 1];
+			_chunks[chunk].insert(_chunks[chunk].end(), std::make_move_iterator(next.begin()), std::make_move_iterator(next.end()));
+			_chunks.erase(_chunks.begin() + chunk + 1);
+			rebuildFenwick();
+		}
+		else
+		{
+			fenwickAdd(chunk, -1);
+		}
+		return index < _size ? iterator(this, index) : end();
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		const size_t from = first._index;
+		const size_t to = last._index;
+		if (from >= to)
+		{
+			return iterator(this, from);
+		}
+		if (to - from == 1)
+		{
+			return erase(first);
+		}
+
+		size_t first_chunk, first_offset, last_chunk, last_offset;
+		locate(from, first_chunk, first_offset);
+		if (to < _size)
+		{
+			locate(to, last_chunk, last_offset);
+		}
+		else
+		{
+			last_chunk = _chunks.size() - 1;
+			last_offset = _chunks.back().size();
+		}
+
+		if (first_chunk == last_chunk)
+		{
+			_chunks[first_chunk].erase(_chunks[first_chunk].begin() + first_offset, _chunks[first_chunk].begin() + last_offset);
+		}
+		else
+		{
+			_chunks[first_chunk].erase(_chunks[first_chunk].begin() + first_offset, _chunks[first_chunk].end());
+			_chunks[last_chunk].erase(_chunks[last_chunk].begin(), _chunks[last_chunk].begin() + last_offset);
+			_chunks.erase(_chunks.begin() + first_chunk + 1, _chunks.begin() + last_chunk);
+		}
+		_chunks.erase(std::remove_if(_chunks.begin(), _chunks.end(), [](const std::vector<T>& c) { return c.empty(); }), _chunks.end());
+		_size -= to - from;
+		rebuildFenwick();
+		return from < _size ? iterator(this, from) : end();
+	}
+
+private:
+	template <bool Const, typename Owner>
+	static Iterator<Const> endIterator(Owner* owner)
+	{
+		if (owner->_chunks.empty())
+		{
+			return Iterator<Const>(owner, 0, 0, 0);
+		}
+		return Iterator<Const>(owner, owner->_size, owner->_chunks.size() - 1, owner->_chunks.back().size());
+	}
+
+	// Finds the chunk and offset of index, index == size() maps past the last element
+	void locate(size_t index, size_t& chunk, size_t& offset) const
+	{
+		if (index >= _size)
+		{
+			chunk = _chunks.empty() ? 0 : _chunks.size() - 1;
+			offset = _chunks.empty() ? 0 : _chunks.back().size() + (index - _size);
+			return;
+		}
+		// Fenwick descent for the last chunk whose prefix sum is <= index
+		size_t position = 0;
+		size_t remaining = index;
+		size_t step = 1;
+		while (step * 2 <= _fenwick.size())
+		{
+			step *= 2;
+		}
+		for (; step > 0; step /= 2)
+		{
+			if (position + step <= _fenwick.size() && _fenwick[position + step - 1] <= remaining)
+			{
+				position += step;
+				remaining -= _fenwick[position - 1];
+			}
+		}
+		chunk = position;
+		offset = remaining;
+	}
+
+	void fenwickAdd(size_t chunk, std::ptrdiff_t delta)
+	{
+		for (size_t i = chunk + 1; i <= _fenwick.size(); i += i & (~i + 1))
+		{
+			_fenwick[i - 1] += delta;
+		}
+	}
+
+	void rebuildFenwick()
+	{
+		_fenwick.assign(_chunks.size(), 0);
+		for (size_t i = 1; i <= _chunks.size(); ++i)
+		{
+			_fenwick[i - 1] += _chunks[i - 1].size();
+			const size_t parent = i + (i & (~i + 1));
+			if (parent <= _chunks.size())
+			{
+				_fenwick[parent - 1] += _fenwick[i - 1];
+			}
+		}
+	}
+
+	void splitChunk(size_t chunk)
+	{
+		std::vector<T> upper;
+		upper.reserve(ChunkSize);
+		auto& lower = _chunks[chunk];
+		const size_t half = lower.size() / 2;
+		upper.assign(std::make_move_iterator(lower.begin() + half), std::make_move_iterator(lower.end()));
+		lower.erase(lower.begin() + half, lower.end());
+		_chunks.insert(_chunks.begin() + chunk + 1, std::move(upper));
+		rebuildFenwick();
+	}
+
+	// Appends items as chunks filled to three quarters, leaving room for later inserts
+	static void appendPacked(std::vector<std::vector<T>>& chunks, std::vector<T>& items)
+	{
+		const size_t fill = std::max<size_t>(1, ChunkSize * 3 / 4);
+		for (size_t i = 0; i < items.size(); i += fill)
+		{
+			const size_t n = std::min(fill, items.size() - i);
+			chunks.emplace_back();
+			chunks.back().reserve(ChunkSize);
+			chunks.back().insert(chunks.back().end(), std::make_move_iterator(items.begin() + i), std::make_move_iterator(items.begin() + i + n));
+		}
+	}
+
+	std::vector<std::vector<T>> _chunks;
+	std::vector<size_t> _fenwick; // 1-based Fenwick tree stored at index - 1
+	size_t _size = 0;
+};
+
+#endif // CHUNKEDVECTOR_H
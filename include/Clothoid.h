@@ -0,0 +1,65 @@
+#pragma once
+#ifndef CLOTHOID_H
+#define CLOTHOID_H
+
+#include <Config.h>
+#include <Segment.h>
+#include <string>
+#include <vector>
+
+class Clothoid : public Segment { /*!< Clothoid (Euler spiral) is a Segment whose curvature changes linearly with arc length,
+    from curvature at the start by sharpness per unit length. Positions are evaluated from Fresnel integrals. */
+public:
+    Clothoid(const Point2& start, double heading, double curvature, double sharpness, double length, double flatness = 1E-3);
+
+    // G1 Hermite fit: the clothoid from p0 with heading theta0 that ends in p1 with heading theta1
+    static Clothoid fitG1(const Point2& p0, double theta0, const Point2& p1, double theta1, double flatness = 1E-3);
+
+    Point2 getCoordinate(double t) const override;
+    bool operator==(const Segment& other) const override;
+    void print(const std::string& padding) const override;
+    std::vector<Point2> getLineStrip() const override;
+    BoundingBox getBounds() const override;
+    double getClosestParameter(const Point2& point) const override;
+
+    std::vector<Point2> getLineStrip(double tolerance) const;
+    // getCoordinate for every t, checked once up front so an out of range t throws before any point is evaluated.
+    // A convenience wrapper: each point still costs one Fresnel evaluation, the completed square is set up once by
+    // the constructor for getCoordinate as well.
+    std::vector<Point2> getCoordinates(const std::vector<double>& ts) const;
+
+    // Heading and curvature at t<-[0,1]
+    double getHeading(double t) const;
+    double getCurvature(double t) const;
+
+    Point2 getStart() const { return _start; }
+    double getLength() const { return _length; }
+    double getSharpness() const { return _sharpness; }
+    double getFlatness() const { return _flatness; }
+
+private:
+    Point2 position(double s) const;
+
+    Point2 _start;
+    double _heading;
+    double _curvature;
+    double _sharpness;
+    double _length;
+    double _flatness;
+
+    // Completed square of the heading, used when the spiral turns enough for Fresnel integrals to be accurate
+    bool _use_fresnel = false;
+    double _scale = 0.0;       // sqrt(|sharpness| / PI)
+    double _cos_phase = 1.0;   // of heading - curvature^2 / (2 sharpness)
+    double _sin_phase = 0.0;
+    double _sign = 1.0;
+    double _z0 = 0.0;
+    double _c0 = 0.0;
+    double _s0 = 0.0;
+};
+
+// Fresnel integrals C(x) = int_0^x cos(PI/2 t^2) dt and S(x) = int_0^x sin(PI/2 t^2) dt,
+// power series for small |x| and a continued fraction otherwise
+void fresnelIntegrals(double x, double& c, double& s);
+
+#endif
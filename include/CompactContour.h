@@ -0,0 +1,75 @@
+#pragma once
+#ifndef COMPACTCONTOUR_H
+#define COMPACTCONTOUR_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Contour.h"
+
+struct CompactOptions { /*!< Storage mode of a CompactContour */
+	// Stores Line2 end points, Arc centers and curve control points as 32 bit multiples of quantum relative to the
+	// center of the contour. Lossy: points move by up to quantum / 2 per coordinate, radii and angles stay exact.
+	// Joints within EPS stay closed where a Line2 or CubicBezier follows or a Line2 leads in, since that end is taken
+	// from the decoded neighbour. A joint between two Arcs, B-splines or clothoids, or from a CubicBezier into one of
+	// them, can open by up to about quantum, and a contour made of those alone is generally not valid after decoding.
+	bool quantize = false;
+	double quantum = 1E-6;
+};
+
+class CompactContour { /*!< Read only copy of a chain of elements in packed, tagged records.
+	A ContourElement is as large as its largest alternative and every Segment carries a vtable pointer and the cached
+	end points, so a two point Line2 takes as much memory as a Clothoid. Here a record holds a tag byte and only the
+	values that define its element: a Line2 or CubicBezier that starts where the previous element ends does not store
+	its start, nor does a Line2 its end where an Arc, B-spline or clothoid starts.
+	Elements are decoded on access, which costs a Segment constructor. Without quantization decoding is exact. */
+public:
+	CompactContour() = default;
+	explicit CompactContour(const std::vector<ContourElement>& elements, const CompactOptions& options = CompactOptions());
+	explicit CompactContour(const Contour& contour, const CompactOptions& options = CompactOptions());
+
+	size_t size() const { return _offsets.size(); }
+	bool empty() const { return _offsets.empty(); }
+	// Throws std::out_of_range
+	ContourElement at(size_t index) const;
+	std::vector<ContourElement> elements() const;
+	Contour toContour() const;
+
+	bool isQuantized() const { return _quantum > 0; }
+	double quantum() const { return _quantum; }
+	const Point2& origin() const { return _origin; }
+	// Bytes of the records and the offset table
+	size_t memoryUsage() const;
+
+private:
+	class Reader;
+
+	// previous_end is the end of the decoded element at index - 1, looked up if null
+	ContourElement decode(size_t index, const Point2* previous_end = nullptr) const;
+	Point2 endOf(size_t index) const;
+	Point2 startOf(size_t index) const;
+	size_t nextOf(size_t index) const;
+
+	std::vector<uint8_t> _records;
+	std::vector<uint32_t> _offsets; // start of the record of every element
+	Point2 _origin{ 0.0, 0.0 };
+	double _quantum = 0.0;          // 0 for full precision
+};
+
+struct ContourMemoryReport { /*!< Bytes taken by the same elements in each storage mode */
+	size_t elements = 0;
+	size_t element_bytes = 0;   // std::vector<ContourElement>, heap blocks of BSplines included
+	size_t compact_bytes = 0;   // CompactContour
+	size_t quantized_bytes = 0; // quantized CompactContour, 0 if the coordinates do not fit the grid
+
+	// One line per mode with bytes per element, preceded by the sizeof of every element type
+	std::string toString() const;
+};
+
+ContourMemoryReport memoryReport(const std::vector<ContourElement>& elements, double quantum = 1E-6);
+
+#endif // COMPACTCONTOUR_H
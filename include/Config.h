@@ -11,6 +11,20 @@
 #include "Vector2.h"
 #include "Segment.h"
 #include "Arc.h"
+#include "CubicBezier.h"
+#include "BSpline.h"
+#include "Clothoid.h"
+
+// Hot path counters and timers in Contour, see ContourStats.h. Enabled through the CMake option of the same name.
+#ifndef CONTOUR_INSTRUMENTATION
+#define CONTOUR_INSTRUMENTATION 0
+#endif
+
+// Store Contour elements in a ChunkedVector instead of a std::vector, for contours edited in the middle.
+// Enabled through the CMake option of the same name.
+#ifndef CONTOUR_CHUNKED_STORAGE
+#define CONTOUR_CHUNKED_STORAGE 0
+#endif
 
 #define PI  3.14159265358979323846
 inline double EPS = 1E-14; // should be large enough for double precision
@@ -6,6 +6,8 @@
 
 #include <Arc.h>
 #include <Line2.h>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <variant>
 #include <string>
@@ -14,14 +16,75 @@
 
 #include "Line2.h"
 #include "Arc.h"
+#include "CubicBezier.h"
+#include "BSpline.h"
+#include "Clothoid.h"
+#include "ChunkedVector.h"
 
-using ContourElement = std::variant<Line2, Arc>;
+using ContourElement = std::variant<Line2, Arc, CubicBezier, BSpline, Clothoid>;
 /* For easy extension of the library, we use a variant, introduced in c++17.
  * Just add your class that "extends Segment" and implement the methods and overrides
  * and you should be good to go.
  */
 
-class Contour {  /*!< A Contour is either a Line2 or an Arc. The class has several public methods for comparison, moving copying and debugging (svg) */
+// Every element type derives from Segment, for the members that need no dispatch on the type
+inline const Segment& asSegment(const ContourElement& element)
+{
+	return std::visit([](const auto& seg) -> const Segment& { return seg; }, element);
+}
+
+#if CONTOUR_CHUNKED_STORAGE
+using ContourStorage = ChunkedVector<ContourElement>;
+#else
+using ContourStorage = std::vector<ContourElement>;
+#endif
+
+struct TessellationSettings { /*!< Key of a cached tessellation, the defaults reproduce getLineStrip() of every element */
+	unsigned int arc_resolution = 0; // points per Arc instead of Arc::resolution, 0 keeps the Arc's own
+	double tolerance = 0.0;          // maximum chord error for Arcs and curves, overrides arc_resolution, 0 keeps the defaults
+
+	bool operator==(const TessellationSettings& other) const
+	{
+		return arc_resolution == other.arc_resolution && tolerance == other.tolerance;
+	}
+};
+
+struct ContourTessellation { /*!< Line strips of all elements end to end, element i owns points [offsets[i], offsets[i + 1]) */
+	std::vector<Point2> points;
+	std::vector<size_t> offsets;
+};
+
+class ContourEdit { /*!< Batch of inserts, erases and replaces, applied to a Contour under a single lock by Contour::apply.
+	Operations run in the order they were added, every index refers to the contour as left by the previous operation. */
+public:
+	ContourEdit& insert(size_t index, ContourElement item);
+	ContourEdit& insert(size_t index, std::vector<ContourElement> items);
+	ContourEdit& append(ContourElement item);
+	ContourEdit& append(std::vector<ContourElement> items);
+	ContourEdit& replace(size_t index, ContourElement item);
+	ContourEdit& erase(size_t index);
+	ContourEdit& erase(size_t first, size_t last); // [first, last)
+	ContourEdit& clear();
+
+	size_t size() const { return _operations.size(); }
+	bool empty() const { return _operations.empty(); }
+
+private:
+	friend class Contour;
+
+	enum class Kind { Insert, Append, Replace, Erase, Clear };
+	struct Operation {
+		Kind kind;
+		size_t first;
+		size_t last;
+		std::vector<ContourElement> items;
+	};
+	std::vector<Operation> _operations;
+};
+
+class ContourPointView;
+
+class Contour {  /*!< A Contour is a chain of Line2, Arc, CubicBezier, BSpline and Clothoid elements. The class has several public methods for comparison, moving copying and debugging (svg) */
 public:
 	Contour() = default;
 	Contour(const Contour& other);
@@ -34,31 +97,73 @@ public:
 	void addItemAt(ContourElement&& item, unsigned int index);
 	void addItemToCenter(const ContourElement& item);
 	bool isValid() const;
+	bool isClosed() const;
 	std::vector<ContourElement> getElements() const;
+	// Incremented by every mutation, lets derived data (caches, LOD pyramids) detect that they are stale
+	uint64_t revision() const;
 	std::vector<Point2> getLineStrip() const;
+	// Cached line strips, shared until the contour changes. A mutation only re-tessellates the elements it touched,
+	// strips handed out earlier stay valid. The last few settings asked for are kept.
+	std::shared_ptr<const ContourTessellation> tessellate(const TessellationSettings& settings = {}) const;
 
 	void clear();
 	void clearAtIndex(int index);
 
+	// Range versions of the mutators above, each takes the lock once
+	void addItems(const std::vector<ContourElement>& items);
+	void insertItems(size_t index, const std::vector<ContourElement>& items);
+	void eraseRange(size_t first, size_t last);
+
+	// Applies all operations under one exclusive lock and revalidates once, returns isValid().
+	// Indices are checked before anything is modified, an out of range edit throws and leaves the contour unchanged.
+	bool apply(const ContourEdit& edit);
+
 	void exportContourToSVG(const std::string& filename) const;
 	void print(const std::string& padding) const;
 
 private:
+	friend class ContourPointView;
+
 	bool computeValidity() const;
+	// Elements [first, first + erased) were replaced by inserted new ones, marks them stale in every cached tessellation
+	void spliceTessellations(size_t first, size_t erased, size_t inserted);
+
+	struct TessellationCache {
+		TessellationSettings settings;
+		std::shared_ptr<const ContourTessellation> strip; // last one built
+		bool dirty = false;
+		size_t dirty_first = 0; // elements [dirty_first, dirty_last) changed since, the rest only moved
+		size_t dirty_last = 0;
+	};
 
 	mutable std::shared_mutex _mutex;
-	std::vector<ContourElement> _elements;
+	ContourStorage _elements;
 	mutable bool is_valid_dirty_ = true;
 	mutable bool is_valid_cache_ = false;
+	mutable std::vector<TessellationCache> _tessellations;
+	uint64_t _revision = 0;
 };
 
 // Utility functions
 
+// Points of one element as tessellate() produces them, and the number of chords it splits an Arc into
+void appendLineStrip(const ContourElement& element, const TessellationSettings& settings, std::vector<Point2>& out);
+size_t arcStripSegments(const Arc& arc, const TessellationSettings& settings);
+
 void printPoints(const std::vector<Point2>& v);
 
 // Create a contour consisting only of Line2s from a list of points
 Contour contourFromPoints(const std::vector<Point2>& pts);
 
+// The same geometry traversed from end to start
+ContourElement reverseElement(const ContourElement& element);
+
+// Direction of travel of an element at t<-[0,1] as an angle, for building tangent continuous joints
+double elementHeading(const ContourElement& element, double t);
+
+// G1 clothoid from the end of one element to the start of another, matching positions and headings
+Clothoid connectWithClothoid(const ContourElement& from, const ContourElement& to, double flatness = 1E-3);
+
 // Brute force uniqueness check
 bool vectorContoursUniqueness(const std::vector<Contour>& contours);
 
@@ -0,0 +1,18 @@
+#pragma once
+#ifndef CONTOURASSEMBLY_H
+#define CONTOURASSEMBLY_H
+
+#include <Config.h>
+
+#include <vector>
+
+#include "Contour.h"
+
+/* Chains an unordered set of elements into ordered contours. Elements whose end points lie within tolerance of each
+ * other are joined, reversed with reverseElement where needed. End points are matched through a spatial hash with cells
+ * of twice the tolerance, so assembly runs in expected linear time. Chains start at end points with an odd number of
+ * neighbours, which gives the minimum number of contours when no more than two elements meet in a point.
+ * Joints are kept as found, so with a tolerance above EPS run repairContour to make them meet exactly. */
+std::vector<Contour> assembleContours(const std::vector<ContourElement>& elements, double tolerance = 1E-9);
+
+#endif // CONTOURASSEMBLY_H
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef CONTOURDISTANCE_H
+#define CONTOURDISTANCE_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "BoundingBox.h"
+#include "Contour.h"
+
+struct ClosestPoint { /*!< Result of a closest point query. t is local to the element at element_index, see Segment::getCoordinate */
+	Point2 point{ 0.0, 0.0 };
+	double distance = std::numeric_limits<double>::infinity();
+	double signed_distance = std::numeric_limits<double>::infinity(); // negative inside a closed contour, equal to distance otherwise
+	size_t element_index = 0;
+	double t = 0.0;
+	bool inside = false;
+};
+
+struct DistanceFieldGrid { /*!< Regular sample grid, sample (i, j) is at origin + (i, j) * spacing */
+	Point2 origin{ 0.0, 0.0 };
+	double spacing = 1.0;
+	size_t width = 0;
+	size_t height = 0;
+};
+
+class ContourDistanceIndex { /*!< Bounding box hierarchy over a snapshot of the elements of a Contour.
+	Consecutive elements of a contour are spatially coherent, so the hierarchy is built over index ranges in O(n).
+	Queries are read only and may be issued from several threads at once. */
+public:
+	explicit ContourDistanceIndex(const Contour& contour);
+
+	bool isClosed() const { return _closed; }
+	size_t size() const { return _elements.size(); }
+
+	// Closest point on the contour. hint is an element index expected to be near point, it only tightens pruning.
+	ClosestPoint closestPoint(const Point2& point, size_t hint = 0) const;
+
+	// Even-odd containment, only meaningful for closed contours
+	bool contains(const Point2& point) const;
+
+	// One result per query point, computed on num_threads threads (0 picks the hardware concurrency)
+	std::vector<ClosestPoint> closestPoints(const std::vector<Point2>& points, unsigned int num_threads = 0) const;
+
+	// Row major width * height signed distances (unsigned if the contour is open)
+	std::vector<double> signedDistanceField(const DistanceFieldGrid& grid, unsigned int num_threads = 0) const;
+
+private:
+	struct Node {
+		BoundingBox bounds;
+		size_t first;
+		size_t last; // exclusive
+		int left = -1;
+		int right = -1;
+	};
+
+	int build(size_t first, size_t last);
+	void updateClosest(size_t index, const Point2& point, ClosestPoint& best) const;
+	bool crossesRay(size_t index, const Point2& point) const;
+
+	std::vector<ContourElement> _elements;
+	std::vector<BoundingBox> _element_bounds;
+	std::vector<Node> _nodes;
+	bool _closed = false;
+};
+
+// Closest point by a linear scan, use ContourDistanceIndex for repeated queries
+ClosestPoint closestPoint(const Contour& contour, const Point2& point);
+
+#endif // CONTOURDISTANCE_H
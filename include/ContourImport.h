@@ -0,0 +1,45 @@
+#pragma once
+#ifndef CONTOURIMPORT_H
+#define CONTOURIMPORT_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Contour.h"
+
+struct ImportOptions { /*!< Settings for the DXF and SVG importers */
+	unsigned int num_threads = 0;      // threads parsing the entities of a chunk, 0 picks the hardware concurrency
+	size_t chunk_size = size_t(1) << 24; // bytes of input parsed at a time, the chunk is widened to whole entities
+	double snap_tolerance = 1E-9;      // joints closer than this are made to meet exactly, wider gaps start a new contour
+	unsigned int arc_resolution = 20;  // resolution of the Arcs created
+	unsigned int ellipse_segments = 32; // Line2s per full turn of an elliptical SVG arc, circular arcs stay Arcs
+};
+
+// Receives the contours of a file in file order
+using ContourConsumer = std::function<void(Contour&&)>;
+
+/* DXF: LINE, ARC, CIRCLE and LWPOLYLINE entities of the ENTITIES section (the whole input if it has no sections).
+ * An LWPOLYLINE becomes one contour, closed if flagged, with bulges turned into Arcs. Consecutive LINE and ARC entities
+ * are chained into one contour while each starts where the previous one ended, unordered soups can be chained with
+ * assembleContours afterwards. Other entities are skipped. Numbers are parsed with std::from_chars, malformed input
+ * throws std::invalid_argument.
+ * The file is memory mapped and parsed chunk_size bytes at a time, the entities of a chunk in parallel, so memory use
+ * is bounded by the chunk and the contours are handed to consumer as they are completed. */
+size_t importDXF(const std::string& filename, const ContourConsumer& consumer, const ImportOptions& options = {});
+std::vector<Contour> importDXF(const std::string& filename, const ImportOptions& options = {});
+std::vector<Contour> parseDXF(std::string_view text, const ImportOptions& options = {});
+
+/* SVG: the d attribute of every <path> element, commands M, L, H, V, C, A and Z in absolute and relative form.
+ * Every subpath becomes a contour. Circular arcs become Arcs and elliptical ones Line2s, coordinates are taken as
+ * written, transforms are ignored. Paths are parsed in parallel, chunk by chunk like importDXF. */
+size_t importSVG(const std::string& filename, const ContourConsumer& consumer, const ImportOptions& options = {});
+std::vector<Contour> importSVG(const std::string& filename, const ImportOptions& options = {});
+// Contours of one path data string
+std::vector<Contour> parseSVGPath(std::string_view path_data, const ImportOptions& options = {});
+
+#endif // CONTOURIMPORT_H
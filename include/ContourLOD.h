@@ -0,0 +1,77 @@
+#pragma once
+#ifndef CONTOURLOD_H
+#define CONTOURLOD_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Contour.h"
+
+struct LODLevel { /*!< One level of a ContourLOD pyramid: point strips that stay within max_error of the contour */
+	std::vector<Point2> points;
+	std::vector<size_t> run_offsets; // start of every connected run in points, a gap in the contour starts a new run
+	double max_error = 0.0;          // world units
+};
+
+class ContourLOD { /*!< Level of detail pyramid of a Contour for zoom dependent drawing.
+	Level 0 is the tessellation of the contour, every further level simplifies the previous one with twice the
+	tolerance, so the error bound roughly doubles per level and select() can compute the level index directly.
+	The pyramid is built on a background thread from a snapshot the thread takes itself. update() starts a rebuild
+	when the contour's revision changed, and a rebuild that finishes behind the contour starts the next one, so
+	neither update() nor select() ever waits for a build. The contour must outlive the pyramid. */
+public:
+	// base_tolerance 0 derives it from the size of the contour
+	explicit ContourLOD(const Contour& contour, double base_tolerance = 0.0, size_t max_levels = 24);
+	~ContourLOD();
+
+	ContourLOD(const ContourLOD&) = delete;
+	ContourLOD& operator=(const ContourLOD&) = delete;
+
+	// Starts a background rebuild if the pyramid is missing or older than the contour and none is running,
+	// returns true if one was started
+	bool update();
+	// Blocks until a running rebuild is done, including the rebuilds it chains for later revisions
+	void wait();
+
+	bool isReady() const;
+	bool isStale() const;
+	size_t levelCount() const;
+	std::shared_ptr<const LODLevel> level(size_t index) const;
+
+	// Coarsest level whose error is within pixel_tolerance at pixels_per_unit, in O(1). Only reads the current
+	// pyramid: returns the most recent one while a rebuild runs, nullptr before the first build has finished.
+	// Call update() after editing the contour, select() does not start rebuilds.
+	std::shared_ptr<const LODLevel> select(double pixels_per_unit, double pixel_tolerance = 0.5) const;
+
+private:
+	struct Pyramid {
+		std::vector<LODLevel> levels;
+		uint64_t revision = 0;
+		double base_tolerance = 0.0;
+	};
+
+	static std::shared_ptr<const Pyramid> build(std::vector<ContourElement> elements, uint64_t revision,
+		double base_tolerance, size_t max_levels);
+	void rebuild();
+
+	const Contour& _contour;
+	double _base_tolerance;
+	size_t _max_levels;
+
+	mutable std::mutex _mutex;
+	std::shared_ptr<const Pyramid> _pyramid;
+	std::future<void> _pending;
+	bool _building = false;
+	bool _stopping = false; // set by the destructor, a finishing rebuild does not chain another
+};
+
+// Douglas-Peucker simplification of an open polyline, the result keeps both end points
+std::vector<Point2> simplifyPolyline(const std::vector<Point2>& points, double tolerance);
+
+#endif // CONTOURLOD_H
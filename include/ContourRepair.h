@@ -0,0 +1,35 @@
+#pragma once
+#ifndef CONTOURREPAIR_H
+#define CONTOURREPAIR_H
+
+#include <Config.h>
+
+#include <cstddef>
+
+#include "Contour.h"
+
+struct RepairOptions { /*!< Tolerances of repairContour, in world units */
+	double snap_tolerance = 1E-6;       // joints closer than this are made to meet
+	double collinear_tolerance = 1E-9;  // merged Line2s stay within this distance of the original joints
+	double arc_tolerance = 1E-9;        // arcs whose centers and radii agree within this are merged
+	double degenerate_length = 0.0;     // shorter elements are dropped, 0 uses snap_tolerance
+	bool close = true;                  // snap the last element to the first when they nearly meet
+};
+
+struct RepairReport { /*!< What repairContour changed */
+	size_t input_elements = 0;
+	size_t output_elements = 0;
+	size_t dropped_degenerate = 0;
+	size_t snapped_joints = 0;
+	size_t bridged_joints = 0;  // both neighbours rigid (Arc, Clothoid), a short Line2 closes the gap
+	size_t merged_lines = 0;    // Line2s removed by merging collinear runs
+	size_t merged_arcs = 0;     // Arcs removed by merging co-circular neighbours
+	size_t open_gaps = 0;       // joints further apart than snap_tolerance, the result is not valid if any remain
+};
+
+/* Normalizes a contour in a few linear passes: drops degenerate elements, merges consecutive arcs on the same circle,
+ * snaps near-miss joints by moving the flexible side (Line2 ends, Bezier and B-spline end control points),
+ * and merges runs of collinear Line2s with a SimplifyingSink. */
+Contour repairContour(const Contour& contour, const RepairOptions& options = RepairOptions(), RepairReport* report = nullptr);
+
+#endif // CONTOURREPAIR_H
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef CONTOURSAMPLER_H
+#define CONTOURSAMPLER_H
+
+#include <Config.h>
+
+#include <functional>
+#include <vector>
+
+#include "Contour.h"
+#include "ContourSink.h"
+#include "Point2.h"
+
+/* Adaptive sampling of parametric curves and ODE trajectories into Line2 / Arc contours.
+ * Samples are placed by chord error: a span is refined while the curve strays more than half the tolerance from the
+ * chord between its ends, so straight stretches take few samples and tight turns many. ODEs are integrated with the
+ * embedded Dormand-Prince 5(4) pair, whose step is limited by both its local error estimate and the chord error of
+ * the step. The samples are then fitted greedily with the longest Line2 or Arc that stays within the other half. */
+
+struct SamplerOptions { /*!< Tolerances and limits of the adaptive sampler */
+	double tolerance = 1E-3;             // maximum distance between the curve and the emitted elements
+	double integration_tolerance = 1E-9; // absolute and relative local error allowed per RK45 step
+	double min_step = 1E-12;             // spans of parameter or time below this are not refined further
+	size_t initial_spans = 16;           // parametric curves are split this often before refining, ODEs start at this step
+	bool fit_arcs = true;                // false emits Line2s only
+	unsigned int arc_resolution = 20;    // resolution of the emitted Arcs
+	unsigned int num_threads = 0;        // threads for sampleOdes, 0 uses the hardware concurrency
+};
+
+using ParametricCurve = std::function<Point2(double)>;
+using OdeState = std::vector<double>;
+// Writes dy/dt at (t, y) into dydt, which has the size of y
+using OdeFunction = std::function<void(double t, const OdeState& y, OdeState& dydt)>;
+// Point drawn for a state, the default takes the first two components
+using StateProjection = std::function<Point2(const OdeState& y)>;
+
+// Samples of curve on [t0, t1], within tolerance / 2 of the curve. Throws std::invalid_argument unless t0 < t1
+std::vector<Point2> sampleCurvePoints(const ParametricCurve& curve, double t0, double t1, const SamplerOptions& options = {});
+
+// Projected states of the trajectory from y0 at t0 to t1, one per accepted step.
+// Throws std::invalid_argument unless t0 < t1 and y0 has at least two components for the default projection,
+// std::runtime_error if the step would have to shrink below min_step
+std::vector<Point2> sampleOdePoints(const OdeFunction& f, const OdeState& y0, double t0, double t1,
+	const SamplerOptions& options = {}, const StateProjection& projection = {});
+
+// Pushes Line2s and Arcs within tolerance / 2 of the polyline through points, each as long as the greedy fit can make it.
+// Consecutive points closer than EPS are merged; the sink is not finished.
+void fitElements(const std::vector<Point2>& points, const SamplerOptions& options, ContourSink& out);
+
+// Samples, fits and pushes into out, then finishes out
+void sampleCurve(const ParametricCurve& curve, double t0, double t1, ContourSink& out, const SamplerOptions& options = {});
+Contour sampleCurve(const ParametricCurve& curve, double t0, double t1, const SamplerOptions& options = {});
+
+void sampleOde(const OdeFunction& f, const OdeState& y0, double t0, double t1, ContourSink& out,
+	const SamplerOptions& options = {}, const StateProjection& projection = {});
+Contour sampleOde(const OdeFunction& f, const OdeState& y0, double t0, double t1, const SamplerOptions& options = {},
+	const StateProjection& projection = {});
+
+// One contour per initial state, trajectories are integrated on num_threads threads so f must be thread safe
+std::vector<Contour> sampleOdes(const OdeFunction& f, const std::vector<OdeState>& initial_states, double t0, double t1,
+	const SamplerOptions& options = {}, const StateProjection& projection = {});
+
+#endif // CONTOURSAMPLER_H
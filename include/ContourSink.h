@@ -0,0 +1,168 @@
+#pragma once
+#ifndef CONTOURSINK_H
+#define CONTOURSINK_H
+
+#include <Config.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Contour.h"
+#include "DirectionCone.h"
+
+/* Streaming alternative to building a whole Contour before processing it.
+ * Producers push elements into a sink, sinks forward to the next sink and finish() flushes the chain.
+ * Every stage keeps a bounded amount of state, so memory does not grow with the length of the stream.
+ * Sinks hold references to the next stage, which must outlive them.
+ */
+
+class ContourSink { /*!< Receiver of a stream of contour elements */
+public:
+	virtual ~ContourSink() = default;
+	virtual void push(const ContourElement& element) = 0;
+	// End of stream, implementations flush and call finish() on the next stage
+	virtual void finish() {}
+};
+
+class PointSink { /*!< Turns a stream of points into Line2s, consecutive duplicate points are skipped */
+public:
+	explicit PointSink(ContourSink& next);
+
+	void push(const Point2& point);
+	void finish();
+
+private:
+	ContourSink& _next;
+	Point2 _last{ 0.0, 0.0 };
+	bool _has_last = false;
+};
+
+class ContourCollectorSink : public ContourSink { /*!< Appends the stream to a Contour */
+public:
+	explicit ContourCollectorSink(Contour& contour);
+	void push(const ContourElement& element) override;
+
+private:
+	Contour& _contour;
+};
+
+class ValidatingSink : public ContourSink { /*!< Checks that every element starts where the previous one ended */
+public:
+	ValidatingSink(ContourSink& next, double tolerance = EPS, bool throw_on_gap = false);
+
+	void push(const ContourElement& element) override;
+	void finish() override;
+
+	size_t elementCount() const { return _count; }
+	size_t gapCount() const { return _gaps; }
+	bool isValid() const { return _gaps == 0; }
+
+private:
+	ContourSink& _next;
+	double _tolerance;
+	bool _throw_on_gap;
+	Point2 _last_end{ 0.0, 0.0 };
+	size_t _count = 0;
+	size_t _gaps = 0;
+};
+
+class SimplifyingSink : public ContourSink { /*!< Merges runs of connected Line2s that stay within tolerance of a single line.
+	Uses a shrinking cone of admissible directions from the run's anchor, so the state is constant size. Arcs pass through. */
+public:
+	SimplifyingSink(ContourSink& next, double tolerance);
+
+	void push(const ContourElement& element) override;
+	void finish() override;
+
+	size_t inputCount() const { return _input; }
+	size_t outputCount() const { return _output; }
+
+private:
+	void flush();
+	void emit(const ContourElement& element);
+
+	ContourSink& _next;
+	std::optional<ContourElement> _first; // first Line2 of the pending run
+	size_t _run_length = 0;
+	Point2 _anchor{ 0.0, 0.0 };
+	Point2 _end{ 0.0, 0.0 };
+	DirectionCone _cone; // directions of a merged line from _anchor that stay within tolerance of the run
+	size_t _input = 0;
+	size_t _output = 0;
+};
+
+class SvgSink : public ContourSink { /*!< Streams elements into an SVG path using the same layout as Contour::exportContourToSVG */
+public:
+	explicit SvgSink(const std::string& filename, double scale = 10);
+
+	void push(const ContourElement& element) override;
+	void finish() override;
+
+private:
+	std::ofstream _file;
+	double _scale;
+	Point2 _last{ 0.0, 0.0 };
+	bool _started = false;
+	bool _finished = false;
+};
+
+/* Binary stream: one tag byte per element followed by doubles in native byte order.
+ * Line2 (tag 0): start x, y, end x, y in the direction of getCoordinate.
+ * Arc (tag 1): center x, y, radius, start angle, end angle, then uint32 resolution and a forwards byte.
+ * CubicBezier (tag 2): start, control1, control2, end as x, y pairs, then the flatness.
+ * BSpline (tag 3): uint32 degree, uint32 control point count n, n x, y pairs, n + degree + 1 knots, then the flatness.
+ * Clothoid (tag 4): start x, y, heading, curvature, sharpness, length, then the flatness. */
+class BinarySink : public ContourSink { /*!< Writes elements in the binary stream format */
+public:
+	explicit BinarySink(std::ostream& out);
+	void push(const ContourElement& element) override;
+	void finish() override;
+
+private:
+	std::ostream& _out;
+};
+
+// Reads a binary stream written by BinarySink into sink, returns the number of elements read
+size_t readBinaryStream(std::istream& in, ContourSink& sink);
+
+class ThreadedSink : public ContourSink { /*!< Pipeline stage: forwards the stream to next on its own thread.
+	Elements travel in batches through a queue of at most capacity batches, a full queue blocks the producer. */
+public:
+	explicit ThreadedSink(ContourSink& next, size_t capacity = 8, size_t batch_size = 256);
+	~ThreadedSink() override;
+
+	ThreadedSink(const ThreadedSink&) = delete;
+	ThreadedSink& operator=(const ThreadedSink&) = delete;
+
+	void push(const ContourElement& element) override;
+	// Drains the queue, joins the worker and rethrows the first exception raised downstream
+	void finish() override;
+
+private:
+	void enqueue(std::vector<ContourElement>&& batch);
+	void run();
+
+	ContourSink& _next;
+	size_t _capacity;
+	size_t _batch_size;
+	std::vector<ContourElement> _batch;
+
+	std::mutex _mutex;
+	std::condition_variable _not_empty;
+	std::condition_variable _not_full;
+	std::deque<std::vector<ContourElement>> _queue;
+	bool _closed = false;
+	std::exception_ptr _error;
+	std::thread _worker;
+};
+
+#endif // CONTOURSINK_H
@@ -0,0 +1,120 @@
+#pragma once
+#ifndef CONTOURSTATS_H
+#define CONTOURSTATS_H
+
+#include <Config.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+/* Optional instrumentation of the Contour hot paths.
+ * Every thread counts into its own slots, a snapshot sums the live threads and the ones that have exited.
+ * With CONTOUR_INSTRUMENTATION set to 0 the macros compile to nothing and the query functions report zeros.
+ */
+
+enum class ContourStat : size_t {
+	SharedLocks,              // shared locks taken on Contour::_mutex
+	ExclusiveLocks,           // exclusive locks taken on Contour::_mutex
+	ContendedLocks,           // locks that could not be taken immediately
+	LockWaitNanoseconds,      // time spent waiting for contended locks
+	ValidityCacheHits,        // isValid() answered from the cache
+	ValidityRecomputes,       // isValid() calls that ran computeValidity()
+	ValidityNanoseconds,      // time spent in computeValidity()
+	ElementVectorCopies,      // element vectors copied out by getElements()
+	ElementsCopied,           // elements in those copies
+	TessellationCalls,        // tessellate(), getLineStrip() and exportContourToSVG() calls
+	TessellatedPoints,        // points tessellated by those calls, cached ones excluded
+	TessellationNanoseconds,  // time spent producing them
+	TessellationCacheHits,    // calls answered from the tessellation cache without tessellating anything
+	Count
+};
+
+struct ContourStatistics { /*!< Snapshot of all counters, indexed by ContourStat */
+	std::array<uint64_t, static_cast<size_t>(ContourStat::Count)> values{};
+
+	uint64_t operator[](ContourStat stat) const { return values[static_cast<size_t>(stat)]; }
+};
+
+const char* contourStatName(ContourStat stat);
+
+bool contourStatisticsEnabled();
+ContourStatistics getContourStatistics();
+void resetContourStatistics();
+
+// {"enabled": true, "counters": {"shared_locks": 12, ...}}
+std::string contourStatisticsToJSON();
+void dumpContourStatistics(const std::string& filename);
+
+#if CONTOUR_INSTRUMENTATION
+
+void recordContourStat(ContourStat stat, uint64_t value);
+
+class ScopedStatTimer { /*!< Adds the lifetime of the object in nanoseconds to a ContourStat */
+public:
+	explicit ScopedStatTimer(ContourStat stat) : _stat(stat), _start(std::chrono::steady_clock::now()) {}
+	~ScopedStatTimer()
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - _start;
+		recordContourStat(_stat, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+	ScopedStatTimer(const ScopedStatTimer&) = delete;
+	ScopedStatTimer& operator=(const ScopedStatTimer&) = delete;
+
+private:
+	ContourStat _stat;
+	std::chrono::steady_clock::time_point _start;
+};
+
+#define CONTOUR_STAT_CONCAT_(a, b) a##b
+#define CONTOUR_STAT_CONCAT(a, b) CONTOUR_STAT_CONCAT_(a, b)
+#define CONTOUR_STAT_ADD(stat, value) recordContourStat(ContourStat::stat, static_cast<uint64_t>(value))
+#define CONTOUR_STAT_TIMER(stat) ScopedStatTimer CONTOUR_STAT_CONCAT(stat_timer_, __LINE__)(ContourStat::stat)
+
+#else
+
+#define CONTOUR_STAT_ADD(stat, value) ((void)0)
+#define CONTOUR_STAT_TIMER(stat) ((void)0)
+
+#endif
+
+// Lock helpers for Contour. The clock is only read when the lock is contended.
+template <typename Lock>
+void acquireInstrumentedLock(Lock& lock, ContourStat kind)
+{
+#if CONTOUR_INSTRUMENTATION
+	recordContourStat(kind, 1);
+	if (lock.try_lock())
+	{
+		return;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	lock.lock();
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	recordContourStat(ContourStat::ContendedLocks, 1);
+	recordContourStat(ContourStat::LockWaitNanoseconds, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+#else
+	(void)kind;
+	lock.lock();
+#endif
+}
+
+inline std::unique_lock<std::shared_mutex> lockExclusive(std::shared_mutex& mutex)
+{
+	std::unique_lock lock(mutex, std::defer_lock);
+	acquireInstrumentedLock(lock, ContourStat::ExclusiveLocks);
+	return lock;
+}
+
+inline std::shared_lock<std::shared_mutex> lockShared(std::shared_mutex& mutex)
+{
+	std::shared_lock lock(mutex, std::defer_lock);
+	acquireInstrumentedLock(lock, ContourStat::SharedLocks);
+	return lock;
+}
+
+#endif // CONTOURSTATS_H
@@ -0,0 +1,106 @@
+#pragma once
+#ifndef CONTOURSTORE_H
+#define CONTOURSTORE_H
+
+#include <Config.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "BoundingBox.h"
+#include "Contour.h"
+
+using ContourHandle = uint32_t; // stable for the lifetime of the contour, never reused
+
+class ContourStore { /*!< Container for millions of contours without a heap block and a lock per contour.
+	The end points of all segments live in contiguous coordinate arrays, which is all a Line2 needs and lets
+	validate() compare joints with firstOpenJoint. Arc parameters have arrays of their own, the other curves
+	are kept in one element array. Contours are spread round robin over shards with a lock each, so writers to
+	different shards do not wait for each other. A handle encodes the shard and the slot of the contour in it.
+	Removed segments are reclaimed when a shard is mostly garbage, or by compact().
+	Line2s are stored by their end points and come back as forwards Line2s through the same points. */
+public:
+	// shards is rounded up to a power of two, 0 picks a default
+	explicit ContourStore(size_t shards = 0);
+
+	ContourStore(const ContourStore&) = delete;
+	ContourStore& operator=(const ContourStore&) = delete;
+
+	ContourHandle add(const std::vector<ContourElement>& elements);
+	ContourHandle add(const Contour& contour);
+	// Handles in the order of contours, shards are filled in parallel
+	std::vector<ContourHandle> addBatch(const std::vector<Contour>& contours, unsigned int num_threads = 0);
+
+	// Unknown or removed handles throw std::out_of_range
+	void replace(ContourHandle handle, const std::vector<ContourElement>& elements);
+	void remove(ContourHandle handle);
+	bool contains(ContourHandle handle) const;
+
+	std::vector<ContourElement> elements(ContourHandle handle) const;
+	Contour get(ContourHandle handle) const;
+	size_t segmentCount(ContourHandle handle) const;
+	// Same rules as Contour::isValid
+	bool isValid(ContourHandle handle) const;
+	BoundingBox bounds(ContourHandle handle) const;
+
+	size_t size() const;
+	// Live handles, shard by shard
+	std::vector<ContourHandle> handles() const;
+
+	// Bulk operations take every shard lock once for reading and run on num_threads threads, results follow handles
+	std::vector<uint8_t> validate(const std::vector<ContourHandle>& handles, unsigned int num_threads = 0) const;
+	std::vector<BoundingBox> bounds(const std::vector<ContourHandle>& handles, unsigned int num_threads = 0) const;
+	std::vector<Contour> toContours(const std::vector<ContourHandle>& handles, unsigned int num_threads = 0) const;
+	// One path per contour, the path data is formatted in parallel
+	void exportToSVG(const std::string& filename, const std::vector<ContourHandle>& handles, unsigned int num_threads = 0) const;
+
+	// Drops the segments of removed contours from every shard
+	void compact(unsigned int num_threads = 0);
+	// Bytes held by the arrays of all shards
+	size_t memoryUsage() const;
+
+private:
+	struct Span {
+		uint32_t first; // first segment, NONE for a removed contour
+		uint32_t count;
+	};
+
+	struct Shard {
+		mutable std::shared_mutex mutex;
+		std::vector<Span> spans;          // per slot
+		std::vector<uint32_t> segments;   // kind in the top two bits, index into the arrays of that kind below
+		// End points of every segment, parallel to segments
+		std::vector<double> start_x, start_y, end_x, end_y;
+		// Arcs
+		std::vector<double> arc_cx, arc_cy, arc_radius, arc_start, arc_end;
+		std::vector<uint32_t> arc_resolution;
+		std::vector<uint8_t> arc_forwards;
+		// CubicBezier, BSpline and Clothoid
+		std::vector<ContourElement> curves;
+		size_t live = 0;
+		size_t dead_segments = 0;
+	};
+
+	class ReadLocks;
+
+	Shard& shardOf(ContourHandle handle, uint32_t& slot) const;
+	static const Span& spanOf(const Shard& shard, uint32_t slot);
+
+	static void append(Shard& shard, const std::vector<ContourElement>& elements, Span& span);
+	// Element at position s of the segment arrays
+	static ContourElement element(const Shard& shard, uint32_t s);
+	static bool spanIsValid(const Shard& shard, const Span& span);
+	static BoundingBox spanBounds(const Shard& shard, const Span& span);
+	static void compactShard(Shard& shard);
+
+	std::vector<std::unique_ptr<Shard>> _shards;
+	unsigned int _shard_bits;
+	std::atomic<size_t> _next{ 0 };
+};
+
+#endif // CONTOURSTORE_H
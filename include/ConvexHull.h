@@ -0,0 +1,30 @@
+#pragma once
+#ifndef CONVEXHULL_H
+#define CONVEXHULL_H
+
+#include <Config.h>
+
+#include <vector>
+
+#include "Contour.h"
+
+struct HullOptions { /*!< Settings for convexHull */
+	unsigned int num_threads = 0;   // threads for large inputs, 0 picks the hardware concurrency
+};
+
+/* Exact convex hull of Line2 and Arc elements, returned as a closed counter clockwise contour of Line2s and the parts
+ * of the input arcs that lie on the hull. Line and arc end points are hulled with the monotone chain, then the hull is
+ * taken as the upper envelope of the support functions of its vertices and arcs, and the arcs are merged into it
+ * divide and conquer, O(n log n) overall. Large inputs are split into blocks hulled on num_threads threads and the
+ * envelopes merged pairwise. Other curves contribute the points of their getLineStrip. The hull of a single point is
+ * an empty contour, collinear input gives a closed contour running there and back. */
+Contour convexHull(const std::vector<ContourElement>& elements, const HullOptions& options = {});
+
+Contour convexHull(const Contour& contour, const HullOptions& options = {});
+
+Contour convexHull(const std::vector<Point2>& points, const HullOptions& options = {});
+
+// One hull per contour, contours are hulled in parallel
+std::vector<Contour> convexHullBatch(const std::vector<Contour>& contours, const HullOptions& options = {});
+
+#endif // CONVEXHULL_H
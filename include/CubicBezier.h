@@ -0,0 +1,49 @@
+#pragma once
+#ifndef CUBICBEZIER_H
+#define CUBICBEZIER_H
+
+#include <Config.h>
+#include <Segment.h>
+#include <string>
+#include <vector>
+
+class BSpline;
+
+class CubicBezier : public Segment { /*!< CubicBezier is a Segment defined by a start point, two control points and an end point.
+    getLineStrip flattens the curve so that no chord is further than flatness from the curve */
+    Point2 start;
+    Point2 control1;
+    Point2 control2;
+    Point2 end;
+
+public:
+    double flatness; // does not move the curve, unlike the points which are fixed at construction
+
+    CubicBezier(const Point2& s, const Point2& c1, const Point2& c2, const Point2& e, double flatness = 1E-3);
+
+    Point2 getCoordinate(double t) const override;
+    bool operator==(const Segment& other) const override;
+    void print(const std::string& padding) const override;
+    std::vector<Point2> getLineStrip() const override;
+    BoundingBox getBounds() const override;
+    double getClosestParameter(const Point2& point) const override;
+
+    // Flattens with a tolerance other than flatness, for instance one derived from a zoom level
+    std::vector<Point2> getLineStrip(double tolerance) const;
+    // Appends the flattened curve without its start point, so consecutive curves can share joints
+    void appendLineStrip(double tolerance, std::vector<Point2>& out) const;
+
+    // First derivative with respect to t
+    Point2 getDerivative(double t) const;
+
+    const Point2& getStart() const { return start; }
+    const Point2& getControl1() const { return control1; }
+    const Point2& getControl2() const { return control2; }
+    const Point2& getEnd() const { return end; }
+
+private:
+    friend class BSpline;
+    // Pieces of a B-spline may legitimately collapse to a point
+    CubicBezier(const Point2& point, double flatness);
+};
+#endif
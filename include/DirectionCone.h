@@ -0,0 +1,35 @@
+#pragma once
+#ifndef DIRECTIONCONE_H
+#define DIRECTIONCONE_H
+
+#include <Config.h>
+
+#include "Point2.h"
+
+class DirectionCone { /*!< Directions of a line from an anchor that passes within tolerance of every point added so far.
+	Admissible directions are kept as an angle interval relative to the first point outside the tolerance disc, so
+	merging a run of points into one line needs constant state. Used by SimplifyingSink and simplifyPoints. */
+public:
+	explicit DirectionCone(double tolerance) : _tolerance(tolerance) {}
+
+	// Starts an empty run at anchor
+	void reset(const Point2& anchor);
+	// Whether a line from the anchor through point still passes within tolerance of the added points
+	bool admits(const Point2& point) const;
+	// Narrows the cone so the line also passes within tolerance of point
+	void add(const Point2& point);
+
+private:
+	double relativeAngle(const Point2& point) const;
+
+	double _tolerance;
+	Point2 _anchor{ 0.0, 0.0 };
+	// Unconstrained until a point leaves the tolerance disc
+	bool _open = false;
+	Point2 _reference{ 1.0, 0.0 };
+	double _low = 0.0;
+	double _high = 0.0;
+	double _reach = 0.0; // farthest distance of the run from the anchor, the line must not fall short of it
+};
+
+#endif // DIRECTIONCONE_H
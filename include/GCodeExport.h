@@ -0,0 +1,67 @@
+#pragma once
+#ifndef GCODEEXPORT_H
+#define GCODEEXPORT_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Contour.h"
+#include "ContourSink.h"
+
+struct GCodeOptions { /*!< Settings for the G-code writer */
+	unsigned int precision = 4;   // decimals written for coordinates, trailing zeros are dropped
+	double feed_rate = 0.0;       // F word on the first cutting move, 0 leaves it to the controller
+	bool use_z = false;           // retract to safe_z before every rapid move and plunge to cut_z after it
+	double safe_z = 5.0;
+	double cut_z = 0.0;
+	bool program = true;          // G90 G17 at the start and M2 at the end
+	size_t buffer_size = size_t(1) << 16; // bytes formatted before they are handed to the stream
+	unsigned int num_threads = 0; // files written at once by exportContoursToGCode, 0 picks the hardware concurrency
+};
+
+/* Streams elements as G-code in the XY plane. Line2 becomes G1 and Arc G2 (clockwise) or G3 (counter clockwise)
+ * following the direction of getCoordinate, which is the order of the arc's angles whatever its forwards flag says,
+ * with I and J relative to the start of the arc. Other curves are written
+ * as G1 moves along their line strip. An element that does not start where the previous one ended is reached with a
+ * G0 rapid move. Words are formatted with std::to_chars into a fixed buffer that is written when full. */
+class GCodeSink : public ContourSink {
+public:
+	explicit GCodeSink(std::ostream& out, const GCodeOptions& options = GCodeOptions());
+	~GCodeSink() override;
+
+	GCodeSink(const GCodeSink&) = delete;
+	GCodeSink& operator=(const GCodeSink&) = delete;
+
+	void push(const ContourElement& element) override;
+	// Writes the end of the program and flushes the buffer
+	void finish() override;
+
+private:
+	void start(const Point2& point);
+	void lineTo(const Point2& point);
+	void word(char letter, double value);
+	void text(const char* value);
+	void endLine();
+	void reserve(size_t bytes);
+	void flush();
+
+	std::ostream& _out;
+	GCodeOptions _options;
+	std::vector<char> _buffer;
+	size_t _used = 0;
+	Point2 _position{ 0.0, 0.0 };
+	bool _has_position = false;
+	bool _feed_written = false;
+	bool _finished = false;
+};
+
+// Throws std::runtime_error if a file cannot be opened
+void exportContourToGCode(const Contour& contour, const std::string& filename, const GCodeOptions& options = GCodeOptions());
+// One program per contour, filenames follow contours, files are written in parallel
+void exportContoursToGCode(const std::vector<Contour>& contours, const std::vector<std::string>& filenames, const GCodeOptions& options = GCodeOptions());
+
+#endif // GCODEEXPORT_H
@@ -0,0 +1,65 @@
+#pragma once
+#ifndef INDEXEDCONTOUR_H
+#define INDEXEDCONTOUR_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BoundingBox.h"
+#include "Contour.h"
+
+class IndexedContour { /*!< Chain of elements over a shared vertex buffer. Element i runs from vertex i to vertex i + 1,
+	or back to vertex 0 for the last element of a closed chain, so every joint is stored once and the chain is valid by
+	construction. A Line2 is nothing but its two vertices and a 4 byte record; Arcs and curves are kept whole next to
+	the vertices, which hold their end points. Lines next to a curve end exactly on the curve's cached end point, two
+	consecutive curves keep their own end points and must meet within EPS whatever the tolerance. */
+public:
+	IndexedContour() = default;
+	// Polyline through points, consecutive duplicates are skipped, closed joins the last point to the first
+	explicit IndexedContour(const std::vector<Point2>& points, bool closed = false);
+	// Throws std::invalid_argument if an element does not start within tolerance of the end of the previous one
+	explicit IndexedContour(const std::vector<ContourElement>& elements, double tolerance = EPS);
+	explicit IndexedContour(const Contour& contour, double tolerance = EPS);
+
+	// Line2 from the last vertex to point, the first call only sets the start
+	void addPoint(const Point2& point);
+	// Throws std::invalid_argument if element does not start within tolerance of the last vertex, or within EPS of the
+	// end of a curve when element is a curve too
+	void addElement(const ContourElement& element, double tolerance = EPS);
+	// Joins the last vertex to the first with a Line2, or shares the first vertex if they are within tolerance, EPS
+	// between a curve ending the chain and one starting it. Throws std::invalid_argument if the Line2 would collapse
+	void close(double tolerance = EPS);
+
+	size_t size() const { return _records.size(); }
+	bool empty() const { return _records.empty(); }
+	bool isClosed() const { return _closed; }
+	const std::vector<Point2>& vertices() const { return _vertices; }
+
+	// Throws std::out_of_range
+	ContourElement element(size_t index) const;
+	std::vector<ContourElement> elements() const;
+	Contour toContour() const;
+
+	// Vertices with the line strips of curves spliced in, the first vertex repeated if closed
+	std::vector<Point2> getLineStrip() const;
+	BoundingBox getBounds() const;
+	// Bytes of the vertex buffer, the records and the kept curves
+	size_t memoryUsage() const;
+
+private:
+	static constexpr uint32_t CURVE = 0x80000000u;    // record holds an index into _curves
+	static constexpr uint32_t REVERSED = 0x40000000u; // Line2 with forwards unset
+
+	size_t endVertex(size_t index) const { return (_closed && index + 1 == _records.size()) ? 0 : index + 1; }
+	void append(const ContourElement& element, double tolerance);
+
+	std::vector<Point2> _vertices;
+	std::vector<uint32_t> _records;
+	std::vector<ContourElement> _curves;
+	bool _closed = false;
+};
+
+#endif // INDEXEDCONTOUR_H
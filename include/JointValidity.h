@@ -0,0 +1,23 @@
+#pragma once
+#ifndef JOINTVALIDITY_H
+#define JOINTVALIDITY_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Contour.h"
+
+/* Joint check over packed coordinates: joint i connects the end point (end_x[i], end_y[i]) of one segment with the
+ * start point (start_x[i], start_y[i]) of the next, and is closed when they are less than tolerance apart, the same
+ * rule as Point2::isCloseTo. Blocks of joints are compared without branches so the loop vectorizes.
+ * Returns the index of the first open joint, count if all joints are closed. */
+size_t firstOpenJoint(const double* end_x, const double* end_y, const double* start_x, const double* start_y,
+	size_t count, double tolerance = EPS);
+
+// Contour::isValid for every contour, on num_threads threads
+std::vector<uint8_t> validateContours(const std::vector<Contour>& contours, unsigned int num_threads = 0);
+
+#endif // JOINTVALIDITY_H
@@ -0,0 +1,115 @@
+#pragma once
+#ifndef LSYSTEM_H
+#define LSYSTEM_H
+
+#include <Config.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Contour.h"
+#include "ContourSink.h"
+
+class LSystem { /*!< Deterministic context free L-system over single character symbols.
+	Symbols without a rule are constants and rewrite to themselves. */
+public:
+	explicit LSystem(std::string axiom);
+
+	LSystem& addRule(char symbol, std::string replacement);
+	bool hasRule(char symbol) const { return _has_rule[static_cast<unsigned char>(symbol)]; }
+	const std::string& axiom() const { return _axiom; }
+
+	// Number of symbols after iterations rewrites, computed per symbol without expanding the string
+	uint64_t length(unsigned int iterations) const;
+
+	// Calls visit(symbol) for every symbol of the rewritten string in order. The expansion runs depth first
+	// on an explicit stack of one cursor per level, so memory is O(iterations) however long the string gets.
+	template <typename Visitor>
+	void expand(unsigned int iterations, Visitor&& visit) const
+	{
+		struct Cursor {
+			const std::string* text;
+			size_t position;
+		};
+		std::vector<Cursor> stack;
+		stack.reserve(iterations + 1);
+		stack.push_back(Cursor{ &_axiom, 0 });
+		while (!stack.empty())
+		{
+			Cursor& cursor = stack.back();
+			if (cursor.position == cursor.text->size())
+			{
+				stack.pop_back();
+				continue;
+			}
+			const char symbol = (*cursor.text)[cursor.position++];
+			const unsigned char index = static_cast<unsigned char>(symbol);
+			if (stack.size() <= iterations && _has_rule[index])
+			{
+				stack.push_back(Cursor{ &_rules[index], 0 });
+			}
+			else
+			{
+				visit(symbol);
+			}
+		}
+	}
+
+	// The rewritten string, only for small iteration counts
+	std::string expandToString(unsigned int iterations) const;
+
+private:
+	std::string _axiom;
+	std::array<std::string, 256> _rules;
+	std::array<bool, 256> _has_rule{};
+};
+
+struct TurtleOptions { /*!< Turtle state and command symbols. Angles are in radians, turning left is counter clockwise. */
+	Point2 start{ 0.0, 0.0 };
+	double heading = 0.0;
+	double step = 1.0;               // line length, and radius of the arc commands
+	double angle = PI / 2;           // turn of + and -, and sweep of the arc commands
+	std::string draw = "FG";         // draw a Line2 forward
+	std::string move = "f";          // move forward without drawing, the stream gets a gap
+	char turn_left = '+';
+	char turn_right = '-';
+	char turn_around = '|';
+	char push = '[';                 // save position and heading
+	char pop = ']';                  // restore them, the stream gets a gap
+	char arc_left = '(';             // draw an Arc turning left by angle
+	char arc_right = ')';            // draw an Arc turning right by angle
+	unsigned int arc_resolution = 20;
+};
+
+class Turtle { /*!< Interprets turtle commands one symbol at a time and pushes the drawn elements into a sink.
+	Unknown symbols are ignored, so L-system variables can be interpreted directly. */
+public:
+	Turtle(ContourSink& sink, const TurtleOptions& options = TurtleOptions());
+
+	void interpret(char symbol);
+
+	Point2 position() const { return _position; }
+	double heading() const { return _heading; }
+	size_t elementCount() const { return _count; }
+
+private:
+	enum class Command : uint8_t { None, Draw, Move, Left, Right, Around, Push, Pop, ArcLeft, ArcRight };
+
+	ContourSink& _sink;
+	TurtleOptions _options;
+	std::array<Command, 256> _commands{};
+	Point2 _position;
+	double _heading;
+	std::vector<std::pair<Point2, double>> _saved;
+	size_t _count = 0;
+};
+
+// Expands system lazily and draws it with a turtle, returns the number of elements pushed. finish() is called on sink.
+size_t generateLSystem(const LSystem& system, unsigned int iterations, ContourSink& sink, const TurtleOptions& options = TurtleOptions());
+// Appends the drawing to contour in batches
+size_t generateLSystem(const LSystem& system, unsigned int iterations, Contour& contour, const TurtleOptions& options = TurtleOptions());
+
+#endif // LSYSTEM_H
@@ -13,7 +13,7 @@ class Line2 : public Segment { /*!< Line2 is a Segment consisting of two Point2,
     bool forwards = true;
 
 public:
-    Line2::Line2(Point2 s, Point2 e, bool fw = true);
+    Line2(Point2 s, Point2 e, bool fw = true);
 
     Point2 getCoordinate(double t) const override;
 
@@ -22,6 +22,16 @@ public:
     void print(const std::string& padding) const override;
 
     std::vector<Point2> getLineStrip() const override;
+
+    BoundingBox getBounds() const override;
+
+    double getClosestParameter(const Point2& point) const override;
+
+    // Forwards line from endPoint() to startPoint(), getCoordinate and getLineStrip both run the other way
+    Line2 reversed() const;
+
+    // getLineStrip lists the stored points in their stored order whatever this says
+    bool isForwards() const { return forwards; }
 };
 
 #endif  
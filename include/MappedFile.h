@@ -0,0 +1,37 @@
+#pragma once
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class MappedFile { /*!< Read only view of a whole file. Mapped into memory on POSIX systems, so pages are only read
+	when touched and can be handed back with release(). On _WIN32 the file is read into a buffer instead. */
+public:
+	// Throws std::runtime_error if the file cannot be opened
+	explicit MappedFile(const std::string& filename);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const char* data() const { return _data; }
+	size_t size() const { return _size; }
+	std::string_view view() const { return std::string_view(_data, _size); }
+
+	// Tells the system that [0, end) will not be read again, a no-op when the file is not mapped
+	void release(size_t end);
+
+private:
+	const char* _data = nullptr;
+	size_t _size = 0;
+	size_t _released = 0;
+	std::vector<char> _buffer;
+	bool _mapped = false;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,32 @@
+#pragma once
+#ifndef MARCHINGSQUARES_H
+#define MARCHINGSQUARES_H
+
+#include <Config.h>
+
+#include <vector>
+
+#include "Contour.h"
+#include "ContourDistance.h"
+
+struct IsolineOptions { /*!< Settings for extractIsolines */
+	size_t tile_size = 256;        // cells per tile side, tiles are traced independently and stitched afterwards
+	unsigned int num_threads = 0;  // 0 uses the hardware concurrency
+	bool fit_arcs = false;         // replace smooth runs of at least min_arc_points crossings by Arcs
+	double arc_tolerance = 1E-2;   // largest distance of a crossing from its Arc, in units of the grid spacing
+	size_t min_arc_points = 5;
+};
+
+/* Traces the isolines of a scalar field sampled on grid, values are row major with sample (i, j) at
+ * values[j * grid.width + i], the layout ContourDistanceIndex::signedDistanceField returns. All levels are traced in a
+ * single pass over the cells. Tiles run in parallel, each chains its own cell segments, and chains that leave a tile
+ * are stitched through the shared edge they cross, so the traced geometry does not depend on the tile size.
+ * Isolines run with the values at or above the level on their left, loops around a maximum are counter clockwise.
+ * Isolines that leave the grid, or reach a cell with a NaN sample, are open. result[k] holds the contours of levels[k]. */
+std::vector<std::vector<Contour>> extractIsolines(const std::vector<double>& values, const DistanceFieldGrid& grid,
+	const std::vector<double>& levels, const IsolineOptions& options = {});
+
+std::vector<Contour> extractIsolines(const std::vector<double>& values, const DistanceFieldGrid& grid, double level,
+	const IsolineOptions& options = {});
+
+#endif // MARCHINGSQUARES_H
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of threads to use for work_items independent items. 0 requests the hardware concurrency.
+inline unsigned int resolveThreadCount(unsigned int num_threads, size_t work_items)
+{
+	if (num_threads == 0)
+	{
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	return static_cast<unsigned int>(std::max<size_t>(1, std::min<size_t>(num_threads, work_items)));
+}
+
+// Calls func(first, last) on contiguous blocks of [0, count) from num_threads threads.
+// The first exception thrown by a worker is rethrown on the calling thread.
+template <typename Func>
+void parallelFor(size_t count, unsigned int num_threads, Func&& func)
+{
+	const unsigned int threads = resolveThreadCount(num_threads, count);
+	if (threads <= 1)
+	{
+		func(size_t(0), count);
+		return;
+	}
+
+	std::exception_ptr error;
+	std::mutex error_mutex;
+	std::vector<std::thread> workers;
+	workers.reserve(threads);
+	const size_t block = (count + threads - 1) / threads;
+	for (unsigned int i = 0; i < threads; ++i)
+	{
+		const size_t first = std::min(count, i * block);
+		const size_t last = std::min(count, first + block);
+		workers.emplace_back([&, first, last]()
+		{
+			try
+			{
+				func(first, last);
+			}
+			catch (...)
+			{
+				std::lock_guard lock(error_mutex);
+				if (!error) error = std::current_exception();
+			}
+		});
+	}
+	for (auto& w : workers)
+	{
+		w.join();
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+#endif
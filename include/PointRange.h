@@ -0,0 +1,305 @@
+#pragma once
+#ifndef POINTRANGE_H
+#define POINTRANGE_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <iterator>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Contour.h"
+#include "DirectionCone.h"
+#include "Point2.h"
+
+/* Lazy views of the points tessellate() would produce, generated element by element while iterating.
+ * Line2s and Arcs are evaluated in place; Bezier, B-spline and clothoid strips go through a buffer the size of one
+ * element, so streaming a contour to a file needs kilobytes where getLineStrip() copies every point.
+ * The views compose: transformPoints and simplifyPoints accept any range of Point2, including each other.
+ */
+
+template <typename ElementIt>
+class ElementPointIterator { /*!< Forward iterator over the tessellated points of a run of elements. Points are the
+	same, in the same order, as appendLineStrip gives them. A dereferenced point lives in the iterator and is valid
+	until the iterator is advanced. */
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = Point2;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const Point2*;
+	using reference = const Point2&;
+
+	ElementPointIterator() = default;
+	ElementPointIterator(ElementIt element, ElementIt end, const TessellationSettings& settings)
+		: _element(element), _end(end), _settings(settings)
+	{
+		load();
+	}
+
+	reference operator*() const { return _point; }
+	pointer operator->() const { return &_point; }
+
+	ElementPointIterator& operator++()
+	{
+		if (++_index < _count)
+		{
+			evaluate();
+		}
+		else
+		{
+			++_element;
+			load();
+		}
+		return *this;
+	}
+
+	ElementPointIterator operator++(int)
+	{
+		ElementPointIterator previous = *this;
+		++(*this);
+		return previous;
+	}
+
+	bool operator==(const ElementPointIterator& other) const { return _element == other._element && _index == other._index; }
+	bool operator!=(const ElementPointIterator& other) const { return !(*this == other); }
+
+private:
+	// Sets up the first point of the element at _element, skipping anything that yields no points
+	void load()
+	{
+		_index = 0;
+		_count = 0;
+		_buffer.clear();
+		for (; _element != _end; ++_element)
+		{
+			const ContourElement& element = *_element;
+			if (std::holds_alternative<Line2>(element))
+			{
+				_count = 2;
+			}
+			else if (const Arc* arc = std::get_if<Arc>(&element))
+			{
+				_segments = arcStripSegments(*arc, _settings);
+				_count = _segments + 1;
+			}
+			else
+			{
+				appendLineStrip(element, _settings, _buffer);
+				_count = _buffer.size();
+			}
+			if (_count > 0)
+			{
+				evaluate();
+				return;
+			}
+		}
+	}
+
+	void evaluate()
+	{
+		const ContourElement& element = *_element;
+		if (const Line2* line = std::get_if<Line2>(&element))
+		{
+			// Stored order like Line2::getLineStrip, so the view matches tessellate(). Reversed lines from
+			// Line2::reversed and reverseElement are stored in traversal order, only a Line2 built with forwards
+			// unset lists its points against it.
+			const bool first = (_index == 0) == line->isForwards();
+			_point = first ? line->startPoint() : line->endPoint();
+		}
+		else if (const Arc* arc = std::get_if<Arc>(&element))
+		{
+			_point = arc->getCoordinate(static_cast<double>(_index) / _segments);
+		}
+		else
+		{
+			_point = _buffer[_index];
+		}
+	}
+
+	ElementIt _element{};
+	ElementIt _end{};
+	TessellationSettings _settings;
+	size_t _index = 0;
+	size_t _count = 0;
+	size_t _segments = 0;
+	Point2 _point{ 0.0, 0.0 };
+	std::vector<Point2> _buffer; // strip of the current curve, empty for Line2s and Arcs
+};
+
+template <typename ElementIt>
+class PointRange { /*!< Points of the elements in [first, last), the elements must outlive the range */
+public:
+	using iterator = ElementPointIterator<ElementIt>;
+
+	PointRange(ElementIt first, ElementIt last, const TessellationSettings& settings = {})
+		: _first(first), _last(last), _settings(settings)
+	{
+	}
+
+	iterator begin() const { return iterator(_first, _last, _settings); }
+	iterator end() const { return iterator(_last, _last, _settings); }
+
+private:
+	ElementIt _first;
+	ElementIt _last;
+	TessellationSettings _settings;
+};
+
+class ContourPointView { /*!< Points of a whole Contour, the same as tessellate(settings)->points. Holds a shared lock on
+	the contour while it exists: other threads can read it but block on modifications. The thread that owns the view
+	must not call any member of the contour until the view is gone, readers such as isValid, getElements, isClosed and
+	revision included. They take the shared lock again, which is undefined behaviour for std::shared_mutex and
+	deadlocks as soon as a writer is waiting. */
+public:
+	using iterator = PointRange<ContourStorage::const_iterator>::iterator;
+
+	explicit ContourPointView(const Contour& contour, const TessellationSettings& settings = {});
+
+	iterator begin() const { return _points.begin(); }
+	iterator end() const { return _points.end(); }
+
+private:
+	std::shared_lock<std::shared_mutex> _lock;
+	PointRange<ContourStorage::const_iterator> _points;
+};
+
+inline PointRange<std::vector<ContourElement>::const_iterator> pointsOf(const std::vector<ContourElement>& elements,
+	const TessellationSettings& settings = {})
+{
+	return PointRange<std::vector<ContourElement>::const_iterator>(elements.begin(), elements.end(), settings);
+}
+
+template <typename Range, typename F>
+class TransformedPoints { /*!< Applies f to every point of a range as it is read. Lvalue ranges are referenced,
+	temporaries are moved in. */
+	using BaseIterator = decltype(std::declval<const std::remove_reference_t<Range>&>().begin());
+
+public:
+	class iterator {
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Point2;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Point2*;
+		using reference = Point2;
+
+		iterator(BaseIterator it, const F* f) : _it(std::move(it)), _f(f) {}
+
+		Point2 operator*() const { return (*_f)(*_it); }
+		iterator& operator++()
+		{
+			++_it;
+			return *this;
+		}
+		bool operator==(const iterator& other) const { return _it == other._it; }
+		bool operator!=(const iterator& other) const { return !(*this == other); }
+
+	private:
+		BaseIterator _it;
+		const F* _f;
+	};
+
+	TransformedPoints(Range&& range, F f) : _range(std::forward<Range>(range)), _f(std::move(f)) {}
+
+	iterator begin() const { return iterator(_range.begin(), &_f); }
+	iterator end() const { return iterator(_range.end(), &_f); }
+
+private:
+	Range _range;
+	F _f;
+};
+
+// f maps a Point2 to a Point2
+template <typename Range, typename F>
+TransformedPoints<Range, F> transformPoints(Range&& range, F f)
+{
+	return TransformedPoints<Range, F>(std::forward<Range>(range), std::move(f));
+}
+
+template <typename Range>
+class SimplifiedPoints { /*!< Drops points while the polyline stays within tolerance of a straight line from the last
+	kept point. Single pass with constant state: each step reads ahead to the first point that does not fit. The first
+	and the last point are always kept. */
+	using BaseIterator = decltype(std::declval<const std::remove_reference_t<Range>&>().begin());
+
+public:
+	class iterator {
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Point2;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Point2*;
+		using reference = const Point2&;
+
+		iterator(BaseIterator cursor, BaseIterator end, double tolerance)
+			: _cursor(std::move(cursor)), _end(std::move(end)), _cone(tolerance)
+		{
+			_at_end = _cursor == _end;
+			if (!_at_end)
+			{
+				_point = *_cursor;
+				++_cursor;
+			}
+		}
+
+		reference operator*() const { return _point; }
+		pointer operator->() const { return &_point; }
+
+		iterator& operator++()
+		{
+			if (_cursor == _end)
+			{
+				_at_end = true;
+				return *this;
+			}
+			_cone.reset(_point);
+			Point2 last = *_cursor;
+			_cone.add(last);
+			for (++_cursor; _cursor != _end; ++_cursor)
+			{
+				const Point2 next = *_cursor;
+				if (!_cone.admits(next))
+				{
+					break;
+				}
+				_cone.add(next);
+				last = next;
+			}
+			_point = last;
+			return *this;
+		}
+
+		bool operator==(const iterator& other) const
+		{
+			return _at_end == other._at_end && (_at_end || _cursor == other._cursor);
+		}
+		bool operator!=(const iterator& other) const { return !(*this == other); }
+
+	private:
+		BaseIterator _cursor; // first point not yet consumed
+		BaseIterator _end;
+		DirectionCone _cone;
+		Point2 _point{ 0.0, 0.0 };
+		bool _at_end = false;
+	};
+
+	SimplifiedPoints(Range&& range, double tolerance) : _range(std::forward<Range>(range)), _tolerance(tolerance) {}
+
+	iterator begin() const { return iterator(_range.begin(), _range.end(), _tolerance); }
+	iterator end() const { return iterator(_range.end(), _range.end(), _tolerance); }
+
+private:
+	Range _range;
+	double _tolerance;
+};
+
+template <typename Range>
+SimplifiedPoints<Range> simplifyPoints(Range&& range, double tolerance)
+{
+	return SimplifiedPoints<Range>(std::forward<Range>(range), tolerance);
+}
+
+#endif // POINTRANGE_H
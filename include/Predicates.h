@@ -0,0 +1,38 @@
+#pragma once
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <Config.h>
+
+#include "Point2.h"
+
+/* Robust geometric predicates. The sign of every result is exact for any finite double input, whatever the magnitude
+ * of the coordinates: the determinant is first evaluated in plain floating point and accepted if it exceeds a forward
+ * error bound (Shewchuk's filters), only the rare inconclusive cases are recomputed with exact expansion arithmetic.
+ * The magnitude of a result is an approximation and must not be compared against a tolerance. */
+
+// Positive if a, b, c turn counter clockwise, negative if clockwise, zero if collinear
+double orient2d(const Point2& a, const Point2& b, const Point2& c);
+
+// Positive if d lies inside the circle through a, b, c (counter clockwise), negative outside, zero on it
+double incircle(const Point2& a, const Point2& b, const Point2& c, const Point2& d);
+
+// Positive if point lies outside the circle, negative inside, zero on it
+double circleSide(const Point2& center, double radius, const Point2& point);
+
+// -1, 0 or 1
+inline int sign(double value)
+{
+	return (value > 0) - (value < 0);
+}
+
+// Side of point relative to the line through a and b, 1 left, -1 right, 0 on it
+inline int lineSide(const Point2& a, const Point2& b, const Point2& point)
+{
+	return sign(orient2d(a, b, point));
+}
+
+// Whether the closed segments a-b and c-d share a point
+bool segmentsIntersect(const Point2& a, const Point2& b, const Point2& c, const Point2& d);
+
+#endif // PREDICATES_H
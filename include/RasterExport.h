@@ -0,0 +1,66 @@
+#pragma once
+#ifndef RASTEREXPORT_H
+#define RASTEREXPORT_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BoundingBox.h"
+#include "Contour.h"
+
+struct RasterColor {
+	uint8_t r = 0;
+	uint8_t g = 0;
+	uint8_t b = 0;
+};
+
+struct RasterOptions { /*!< Settings for renderContours. Sizes are in pixels. */
+	size_t width = 600;
+	size_t height = 600;
+	BoundingBox view;                 // world window, an empty box fits all contours
+	double margin = 8.0;              // pixels kept free around a fitted view
+	bool stroke = true;
+	double stroke_width = 1.0;
+	bool fill = false;                // even-odd fill of the closed contours, holes included
+	unsigned int fill_samples = 4;    // sub scanlines per pixel row used for anti-aliased fill
+	double flatness = 0.25;           // maximum distance between an arc or curve and its flattened chords
+	RasterColor background{ 255, 255, 255 };
+	RasterColor stroke_color{ 0, 0, 0 };
+	RasterColor fill_color{ 160, 160, 160 };
+	size_t tile_size = 64;
+	unsigned int num_threads = 0;     // 0 picks the hardware concurrency
+};
+
+class RasterImage { /*!< 8 bit RGB image, row 0 is the top row */
+public:
+	RasterImage(size_t width, size_t height, RasterColor background = RasterColor{ 255, 255, 255 });
+
+	size_t width() const { return _width; }
+	size_t height() const { return _height; }
+	RasterColor getPixel(size_t x, size_t y) const;
+	void setPixel(size_t x, size_t y, RasterColor color);
+	const std::vector<uint8_t>& data() const { return _pixels; }
+
+	// Binary PGM (P5) with the luminance of each pixel, and binary PPM (P6)
+	void writePGM(const std::string& filename) const;
+	void writePPM(const std::string& filename) const;
+
+private:
+	size_t _width;
+	size_t _height;
+	std::vector<uint8_t> _pixels;
+};
+
+/* Renders contours with analytic anti-aliased strokes and supersampled scanline fill.
+ * Strokes are rendered per tile from edges binned to the tiles they touch, fills per band of rows,
+ * both spread over num_threads threads. */
+RasterImage renderContours(const std::vector<Contour>& contours, const RasterOptions& options = RasterOptions());
+
+void exportContoursToPGM(const std::vector<Contour>& contours, const std::string& filename, const RasterOptions& options = RasterOptions());
+void exportContoursToPPM(const std::vector<Contour>& contours, const std::string& filename, const RasterOptions& options = RasterOptions());
+
+#endif // RASTEREXPORT_H
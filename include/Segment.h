@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
+#include <string>
 #include "Point2.h"
+#include "BoundingBox.h"
 
 // TODO: maybe add matrix for rotation and pivot point rot scaling and rotation
 class Segment {
@@ -11,4 +13,24 @@ public:
 	virtual void print(const std::string& padding) const = 0;
 	virtual bool operator==(const Segment& other) const = 0;
 	virtual std::vector<Point2> getLineStrip() const = 0;
+	virtual BoundingBox getBounds() const = 0;
+	// Returns t<-[0,1] such that getCoordinate(t) is the point on the segment closest to point
+	virtual double getClosestParameter(const Point2& point) const = 0;
+
+	// getCoordinate(0.0) and getCoordinate(1.0), evaluated once when the segment is constructed.
+	// Joints are checked with these, so a segment must not be changed after construction.
+	const Point2& startPoint() const { return _start_point; }
+	const Point2& endPoint() const { return _end_point; }
+
+protected:
+	// Called at the end of every constructor, once getCoordinate works
+	void cacheEndpoints()
+	{
+		_start_point = getCoordinate(0.0);
+		_end_point = getCoordinate(1.0);
+	}
+
+private:
+	Point2 _start_point{ 0.0, 0.0 };
+	Point2 _end_point{ 0.0, 0.0 };
 };
\ No newline at end of file
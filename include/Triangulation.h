@@ -0,0 +1,39 @@
+#pragma once
+#ifndef TRIANGULATION_H
+#define TRIANGULATION_H
+
+#include <Config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Contour.h"
+
+struct TriangulationOptions { /*!< Settings for triangulate */
+	double flatness = 1E-3;         // maximum distance between an arc or curve and its flattened chords, in world units
+	unsigned int num_threads = 0;   // shapes triangulated at once by triangulateBatch, 0 picks the hardware concurrency
+};
+
+struct TriangleMesh { /*!< Indexed triangles in flat buffers, ready for upload to a vertex and an index buffer */
+	std::vector<double> vertices;   // x0, y0, x1, y1, ... the flattened rings one after the other
+	std::vector<uint32_t> indices;  // three per triangle, counter clockwise
+
+	size_t vertexCount() const { return vertices.size() / 2; }
+	size_t triangleCount() const { return indices.size() / 3; }
+};
+
+/* Triangulates the area enclosed by closed contours under the even-odd rule, so contours inside an outline are holes.
+ * Arcs and curves are flattened to within options.flatness. The rings are split into y-monotone pieces by a sweep
+ * over the vertices and each piece is triangulated with a stack, O(n log n) for n flattened vertices.
+ * A region bounded by n vertices and h holes gives n + 2 h - 2 triangles. The contours must be closed and must not
+ * intersect each other or themselves, std::invalid_argument is thrown for open contours. */
+TriangleMesh triangulate(const std::vector<Contour>& rings, const TriangulationOptions& options = {});
+
+TriangleMesh triangulate(const Contour& contour, const TriangulationOptions& options = {});
+
+// One mesh per shape, shapes are triangulated in parallel
+std::vector<TriangleMesh> triangulateBatch(const std::vector<std::vector<Contour>>& shapes,
+	const TriangulationOptions& options = {});
+
+#endif // TRIANGULATION_H
@@ -48,6 +48,7 @@ Arc::Arc(const Point2& c, double r, double start, double end, unsigned res, bool
 	end_angle = end;
 	forwards = fw;
 	resolution = res;
+	cacheEndpoints();
 }
 
 // Gets coordinate on circle arc, t<-[0,1]
@@ -98,3 +99,65 @@ std::vector<Point2> Arc::getLineStrip() const
 
 	return points;
 }
+
+double Arc::getAngle(double t) const
+{
+	// Mirrors getCoordinate: a backwards arc evaluates getPoint(1 - t)
+	if (forwards)
+	{
+		return start_angle + (end_angle - start_angle) * t;
+	}
+	return end_angle - (end_angle - start_angle) * (1 - t);
+}
+
+// The box spans the end points and every axis extreme (multiples of PI/2) swept by the arc
+BoundingBox Arc::getBounds() const
+{
+	BoundingBox box;
+	box.expand(getCoordinate(0.0));
+	box.expand(getCoordinate(1.0));
+
+	const double low = std::min(start_angle, end_angle);
+	const double high = std::max(start_angle, end_angle);
+	for (double k = std::ceil(low / (0.5 * PI)); k * 0.5 * PI <= high; k += 1.0)
+	{
+		const double angle = k * 0.5 * PI;
+		box.expand(Point2({ center.x + radius * std::cos(angle), center.y + radius * std::sin(angle) }));
+	}
+	return box;
+}
+
+double Arc::getClosestParameter(const Point2& point) const
+{
+	const double dx = point.x - center.x;
+	const double dy = point.y - center.y;
+	if (dx * dx + dy * dy == 0.0)
+	{
+		return 0.0; // every point on the arc is equally close
+	}
+
+	const double from = getAngle(0.0);
+	const double sweep = getAngle(1.0) - from;
+	if (sweep == 0.0)
+	{
+		return 0.0;
+	}
+
+	// Angle of point measured from the start of the arc in its direction of travel
+	double offset = std::fmod((sweep > 0 ? 1.0 : -1.0) * (std::atan2(dy, dx) - from), 2 * PI);
+	if (offset < 0)
+	{
+		offset += 2 * PI;
+	}
+	if (offset <= fabs(sweep))
+	{
+		return offset / fabs(sweep);
+	}
+
+	// Outside the swept range, the closest point is one of the end points
+	const Point2 a = getCoordinate(0.0);
+	const Point2 b = getCoordinate(1.0);
+	const double da = (a.x - point.x) * (a.x - point.x) + (a.y - point.y) * (a.y - point.y);
+	const double db = (b.x - point.x) * (b.x - point.x) + (b.y - point.y) * (b.y - point.y);
+	return (da <= db) ? 0.0 : 1.0;
+}
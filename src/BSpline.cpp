@@ -0,0 +1,290 @@
+#include <Config.h>
+#include <BSpline.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+	Point2 lerp(const Point2& a, const Point2& b, double t)
+	{
+		return Point2({ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t });
+	}
+
+	// Boehm's knot insertion, the curve stays the same
+	void insertKnot(std::vector<double>& knots, std::vector<Point2>& points, unsigned int degree, double u)
+	{
+		const size_t k = static_cast<size_t>(std::upper_bound(knots.begin(), knots.end(), u) - knots.begin()) - 1;
+		std::vector<Point2> result(points.size() + 1);
+		for (size_t i = 0; i < result.size(); ++i)
+		{
+			if (i + degree <= k)
+			{
+				result[i] = points[i];
+			}
+			else if (i > k)
+			{
+				result[i] = points[i - 1];
+			}
+			else
+			{
+				const double alpha = (u - knots[i]) / (knots[i + degree] - knots[i]);
+				result[i] = lerp(points[i - 1], points[i], alpha);
+			}
+		}
+		knots.insert(knots.begin() + static_cast<std::ptrdiff_t>(k) + 1, u);
+		points = std::move(result);
+	}
+}
+
+BSpline::BSpline(std::vector<Point2> control_points, unsigned int degree, double flat)
+	: BSpline(control_points, [&]()
+	{
+		// Clamped uniform knots: degree + 1 zeros, evenly spaced interior knots, degree + 1 ones
+		std::vector<double> knots;
+		const size_t n = control_points.size();
+		if (degree >= 1 && n > degree)
+		{
+			const size_t spans = n - degree;
+			knots.assign(degree + 1, 0.0);
+			for (size_t i = 1; i < spans; ++i)
+			{
+				knots.push_back(static_cast<double>(i) / static_cast<double>(spans));
+			}
+			knots.insert(knots.end(), degree + 1, 1.0);
+		}
+		return knots;
+	}(), degree, flat)
+{
+}
+
+BSpline::BSpline(std::vector<Point2> control_points, std::vector<double> knots, unsigned int degree, double flat)
+{
+	if (degree < 1 || degree > 3)
+	{
+		throw std::invalid_argument("BSpline degree must be 1, 2 or 3");
+	}
+	if (control_points.size() <= degree)
+	{
+		throw std::invalid_argument("BSpline needs more control points than its degree");
+	}
+	if (knots.size() != control_points.size() + degree + 1)
+	{
+		throw std::invalid_argument("BSpline needs control points + degree + 1 knots");
+	}
+	if (!std::is_sorted(knots.begin(), knots.end()))
+	{
+		throw std::invalid_argument("BSpline knots must be non decreasing");
+	}
+	const size_t last = knots.size() - 1;
+	for (unsigned int i = 1; i <= degree; ++i)
+	{
+		if (knots[i] != knots[0] || knots[last - i] != knots[last])
+		{
+			throw std::invalid_argument("BSpline knots must be clamped");
+		}
+	}
+	if (!(knots[degree] < knots[last - degree]))
+	{
+		throw std::invalid_argument("BSpline knot domain is empty");
+	}
+	for (size_t i = degree + 1; i + degree < last; )
+	{
+		const size_t j = static_cast<size_t>(std::upper_bound(knots.begin() + i, knots.end(), knots[i]) - knots.begin());
+		if (j - i > degree)
+		{
+			throw std::invalid_argument("BSpline interior knot multiplicity must not exceed the degree");
+		}
+		i = j;
+	}
+	if (flat <= 0)
+	{
+		throw std::invalid_argument("flatness must be positive and non zero");
+	}
+	if (std::all_of(control_points.begin(), control_points.end(), [&](const Point2& p) { return p.isCloseTo(control_points.front(), EPS); }))
+	{
+		throw std::invalid_argument("BSpline control points are all the same");
+	}
+
+	_control_points = std::move(control_points);
+	_knots = std::move(knots);
+	_degree = degree;
+	flatness = flat;
+	buildPieces();
+	cacheEndpoints();
+}
+
+// Raises every interior knot to multiplicity degree, the control polygon then splits into Bezier pieces
+void BSpline::buildPieces()
+{
+	std::vector<double> knots = _knots;
+	std::vector<Point2> points = _control_points;
+
+	const double low = _knots[_degree];
+	const double high = _knots[_knots.size() - 1 - _degree];
+	_breakpoints = { low };
+	for (size_t i = _degree + 1; i < _knots.size() - 1 - _degree; ++i)
+	{
+		if (_knots[i] != _breakpoints.back())
+		{
+			_breakpoints.push_back(_knots[i]);
+		}
+	}
+	_breakpoints.push_back(high);
+
+	for (size_t b = 1; b + 1 < _breakpoints.size(); ++b)
+	{
+		const double u = _breakpoints[b];
+		const size_t multiplicity = static_cast<size_t>(std::count(knots.begin(), knots.end(), u));
+		for (size_t r = multiplicity; r < _degree; ++r)
+		{
+			insertKnot(knots, points, _degree, u);
+		}
+	}
+
+	_pieces.clear();
+	_pieces.reserve(_breakpoints.size() - 1);
+	for (size_t i = 0; i + 1 < _breakpoints.size(); ++i)
+	{
+		const Point2* q = &points[i * _degree];
+		const Point2& start = q[0];
+		const Point2& end = q[_degree];
+		Point2 control1;
+		Point2 control2;
+		if (_degree == 3)
+		{
+			control1 = q[1];
+			control2 = q[2];
+		}
+		else if (_degree == 2)
+		{
+			// Degree elevation, exact
+			control1 = lerp(q[0], q[1], 2.0 / 3.0);
+			control2 = lerp(q[2], q[1], 2.0 / 3.0);
+		}
+		else
+		{
+			control1 = lerp(q[0], q[1], 1.0 / 3.0);
+			control2 = lerp(q[0], q[1], 2.0 / 3.0);
+		}
+		const bool collapsed = start.isCloseTo(end, EPS) && start.isCloseTo(control1, EPS) && start.isCloseTo(control2, EPS);
+		_pieces.push_back(collapsed ? CubicBezier(start, flatness) : CubicBezier(start, control1, control2, end, flatness));
+	}
+}
+
+// Gets coordinate on the spline, t<-[0,1] maps linearly onto the knot domain
+Point2 BSpline::getCoordinate(double t) const
+{
+	if (t < 0 || t > 1)
+	{
+		throw std::invalid_argument("argument is out of bounds");
+	}
+
+	const double u = _breakpoints.front() + (_breakpoints.back() - _breakpoints.front()) * t;
+	size_t i = static_cast<size_t>(std::upper_bound(_breakpoints.begin(), _breakpoints.end(), u) - _breakpoints.begin());
+	i = std::clamp<size_t>(i, 1, _pieces.size()) - 1;
+	const double s = (u - _breakpoints[i]) / (_breakpoints[i + 1] - _breakpoints[i]);
+	return _pieces[i].getCoordinate(std::clamp(s, 0.0, 1.0));
+}
+
+Point2 BSpline::getDerivative(double t) const
+{
+	const double range = _breakpoints.back() - _breakpoints.front();
+	const double u = _breakpoints.front() + range * std::clamp(t, 0.0, 1.0);
+	size_t i = static_cast<size_t>(std::upper_bound(_breakpoints.begin(), _breakpoints.end(), u) - _breakpoints.begin());
+	i = std::clamp<size_t>(i, 1, _pieces.size()) - 1;
+	const double span = _breakpoints[i + 1] - _breakpoints[i];
+	const Point2 d = _pieces[i].getDerivative(std::clamp((u - _breakpoints[i]) / span, 0.0, 1.0));
+	return Point2({ d.x * range / span, d.y * range / span });
+}
+
+bool BSpline::operator==(const Segment& other) const
+{
+	auto spline = dynamic_cast<const BSpline*>(&other);
+	if (!spline) return false;
+	if (_degree != spline->_degree ||
+		_control_points.size() != spline->_control_points.size() ||
+		_knots.size() != spline->_knots.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < _control_points.size(); ++i)
+	{
+		if (!_control_points[i].isCloseTo(spline->_control_points[i], EPS)) return false;
+	}
+	for (size_t i = 0; i < _knots.size(); ++i)
+	{
+		if (fabs(_knots[i] - spline->_knots[i]) >= EPS) return false;
+	}
+	return true;
+}
+
+void BSpline::print(const std::string& padding) const
+{
+	std::cout << padding << "BSPLINE\n";
+	std::cout << "  " << padding << "degree " << _degree << "\n";
+	std::cout << "  " << padding << "control points";
+	for (const auto& p : _control_points)
+	{
+		std::cout << " (" << p.x << ", " << p.y << ")";
+	}
+	std::cout << "\n  " << padding << "knots";
+	for (double k : _knots)
+	{
+		std::cout << " " << k;
+	}
+	std::cout << "\n";
+}
+
+std::vector<Point2> BSpline::getLineStrip() const
+{
+	return getLineStrip(flatness);
+}
+
+std::vector<Point2> BSpline::getLineStrip(double tolerance) const
+{
+	std::vector<Point2> points{ _pieces.front().getStart() };
+	for (const auto& piece : _pieces)
+	{
+		piece.appendLineStrip(tolerance, points);
+	}
+	return points;
+}
+
+BoundingBox BSpline::getBounds() const
+{
+	BoundingBox box;
+	for (const auto& piece : _pieces)
+	{
+		box.expand(piece.getBounds());
+	}
+	return box;
+}
+
+double BSpline::getClosestParameter(const Point2& point) const
+{
+	double best_t = 0.0;
+	double best = std::numeric_limits<double>::max();
+	const double low = _breakpoints.front();
+	const double range = _breakpoints.back() - low;
+	for (size_t i = 0; i < _pieces.size(); ++i)
+	{
+		// Pieces whose box is further away than the best candidate cannot contain the closest point
+		if (_pieces[i].getBounds().distanceSquaredTo(point) > best)
+		{
+			continue;
+		}
+		const double s = _pieces[i].getClosestParameter(point);
+		const Point2 p = _pieces[i].getCoordinate(s);
+		const double d = (p.x - point.x) * (p.x - point.x) + (p.y - point.y) * (p.y - point.y);
+		if (d < best)
+		{
+			best = d;
+			const double u = _breakpoints[i] + (_breakpoints[i + 1] - _breakpoints[i]) * s;
+			best_t = std::clamp((u - low) / range, 0.0, 1.0);
+		}
+	}
+	return best_t;
+}
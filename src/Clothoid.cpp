@@ -0,0 +1,519 @@
+#include <Config.h>
+#include <Clothoid.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+	// Below this |sharpness| * length^2 the heading is expanded in a short series instead of using Fresnel integrals
+	constexpr double SERIES_THRESHOLD = 0.01;
+	constexpr int SERIES_TERMS = 3;
+	constexpr int MAX_MOMENTS = 4 * (SERIES_TERMS - 1) + 2 + 3;
+
+	double normalizeAngle(double angle)
+	{
+		angle = std::fmod(angle, 2 * PI);
+		if (angle > PI) angle -= 2 * PI;
+		if (angle <= -PI) angle += 2 * PI;
+		return angle;
+	}
+
+	// X_k = int_0^1 t^k cos(b t) dt and Y_k = int_0^1 t^k sin(b t) dt for k < count
+	void momentsLinear(int count, double b, double* X, double* Y)
+	{
+		if (fabs(b) < 6.0)
+		{
+			// Taylor series of cos and sin, the largest term stays below 100 so little precision is lost
+			for (int k = 0; k < count; ++k)
+			{
+				double x = 0.0;
+				double y = 0.0;
+				double power = 1.0; // b^m / m!
+				for (int m = 0; m < 60; ++m)
+				{
+					const double term = power / (k + m + 1);
+					switch (m % 4)
+					{
+					case 0: x += term; break;
+					case 1: y += term; break;
+					case 2: x -= term; break;
+					default: y -= term; break;
+					}
+					if (fabs(term) < 1E-17 && m > fabs(b))
+					{
+						break;
+					}
+					power *= b / (m + 1);
+				}
+				X[k] = x;
+				Y[k] = y;
+			}
+			return;
+		}
+
+		// Integration by parts, stable while k stays small compared to |b|
+		const double sb = std::sin(b);
+		const double cb = std::cos(b);
+		X[0] = sb / b;
+		Y[0] = (1 - cb) / b;
+		for (int k = 1; k < count; ++k)
+		{
+			X[k] = (sb - k * Y[k - 1]) / b;
+			Y[k] = (k * X[k - 1] - cb) / b;
+		}
+	}
+
+	// Generalized Fresnel integrals X_k = int_0^1 t^k cos(a/2 t^2 + b t + c) dt and Y_k with sin, for k < count <= 3
+	void generalizedFresnel(int count, double a, double b, double c, double* X, double* Y)
+	{
+		if (fabs(a) < SERIES_THRESHOLD)
+		{
+			// cos(a/2 t^2) and sin(a/2 t^2) expanded in a, the terms are moments of the linear phase
+			double mx[MAX_MOMENTS];
+			double my[MAX_MOMENTS];
+			momentsLinear(4 * (SERIES_TERMS - 1) + 2 + count, b, mx, my);
+			for (int k = 0; k < count; ++k)
+			{
+				double x = 0.0;
+				double y = 0.0;
+				double factor = 1.0; // (a/2)^j / j!
+				for (int n = 0; n < SERIES_TERMS; ++n)
+				{
+					const double sign = (n % 2 == 0) ? 1.0 : -1.0;
+					x += sign * factor * mx[4 * n + k];
+					y += sign * factor * my[4 * n + k];
+					factor *= (a / 2) / (2 * n + 1);
+					x -= sign * factor * my[4 * n + 2 + k];
+					y += sign * factor * mx[4 * n + 2 + k];
+					factor *= (a / 2) / (2 * n + 2);
+				}
+				X[k] = x;
+				Y[k] = y;
+			}
+		}
+		else
+		{
+			// Completing the square turns the phase into PI/2 z^2
+			const double sign = a > 0 ? 1.0 : -1.0;
+			const double scale = std::sqrt(fabs(a) / PI);
+			const double z0 = sign * b / std::sqrt(PI * fabs(a));
+			const double phase = -b * b / (2 * a);
+			double c0, s0, c1, s1;
+			fresnelIntegrals(z0, c0, s0);
+			fresnelIntegrals(z0 + scale, c1, s1);
+			const double dc = c1 - c0;
+			const double ds = s1 - s0;
+			const double cp = std::cos(phase);
+			const double sp = std::sin(phase);
+			X[0] = (cp * dc - sign * sp * ds) / scale;
+			Y[0] = (sp * dc + sign * cp * ds) / scale;
+
+			// Higher moments follow from d/dt sin(phase(t)) = (a t + b) cos(phase(t)) and its cos counterpart
+			const double end = a / 2 + b;
+			const double se = std::sin(end);
+			const double ce = std::cos(end);
+			if (count > 1)
+			{
+				X[1] = (se - b * X[0]) / a;
+				Y[1] = (1 - ce - b * Y[0]) / a;
+			}
+			if (count > 2)
+			{
+				X[2] = (se - Y[0] - b * X[1]) / a;
+				Y[2] = (X[0] - ce - b * Y[1]) / a;
+			}
+		}
+
+		if (c != 0.0)
+		{
+			const double cc = std::cos(c);
+			const double sc = std::sin(c);
+			for (int k = 0; k < count; ++k)
+			{
+				const double x = X[k];
+				X[k] = cc * x - sc * Y[k];
+				Y[k] = sc * x + cc * Y[k];
+			}
+		}
+	}
+}
+
+void fresnelIntegrals(double x, double& c, double& s)
+{
+	constexpr double PRECISION = 4E-16;
+	constexpr double TINY = 1E-30;
+	constexpr int MAX_ITERATIONS = 100;
+	const double ax = fabs(x);
+
+	if (ax < 1.5)
+	{
+		// Alternating power series, C collects the even terms and S the odd ones
+		const double factor = 0.5 * PI * ax * ax;
+		double sum_c = ax;
+		double sum_s = 0.0;
+		double term = ax;
+		double sign = 1.0;
+		bool odd = true;
+		for (int k = 1, n = 3; k < MAX_ITERATIONS; ++k, n += 2)
+		{
+			term *= factor / k;
+			const double contribution = sign * term / n;
+			if (odd)
+			{
+				sum_s += contribution;
+				sign = -sign;
+			}
+			else
+			{
+				sum_c += contribution;
+			}
+			if (term < PRECISION * fabs(odd ? sum_s : sum_c))
+			{
+				break;
+			}
+			odd = !odd;
+		}
+		c = sum_c;
+		s = sum_s;
+	}
+	else
+	{
+		// Continued fraction of the complementary error function, evaluated with the modified Lentz method.
+		// Complex arithmetic is spelled out, std::complex division is a library call per iteration.
+		const double pix2 = PI * ax * ax;
+		double br = 1.0, bi = -pix2;
+		double cr = 1.0 / TINY, ci = 0.0;
+		double norm = br * br + bi * bi;
+		double dr = br / norm, di = -bi / norm;
+		double hr = dr, hi = di;
+		for (int k = 2, n = -1; k < MAX_ITERATIONS; ++k)
+		{
+			n += 2;
+			const double a = -static_cast<double>(n) * (n + 1);
+			br += 4.0;
+			// d = 1 / (a d + b)
+			const double xr = a * dr + br;
+			const double xi = a * di + bi;
+			norm = xr * xr + xi * xi;
+			dr = xr / norm;
+			di = -xi / norm;
+			// c = b + a / c
+			norm = cr * cr + ci * ci;
+			cr = br + a * cr / norm;
+			ci = bi - a * ci / norm;
+			// h *= c d
+			const double er = cr * dr - ci * di;
+			const double ei = cr * di + ci * dr;
+			const double r = hr * er - hi * ei;
+			hi = hr * ei + hi * er;
+			hr = r;
+			if (fabs(er - 1.0) + fabs(ei) < PRECISION)
+			{
+				break;
+			}
+		}
+		// h *= (ax - i ax), then (c, s) = (1 + i) / 2 * (1 - e^(i pix2 / 2) h)
+		const double r = ax * (hr + hi);
+		hi = ax * (hi - hr);
+		hr = r;
+		const double cp = std::cos(0.5 * pix2);
+		const double sp = std::sin(0.5 * pix2);
+		const double ur = 1.0 - (cp * hr - sp * hi);
+		const double ui = -(cp * hi + sp * hr);
+		c = 0.5 * (ur - ui);
+		s = 0.5 * (ur + ui);
+	}
+
+	if (x < 0)
+	{
+		c = -c;
+		s = -s;
+	}
+}
+
+Clothoid::Clothoid(const Point2& start, double heading, double curvature, double sharpness, double length, double flat)
+{
+	if (length <= 0)
+	{
+		throw std::invalid_argument("length must be positive and non zero");
+	}
+	if (flat <= 0)
+	{
+		throw std::invalid_argument("flatness must be positive and non zero");
+	}
+
+	_start = start;
+	_heading = heading;
+	_curvature = curvature;
+	_sharpness = sharpness;
+	_length = length;
+	_flatness = flat;
+
+	_use_fresnel = fabs(sharpness) * length * length >= SERIES_THRESHOLD;
+	if (_use_fresnel)
+	{
+		_sign = sharpness > 0 ? 1.0 : -1.0;
+		_scale = std::sqrt(fabs(sharpness) / PI);
+		const double phase = heading - curvature * curvature / (2 * sharpness);
+		_cos_phase = std::cos(phase);
+		_sin_phase = std::sin(phase);
+		_z0 = _sign * curvature / std::sqrt(PI * fabs(sharpness));
+		fresnelIntegrals(_z0, _c0, _s0);
+	}
+	cacheEndpoints();
+}
+
+// Position at arc length s
+Point2 Clothoid::position(double s) const
+{
+	if (s == 0.0)
+	{
+		return _start;
+	}
+	if (_use_fresnel)
+	{
+		double c1, s1;
+		fresnelIntegrals(_z0 + _scale * s, c1, s1);
+		const double dc = c1 - _c0;
+		const double ds = s1 - _s0;
+		return Point2({ _start.x + (_cos_phase * dc - _sign * _sin_phase * ds) / _scale,
+			_start.y + (_sin_phase * dc + _sign * _cos_phase * ds) / _scale });
+	}
+	double X, Y;
+	generalizedFresnel(1, _sharpness * s * s, _curvature * s, _heading, &X, &Y);
+	return Point2({ _start.x + s * X, _start.y + s * Y });
+}
+
+// Gets coordinate on the clothoid, t<-[0,1] is proportional to arc length
+Point2 Clothoid::getCoordinate(double t) const
+{
+	if (t < 0 || t > 1)
+	{
+		throw std::invalid_argument("argument is out of bounds");
+	}
+	return position(t * _length);
+}
+
+std::vector<Point2> Clothoid::getCoordinates(const std::vector<double>& ts) const
+{
+	if (std::any_of(ts.begin(), ts.end(), [](double t) { return !(t >= 0 && t <= 1); }))
+	{
+		throw std::invalid_argument("argument is out of bounds");
+	}
+	std::vector<Point2> points;
+	points.reserve(ts.size());
+	for (double t : ts)
+	{
+		points.push_back(position(t * _length));
+	}
+	return points;
+}
+
+double Clothoid::getHeading(double t) const
+{
+	const double s = t * _length;
+	return _heading + _curvature * s + 0.5 * _sharpness * s * s;
+}
+
+double Clothoid::getCurvature(double t) const
+{
+	return _curvature + _sharpness * t * _length;
+}
+
+bool Clothoid::operator==(const Segment& other) const
+{
+	auto clothoid = dynamic_cast<const Clothoid*>(&other);
+	if (!clothoid) return false;
+	return _start.isCloseTo(clothoid->_start, EPS) &&
+		fabs(_heading - clothoid->_heading) < EPS &&
+		fabs(_curvature - clothoid->_curvature) < EPS &&
+		fabs(_sharpness - clothoid->_sharpness) < EPS &&
+		fabs(_length - clothoid->_length) < EPS;
+}
+
+void Clothoid::print(const std::string& padding) const
+{
+	std::cout << padding << "CLOTHOID\n";
+	std::cout << "  " << padding << "start " << _start.x << " " << _start.y << "\n";
+	std::cout << "  " << padding << "heading " << _heading << "\n";
+	std::cout << "  " << padding << "curvature " << _curvature << " sharpness " << _sharpness << "\n";
+	std::cout << "  " << padding << "length " << _length << "\n";
+}
+
+std::vector<Point2> Clothoid::getLineStrip() const
+{
+	return getLineStrip(_flatness);
+}
+
+// A chord of length h on a curve of curvature k deviates by about k h^2 / 8, the largest curvature sets the step
+std::vector<Point2> Clothoid::getLineStrip(double tolerance) const
+{
+	if (tolerance <= 0)
+	{
+		throw std::invalid_argument("tolerance must be positive and non zero");
+	}
+	const double max_curvature = std::max(fabs(getCurvature(0.0)), fabs(getCurvature(1.0)));
+	size_t n = 1;
+	if (max_curvature > 0)
+	{
+		const double step = std::sqrt(8 * tolerance / max_curvature);
+		n = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::min(_length / step, 1E7))));
+	}
+
+	std::vector<double> ts(n + 1);
+	for (size_t i = 0; i <= n; ++i)
+	{
+		ts[i] = static_cast<double>(i) / static_cast<double>(n);
+	}
+	return getCoordinates(ts);
+}
+
+// The box spans the end points and every point where the heading is a multiple of PI/2
+BoundingBox Clothoid::getBounds() const
+{
+	BoundingBox box;
+	box.expand(getCoordinate(0.0));
+	box.expand(getCoordinate(1.0));
+
+	// The heading is quadratic in s, its range over [0, L] includes the vertex when that lies inside
+	double low = std::min(getHeading(0.0), getHeading(1.0));
+	double high = std::max(getHeading(0.0), getHeading(1.0));
+	if (_sharpness != 0.0)
+	{
+		const double vertex = -_curvature / _sharpness;
+		if (vertex > 0 && vertex < _length)
+		{
+			const double h = getHeading(vertex / _length);
+			low = std::min(low, h);
+			high = std::max(high, h);
+		}
+	}
+
+	for (double k = std::ceil(low / (0.5 * PI)); k * 0.5 * PI <= high; k += 1.0)
+	{
+		// Solve heading + curvature s + sharpness / 2 s^2 = k PI / 2 for s in [0, L]
+		const double target = k * 0.5 * PI - _heading;
+		std::vector<double> roots;
+		if (_sharpness == 0.0)
+		{
+			if (_curvature != 0.0) roots.push_back(target / _curvature);
+		}
+		else
+		{
+			const double disc = _curvature * _curvature + 2 * _sharpness * target;
+			if (disc >= 0)
+			{
+				const double r = std::sqrt(disc);
+				roots.push_back((-_curvature + r) / _sharpness);
+				roots.push_back((-_curvature - r) / _sharpness);
+			}
+		}
+		for (double s : roots)
+		{
+			if (s > 0 && s < _length)
+			{
+				box.expand(position(s));
+			}
+		}
+	}
+	return box;
+}
+
+// Sampling picks the basin, Newton's method on (P(s) - p) . T(s) = 0 refines it
+double Clothoid::getClosestParameter(const Point2& point) const
+{
+	auto distance2 = [&](double t)
+	{
+		const Point2 p = getCoordinate(t);
+		return (p.x - point.x) * (p.x - point.x) + (p.y - point.y) * (p.y - point.y);
+	};
+
+	// At least a few samples per quarter turn, the distance can only have one minimum between them
+	const double turn = fabs(getHeading(1.0) - _heading) + fabs(_curvature) * _length;
+	const int samples = std::clamp(static_cast<int>(std::ceil(turn / (0.125 * PI))), 32, 4096);
+	double best_t = 0.0;
+	double best = std::numeric_limits<double>::max();
+	for (int i = 0; i <= samples; ++i)
+	{
+		const double t = static_cast<double>(i) / samples;
+		const double d = distance2(t);
+		if (d < best)
+		{
+			best = d;
+			best_t = t;
+		}
+	}
+
+	double s = best_t * _length;
+	for (int iteration = 0; iteration < 8; ++iteration)
+	{
+		const Point2 p = position(s);
+		const double theta = getHeading(s / _length);
+		const double ex = p.x - point.x;
+		const double ey = p.y - point.y;
+		const double f = ex * std::cos(theta) + ey * std::sin(theta);
+		const double df = 1 + getCurvature(s / _length) * (ey * std::cos(theta) - ex * std::sin(theta));
+		if (fabs(df) < EPS)
+		{
+			break;
+		}
+		const double next = std::clamp(s - f / df, 0.0, _length);
+		if (fabs(next - s) < EPS * _length)
+		{
+			s = next;
+			break;
+		}
+		s = next;
+	}
+	const double t = s / _length;
+	return distance2(t) <= best ? t : best_t;
+}
+
+Clothoid Clothoid::fitG1(const Point2& p0, double theta0, const Point2& p1, double theta1, double flatness)
+{
+	const double dx = p1.x - p0.x;
+	const double dy = p1.y - p0.y;
+	const double r = std::hypot(dx, dy);
+	if (r < EPS)
+	{
+		throw std::invalid_argument("clothoid end points are the same");
+	}
+
+	// Headings relative to the chord, the unknown A is half the total change of curvature times the length
+	const double phi = std::atan2(dy, dx);
+	const double phi0 = normalizeAngle(theta0 - phi);
+	const double phi1 = normalizeAngle(theta1 - phi);
+	const double delta = phi1 - phi0;
+
+	// Newton's method on Y_0(2A, delta - A, phi0) = 0, the end point must lie on the chord
+	double A = 3 * (phi0 + phi1);
+	double X[3], Y[3];
+	bool converged = false;
+	for (int iteration = 0; iteration < 50; ++iteration)
+	{
+		generalizedFresnel(3, 2 * A, delta - A, phi0, X, Y);
+		const double f = Y[0];
+		const double df = X[2] - X[1];
+		if (fabs(f) < 1E-12)
+		{
+			converged = true;
+			break;
+		}
+		if (df == 0.0)
+		{
+			break;
+		}
+		A -= f / df;
+	}
+	generalizedFresnel(1, 2 * A, delta - A, phi0, X, Y);
+	if (!converged || X[0] <= 0)
+	{
+		throw std::runtime_error("clothoid fit did not converge");
+	}
+
+	const double length = r / X[0];
+	return Clothoid(p0, theta0, (delta - A) / length, 2 * A / (length * length), length, flatness);
+}
@@ -0,0 +1,434 @@
+#include <Config.h>
+#include <CompactContour.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+	// Low bits of the tag byte, same numbering as the binary stream of BinarySink
+	constexpr uint8_t KIND_LINE2 = 0;
+	constexpr uint8_t KIND_ARC = 1;
+	constexpr uint8_t KIND_CUBIC_BEZIER = 2;
+	constexpr uint8_t KIND_BSPLINE = 3;
+	constexpr uint8_t KIND_CLOTHOID = 4;
+	constexpr uint8_t KIND_MASK = 7;
+	constexpr uint8_t FLAG_JOINED = 8;      // Line2 or CubicBezier that starts at the end of the previous element, its start is not stored
+	constexpr uint8_t FLAG_REVERSED = 16;   // Line2 or Arc with forwards unset
+	constexpr uint8_t FLAG_JOINED_END = 32; // Line2 that ends at the start of the next element, its end is not stored
+
+	bool samePoint(const Point2& a, const Point2& b)
+	{
+		return a.x == b.x && a.y == b.y;
+	}
+
+	// Elements whose start is taken from the previous element when they join it. Their end is stored, so it decodes
+	// without looking further back. Arcs, B-splines and clothoids keep their own start.
+	bool derivesStart(const ContourElement& element)
+	{
+		return std::holds_alternative<Line2>(element) || std::holds_alternative<CubicBezier>(element);
+	}
+
+	class Writer {
+	public:
+		Writer(std::vector<uint8_t>& out, const Point2& origin, double quantum)
+			: _out(out), _origin(origin), _quantum(quantum)
+		{
+		}
+
+		template <typename T>
+		void value(T v)
+		{
+			const size_t at = _out.size();
+			_out.resize(at + sizeof(T));
+			std::memcpy(_out.data() + at, &v, sizeof(T));
+		}
+
+		void point(const Point2& p)
+		{
+			if (_quantum > 0)
+			{
+				value(grid(p.x - _origin.x));
+				value(grid(p.y - _origin.y));
+				return;
+			}
+			value(p.x);
+			value(p.y);
+		}
+
+	private:
+		int32_t grid(double offset) const
+		{
+			const double steps = std::round(offset / _quantum);
+			if (!(fabs(steps) <= std::numeric_limits<int32_t>::max()))
+			{
+				throw std::invalid_argument("coordinates do not fit the quantization grid");
+			}
+			return static_cast<int32_t>(steps);
+		}
+
+		std::vector<uint8_t>& _out;
+		Point2 _origin;
+		double _quantum;
+	};
+}
+
+class CompactContour::Reader {
+public:
+	Reader(const CompactContour& contour, size_t index)
+		: _at(contour._records.data() + contour._offsets[index]), _origin(contour._origin), _quantum(contour._quantum)
+	{
+	}
+
+	template <typename T>
+	T value()
+	{
+		T v;
+		std::memcpy(&v, _at, sizeof(T));
+		_at += sizeof(T);
+		return v;
+	}
+
+	Point2 point()
+	{
+		if (_quantum > 0)
+		{
+			const int32_t x = value<int32_t>();
+			const int32_t y = value<int32_t>();
+			return Point2({ _origin.x + x * _quantum, _origin.y + y * _quantum });
+		}
+		const double x = value<double>();
+		const double y = value<double>();
+		return Point2({ x, y });
+	}
+
+private:
+	const uint8_t* _at;
+	Point2 _origin;
+	double _quantum;
+};
+
+CompactContour::CompactContour(const std::vector<ContourElement>& elements, const CompactOptions& options)
+{
+	if (options.quantize)
+	{
+		if (!(options.quantum > 0))
+		{
+			throw std::invalid_argument("quantum must be positive");
+		}
+		BoundingBox box;
+		for (const auto& e : elements)
+		{
+			box.expand(std::visit([](const auto& seg) { return seg.getBounds(); }, e));
+		}
+		if (!elements.empty())
+		{
+			_origin = Point2({ 0.5 * (box.min.x + box.max.x), 0.5 * (box.min.y + box.max.y) });
+		}
+		_quantum = options.quantum;
+	}
+
+	Writer out(_records, _origin, _quantum);
+	// Exact decoding needs the points to be bit identical, on the grid joints within EPS are closed
+	auto joins = [this](const Point2& end, const Point2& start)
+	{
+		return isQuantized() ? start.isCloseTo(end, EPS) : samePoint(start, end);
+	};
+	_offsets.reserve(elements.size());
+	for (size_t i = 0; i < elements.size(); ++i)
+	{
+		if (_records.size() > std::numeric_limits<uint32_t>::max())
+		{
+			throw std::length_error("contour too large for a CompactContour");
+		}
+		_offsets.push_back(static_cast<uint32_t>(_records.size()));
+		const ContourElement& element = elements[i];
+		const bool joined = i > 0 && derivesStart(element) &&
+			joins(asSegment(elements[i - 1]).endPoint(), asSegment(element).startPoint());
+		if (const Line2* line = std::get_if<Line2>(&element))
+		{
+			// A Line2 leading into an element that keeps its own start ends there, and so does the last Line2 of a
+			// closed contour, the first element never derives its start
+			const size_t next = i + 1 < elements.size() ? i + 1 : 0;
+			const bool joined_end = elements.size() > 1 && (next == 0 || !derivesStart(elements[next])) &&
+				joins(line->endPoint(), asSegment(elements[next]).startPoint());
+			out.value(static_cast<uint8_t>(KIND_LINE2 | (joined ? FLAG_JOINED : 0) | (joined_end ? FLAG_JOINED_END : 0) |
+				(line->isForwards() ? 0 : FLAG_REVERSED)));
+			if (!joined)
+			{
+				out.point(line->startPoint());
+			}
+			if (!joined_end)
+			{
+				out.point(line->endPoint());
+			}
+		}
+		else if (const Arc* arc = std::get_if<Arc>(&element))
+		{
+			out.value(static_cast<uint8_t>(KIND_ARC | (arc->isForwards() ? 0 : FLAG_REVERSED)));
+			out.point(arc->getCenter());
+			out.value(arc->getRadius());
+			out.value(arc->getStartAngle());
+			out.value(arc->getEndAngle());
+			out.value(static_cast<uint32_t>(arc->getResolution()));
+		}
+		else if (const CubicBezier* curve = std::get_if<CubicBezier>(&element))
+		{
+			out.value(static_cast<uint8_t>(KIND_CUBIC_BEZIER | (joined ? FLAG_JOINED : 0)));
+			if (!joined)
+			{
+				out.point(curve->getStart());
+			}
+			out.point(curve->getControl1());
+			out.point(curve->getControl2());
+			out.point(curve->getEnd());
+			out.value(curve->flatness);
+		}
+		else if (const BSpline* spline = std::get_if<BSpline>(&element))
+		{
+			out.value(KIND_BSPLINE);
+			out.value(static_cast<uint32_t>(spline->getDegree()));
+			out.value(static_cast<uint32_t>(spline->getControlPoints().size()));
+			for (const auto& p : spline->getControlPoints())
+			{
+				out.point(p);
+			}
+			for (double knot : spline->getKnots())
+			{
+				out.value(knot);
+			}
+			out.value(spline->flatness);
+		}
+		else
+		{
+			const Clothoid& clothoid = std::get<Clothoid>(element);
+			out.value(KIND_CLOTHOID);
+			out.point(clothoid.getStart());
+			out.value(clothoid.getHeading(0.0));
+			out.value(clothoid.getCurvature(0.0));
+			out.value(clothoid.getSharpness());
+			out.value(clothoid.getLength());
+			out.value(clothoid.getFlatness());
+		}
+	}
+	_records.shrink_to_fit();
+
+	if (isQuantized())
+	{
+		// A Line2 shorter than the grid collapses to a point
+		try
+		{
+			this->elements();
+		}
+		catch (const std::invalid_argument&)
+		{
+			throw std::invalid_argument("quantum is too coarse for the elements");
+		}
+	}
+}
+
+CompactContour::CompactContour(const Contour& contour, const CompactOptions& options)
+	: CompactContour(contour.getElements(), options)
+{
+}
+
+ContourElement CompactContour::at(size_t index) const
+{
+	if (index >= size())
+	{
+		throw std::out_of_range("CompactContour index out of range");
+	}
+	return decode(index);
+}
+
+std::vector<ContourElement> CompactContour::elements() const
+{
+	std::vector<ContourElement> result;
+	result.reserve(size());
+	for (size_t i = 0; i < size(); ++i)
+	{
+		// A joined element starts at the end of the element decoded just before
+		if (i > 0)
+		{
+			const Point2 previous_end = asSegment(result.back()).endPoint();
+			result.push_back(decode(i, &previous_end));
+			continue;
+		}
+		result.push_back(decode(i));
+	}
+	return result;
+}
+
+Contour CompactContour::toContour() const
+{
+	Contour contour;
+	contour.addItems(elements());
+	return contour;
+}
+
+size_t CompactContour::memoryUsage() const
+{
+	return _records.capacity() + _offsets.capacity() * sizeof(uint32_t);
+}
+
+ContourElement CompactContour::decode(size_t index, const Point2* previous_end) const
+{
+	Reader in(*this, index);
+	const uint8_t tag = in.value<uint8_t>();
+	const bool reversed = (tag & FLAG_REVERSED) != 0;
+	auto readStart = [&]()
+	{
+		if ((tag & FLAG_JOINED) == 0)
+		{
+			return in.point();
+		}
+		return previous_end ? *previous_end : endOf(index - 1);
+	};
+	switch (tag & KIND_MASK)
+	{
+	case KIND_LINE2:
+	{
+		const Point2 first = readStart();
+		const Point2 last = (tag & FLAG_JOINED_END) ? startOf(nextOf(index)) : in.point();
+		if (reversed)
+		{
+			return Line2(last, first, false);
+		}
+		return Line2(first, last);
+	}
+	case KIND_ARC:
+	{
+		const Point2 center = in.point();
+		const double radius = in.value<double>();
+		const double start = in.value<double>();
+		const double end = in.value<double>();
+		const uint32_t resolution = in.value<uint32_t>();
+		return Arc(center, radius, start, end, resolution, !reversed);
+	}
+	case KIND_CUBIC_BEZIER:
+	{
+		const Point2 first = readStart();
+		const Point2 control1 = in.point();
+		const Point2 control2 = in.point();
+		const Point2 last = in.point();
+		return CubicBezier(first, control1, control2, last, in.value<double>());
+	}
+	case KIND_BSPLINE:
+	{
+		const uint32_t degree = in.value<uint32_t>();
+		const uint32_t count = in.value<uint32_t>();
+		std::vector<Point2> points(count);
+		for (auto& p : points)
+		{
+			p = in.point();
+		}
+		std::vector<double> knots(count + degree + 1);
+		for (double& knot : knots)
+		{
+			knot = in.value<double>();
+		}
+		return BSpline(std::move(points), std::move(knots), degree, in.value<double>());
+	}
+	default:
+	{
+		const Point2 start = in.point();
+		double v[5];
+		for (double& x : v)
+		{
+			x = in.value<double>();
+		}
+		return Clothoid(start, v[0], v[1], v[2], v[3], v[4]);
+	}
+	}
+}
+
+// End point of the decoded element, read from the record for a Line2 or CubicBezier
+Point2 CompactContour::endOf(size_t index) const
+{
+	Reader in(*this, index);
+	const uint8_t tag = in.value<uint8_t>();
+	const uint8_t kind = tag & KIND_MASK;
+	if (kind == KIND_LINE2 || kind == KIND_CUBIC_BEZIER)
+	{
+		if ((tag & FLAG_JOINED) == 0)
+		{
+			in.point();
+		}
+		if (kind == KIND_CUBIC_BEZIER)
+		{
+			in.point();
+			in.point();
+		}
+		else if (tag & FLAG_JOINED_END)
+		{
+			return startOf(nextOf(index));
+		}
+		return in.point();
+	}
+	return asSegment(decode(index)).endPoint();
+}
+
+// Start point of an element that does not derive it from its predecessor: one keeping its own start, or the first
+Point2 CompactContour::startOf(size_t index) const
+{
+	return asSegment(decode(index)).startPoint();
+}
+
+size_t CompactContour::nextOf(size_t index) const
+{
+	return index + 1 < size() ? index + 1 : 0;
+}
+
+std::string ContourMemoryReport::toString() const
+{
+	std::ostringstream out;
+	auto line = [&](const char* mode, size_t bytes)
+	{
+		out << mode << ": " << bytes << " bytes";
+		if (elements > 0)
+		{
+			out << ", " << static_cast<double>(bytes) / elements << " per element";
+		}
+		out << "\n";
+	};
+	out << "sizeof ContourElement " << sizeof(ContourElement) << ", Line2 " << sizeof(Line2) << ", Arc " << sizeof(Arc)
+		<< ", CubicBezier " << sizeof(CubicBezier) << ", BSpline " << sizeof(BSpline) << ", Clothoid " << sizeof(Clothoid) << "\n";
+	out << elements << " elements\n";
+	line("std::vector<ContourElement>", element_bytes);
+	line("CompactContour", compact_bytes);
+	line("quantized CompactContour", quantized_bytes);
+	return out.str();
+}
+
+ContourMemoryReport memoryReport(const std::vector<ContourElement>& elements, double quantum)
+{
+	ContourMemoryReport report;
+	report.elements = elements.size();
+	report.element_bytes = elements.size() * sizeof(ContourElement);
+	for (const auto& e : elements)
+	{
+		if (const BSpline* spline = std::get_if<BSpline>(&e))
+		{
+			report.element_bytes += spline->getControlPoints().capacity() * sizeof(Point2) +
+				spline->getKnots().capacity() * sizeof(double) +
+				spline->getBezierPieces().capacity() * sizeof(CubicBezier) +
+				(spline->getBezierPieces().size() + 1) * sizeof(double);
+		}
+	}
+	report.compact_bytes = CompactContour(elements).memoryUsage();
+	try
+	{
+		CompactOptions options;
+		options.quantize = true;
+		options.quantum = quantum;
+		report.quantized_bytes = CompactContour(elements, options).memoryUsage();
+	}
+	catch (const std::invalid_argument&)
+	{
+		report.quantized_bytes = 0;
+	}
+	return report;
+}
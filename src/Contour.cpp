@@ -1,27 +1,38 @@
 #include <Config.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <mutex>
 #include <shared_mutex>
 #include <fstream>
 
+#include <ContourStats.h>
+#include <JointValidity.h>
+
 
 // TODO: add 2x2 matrix feature with scaling, translation and rotation
 
 Contour::Contour(const Contour& other)
 {
-	std::shared_lock lock(other._mutex);
+	auto lock = lockShared(other._mutex);
 	_elements = other._elements;
 	is_valid_dirty_ = other.is_valid_dirty_;
 	is_valid_cache_ = other.is_valid_cache_;
+	_tessellations = other._tessellations;
+	_revision = other._revision;
 }
 
 Contour::Contour(Contour&& other) noexcept
 {
-	std::unique_lock lock(other._mutex);
+	auto lock = lockExclusive(other._mutex);
 	_elements = std::move(other._elements);
 	is_valid_dirty_ = other.is_valid_dirty_;
 	is_valid_cache_ = other.is_valid_cache_;
+	_tessellations = std::move(other._tessellations);
+	other._tessellations.clear();
+	_revision = other._revision;
+	++other._revision;
 }
 
 Contour& Contour::operator=(const Contour& other)
@@ -35,6 +46,8 @@ Contour& Contour::operator=(const Contour& other)
 		_elements = other._elements;
 		is_valid_dirty_ = other.is_valid_dirty_;
 		is_valid_cache_ = other.is_valid_cache_;
+		_tessellations = other._tessellations;
+		++_revision;
 	}
 	return *this;
 }
@@ -50,6 +63,10 @@ Contour& Contour::operator=(Contour&& other) noexcept
 		_elements = std::move(other._elements);
 		is_valid_dirty_ = other.is_valid_dirty_;
 		is_valid_cache_ = other.is_valid_cache_;
+		_tessellations = std::move(other._tessellations);
+		other._tessellations.clear();
+		++_revision;
+		++other._revision;
 	}
 	return *this;
 }
@@ -67,29 +84,35 @@ bool Contour::operator==(const Contour& other) const
 //TODO: Check that lvalue is easier to use here
 void Contour::addItem(ContourElement item)
 {
-	std::unique_lock lock(_mutex);
+	auto lock = lockExclusive(_mutex);
 	_elements.emplace_back(item);
+	spliceTessellations(_elements.size() - 1, 0, 1);
 	is_valid_dirty_ = true;
+	++_revision;
 }
 
 void Contour::addItemAt(ContourElement&& item, unsigned int index)
 {
-	std::unique_lock lock(_mutex);
+	auto lock = lockExclusive(_mutex);
 	if (index > _elements.size())
 	{
 		throw std::out_of_range("Index is out of bounds");
 	}
 	_elements.insert(_elements.begin() + index, std::move(item));
+	spliceTessellations(index, 0, 1);
 	is_valid_dirty_ = true;
+	++_revision;
 }
 
 // TODO: edge cases?
 void Contour::addItemToCenter(const ContourElement& item)
 {
-	std::unique_lock lock(_mutex);
-	auto middle = _elements.begin() + _elements.size() / 2;
-	_elements.insert(middle, item);
+	auto lock = lockExclusive(_mutex);
+	const size_t middle = _elements.size() / 2;
+	_elements.insert(_elements.begin() + middle, item);
+	spliceTessellations(middle, 0, 1);
 	is_valid_dirty_ = true;
+	++_revision;
 }
 
 // A Contour is valid if the distance between all internal consecutive 2D points are less than EPS.
@@ -99,43 +122,75 @@ void Contour::addItemToCenter(const ContourElement& item)
 bool Contour::isValid() const
 {
 	{
-		std::shared_lock read_lock(_mutex);
+		auto read_lock = lockShared(_mutex);
 		if (!is_valid_dirty_)
 		{
+			CONTOUR_STAT_ADD(ValidityCacheHits, 1);
 			return is_valid_cache_;
 		}
 	}
 	// Upgrade to write lock
-	std::unique_lock write_lock(_mutex);
+	auto write_lock = lockExclusive(_mutex);
 	if (!is_valid_dirty_)
 	{
+		CONTOUR_STAT_ADD(ValidityCacheHits, 1);
 		return is_valid_cache_;
 	}
+	CONTOUR_STAT_ADD(ValidityRecomputes, 1);
+	CONTOUR_STAT_TIMER(ValidityNanoseconds);
 	is_valid_cache_ = computeValidity();
 	is_valid_dirty_ = false;
 	return is_valid_cache_;
 }
 
+// A Contour is closed if it is valid and the end of the last element meets the start of the first.
+bool Contour::isClosed() const
+{
+	if (!isValid())
+	{
+		return false;
+	}
+
+	auto lock = lockShared(_mutex);
+	if (_elements.empty())
+	{
+		return false;
+	}
+	return asSegment(_elements.front()).startPoint().isCloseTo(asSegment(_elements.back()).endPoint(), EPS);
+}
+
+uint64_t Contour::revision() const
+{
+	auto lock = lockShared(_mutex);
+	return _revision;
+}
+
 std::vector<ContourElement> Contour::getElements() const
 {
-	std::shared_lock lock(_mutex);
-	return _elements;
+	auto lock = lockShared(_mutex);
+	CONTOUR_STAT_ADD(ElementVectorCopies, 1);
+	CONTOUR_STAT_ADD(ElementsCopied, _elements.size());
+	return std::vector<ContourElement>(_elements.begin(), _elements.end());
 }
 
 void Contour::clear()
 {
-	std::unique_lock lock(_mutex);
+	auto lock = lockExclusive(_mutex);
+	spliceTessellations(0, _elements.size(), 0);
 	_elements.clear();
 	is_valid_dirty_ = true;
+	++_revision;
 }
 
 void Contour::clearAtIndex(int index)
 {
-	std::unique_lock lock(_mutex);
+	auto lock = lockExclusive(_mutex);
 	if (index >= 0 && index < static_cast<int>(_elements.size()))
 	{
 		_elements.erase(_elements.begin() + index);
+		spliceTessellations(index, 1, 0);
 		is_valid_dirty_ = true;
+		++_revision;
 	}
 	else
 	{
@@ -143,20 +198,300 @@ void Contour::clearAtIndex(int index)
 	}
 }
 
+void Contour::addItems(const std::vector<ContourElement>& items)
+{
+	auto lock = lockExclusive(_mutex);
+	spliceTessellations(_elements.size(), 0, items.size());
+	_elements.insert(_elements.end(), items.begin(), items.end());
+	is_valid_dirty_ = true;
+	++_revision;
+}
+
+void Contour::insertItems(size_t index, const std::vector<ContourElement>& items)
+{
+	auto lock = lockExclusive(_mutex);
+	if (index > _elements.size())
+	{
+		throw std::out_of_range("Index is out of bounds");
+	}
+	_elements.insert(_elements.begin() + index, items.begin(), items.end());
+	spliceTessellations(index, 0, items.size());
+	is_valid_dirty_ = true;
+	++_revision;
+}
+
+void Contour::eraseRange(size_t first, size_t last)
+{
+	auto lock = lockExclusive(_mutex);
+	if (first > last || last > _elements.size())
+	{
+		throw std::out_of_range("Index is out of bounds");
+	}
+	_elements.erase(_elements.begin() + first, _elements.begin() + last);
+	spliceTessellations(first, last - first, 0);
+	is_valid_dirty_ = true;
+	++_revision;
+}
+
+bool Contour::apply(const ContourEdit& edit)
+{
+	auto lock = lockExclusive(_mutex);
+
+	// Dry run on the size alone, so a bad index is reported before anything changes
+	size_t size = _elements.size();
+	for (const auto& op : edit._operations)
+	{
+		switch (op.kind)
+		{
+		case ContourEdit::Kind::Insert:
+			if (op.first > size) throw std::out_of_range("Index is out of bounds");
+			size += op.items.size();
+			break;
+		case ContourEdit::Kind::Append:
+			size += op.items.size();
+			break;
+		case ContourEdit::Kind::Replace:
+			if (op.first >= size) throw std::out_of_range("Index is out of bounds");
+			break;
+		case ContourEdit::Kind::Erase:
+			if (op.first > op.last || op.last > size) throw std::out_of_range("Index is out of bounds");
+			size -= op.last - op.first;
+			break;
+		case ContourEdit::Kind::Clear:
+			size = 0;
+			break;
+		}
+	}
+
+	for (const auto& op : edit._operations)
+	{
+		switch (op.kind)
+		{
+		case ContourEdit::Kind::Insert:
+			_elements.insert(_elements.begin() + op.first, op.items.begin(), op.items.end());
+			spliceTessellations(op.first, 0, op.items.size());
+			break;
+		case ContourEdit::Kind::Append:
+			spliceTessellations(_elements.size(), 0, op.items.size());
+			_elements.insert(_elements.end(), op.items.begin(), op.items.end());
+			break;
+		case ContourEdit::Kind::Replace:
+			_elements[op.first] = op.items.front();
+			spliceTessellations(op.first, 1, 1);
+			break;
+		case ContourEdit::Kind::Erase:
+			_elements.erase(_elements.begin() + op.first, _elements.begin() + op.last);
+			spliceTessellations(op.first, op.last - op.first, 0);
+			break;
+		case ContourEdit::Kind::Clear:
+			spliceTessellations(0, _elements.size(), 0);
+			_elements.clear();
+			break;
+		}
+	}
+
+	CONTOUR_STAT_ADD(ValidityRecomputes, 1);
+	CONTOUR_STAT_TIMER(ValidityNanoseconds);
+	is_valid_cache_ = computeValidity();
+	is_valid_dirty_ = false;
+	++_revision;
+	return is_valid_cache_;
+}
+
+ContourEdit& ContourEdit::insert(size_t index, ContourElement item)
+{
+	_operations.push_back({ Kind::Insert, index, index, { std::move(item) } });
+	return *this;
+}
+
+ContourEdit& ContourEdit::insert(size_t index, std::vector<ContourElement> items)
+{
+	_operations.push_back({ Kind::Insert, index, index, std::move(items) });
+	return *this;
+}
+
+ContourEdit& ContourEdit::append(ContourElement item)
+{
+	// Consecutive appends share one operation
+	if (!_operations.empty() && _operations.back().kind == Kind::Append)
+	{
+		_operations.back().items.push_back(std::move(item));
+		return *this;
+	}
+	_operations.push_back({ Kind::Append, 0, 0, { std::move(item) } });
+	return *this;
+}
+
+ContourEdit& ContourEdit::append(std::vector<ContourElement> items)
+{
+	_operations.push_back({ Kind::Append, 0, 0, std::move(items) });
+	return *this;
+}
+
+ContourEdit& ContourEdit::replace(size_t index, ContourElement item)
+{
+	_operations.push_back({ Kind::Replace, index, index + 1, { std::move(item) } });
+	return *this;
+}
+
+ContourEdit& ContourEdit::erase(size_t index)
+{
+	_operations.push_back({ Kind::Erase, index, index + 1, {} });
+	return *this;
+}
+
+ContourEdit& ContourEdit::erase(size_t first, size_t last)
+{
+	_operations.push_back({ Kind::Erase, first, last, {} });
+	return *this;
+}
+
+ContourEdit& ContourEdit::clear()
+{
+	_operations.push_back({ Kind::Clear, 0, 0, {} });
+	return *this;
+}
+
+namespace
+{
+	constexpr size_t TESSELLATION_CACHE_SLOTS = 4;
+}
+
+size_t arcStripSegments(const Arc& arc, const TessellationSettings& settings)
+{
+	if (settings.tolerance > 0)
+	{
+		if (arc.getRadius() <= settings.tolerance)
+		{
+			return 1;
+		}
+		const double step = 2 * std::acos(1 - settings.tolerance / arc.getRadius());
+		return std::max<size_t>(1, static_cast<size_t>(std::ceil(fabs(arc.getEndAngle() - arc.getStartAngle()) / step)));
+	}
+	return settings.arc_resolution > 0 ? settings.arc_resolution : arc.getResolution();
+}
+
+void appendLineStrip(const ContourElement& element, const TessellationSettings& settings, std::vector<Point2>& out)
+{
+	if (const Arc* arc = std::get_if<Arc>(&element))
+	{
+		// Same points as Arc::getLineStrip for the default settings
+		const size_t n = arcStripSegments(*arc, settings);
+		for (size_t i = 0; i <= n; ++i)
+		{
+			out.push_back(arc->getCoordinate(static_cast<double>(i) / n));
+		}
+		return;
+	}
+	std::vector<Point2> strip;
+	if (settings.tolerance > 0 && !std::holds_alternative<Line2>(element))
+	{
+		if (const CubicBezier* curve = std::get_if<CubicBezier>(&element)) strip = curve->getLineStrip(settings.tolerance);
+		else if (const BSpline* spline = std::get_if<BSpline>(&element)) strip = spline->getLineStrip(settings.tolerance);
+		else strip = std::get<Clothoid>(element).getLineStrip(settings.tolerance);
+	}
+	else
+	{
+		strip = std::visit([](const auto& seg) { return seg.getLineStrip(); }, element);
+	}
+	out.insert(out.end(), strip.begin(), strip.end());
+}
+
 // Please note, Line2 strip resolution only makes sense for non-Line2 objects.
 std::vector<Point2> Contour::getLineStrip() const
 {
-	std::vector<Point2> result;
-	std::shared_lock lock(_mutex);
-	for (const auto& e : _elements)
+	return tessellate()->points;
+}
+
+std::shared_ptr<const ContourTessellation> Contour::tessellate(const TessellationSettings& settings) const
+{
+	CONTOUR_STAT_ADD(TessellationCalls, 1);
 	{
-		std::visit([&](const auto& element)
+		auto read_lock = lockShared(_mutex);
+		for (const auto& cache : _tessellations)
 		{
-			auto poly = element.getLineStrip();
-			result.insert(result.end(), poly.begin(), poly.end());
-		}, e);
+			if (cache.settings == settings && !cache.dirty)
+			{
+				CONTOUR_STAT_ADD(TessellationCacheHits, 1);
+				return cache.strip;
+			}
+		}
+	}
+
+	auto write_lock = lockExclusive(_mutex);
+	auto cache = std::find_if(_tessellations.begin(), _tessellations.end(),
+		[&](const TessellationCache& c) { return c.settings == settings; });
+	if (cache == _tessellations.end())
+	{
+		if (_tessellations.size() >= TESSELLATION_CACHE_SLOTS)
+		{
+			_tessellations.erase(_tessellations.begin());
+		}
+		_tessellations.push_back(TessellationCache{ settings, nullptr, true, 0, _elements.size() });
+		cache = _tessellations.end() - 1;
+	}
+	else if (!cache->dirty)
+	{
+		CONTOUR_STAT_ADD(TessellationCacheHits, 1);
+		return cache->strip;
+	}
+
+	CONTOUR_STAT_TIMER(TessellationNanoseconds);
+	const size_t count = _elements.size();
+	const ContourTessellation* old = cache->strip.get();
+	const size_t old_count = old ? old->offsets.size() - 1 : 0;
+	const size_t first = old ? cache->dirty_first : 0;
+	const size_t last = old ? cache->dirty_last : count;
+	// Elements from last on only moved, they start at old_last in the old strip
+	const size_t old_last = last + old_count - count;
+
+	auto strip = std::make_shared<ContourTessellation>();
+	strip->offsets.reserve(count + 1);
+	if (old)
+	{
+		strip->points.reserve(old->points.size());
+		strip->points.assign(old->points.begin(), old->points.begin() + old->offsets[first]);
+		strip->offsets.assign(old->offsets.begin(), old->offsets.begin() + first);
+	}
+	size_t produced = strip->points.size();
+	for (size_t i = first; i < last; ++i)
+	{
+		strip->offsets.push_back(strip->points.size());
+		appendLineStrip(_elements[i], settings, strip->points);
+	}
+	produced = strip->points.size() - produced;
+	if (old)
+	{
+		const size_t shift = strip->points.size() - old->offsets[old_last];
+		for (size_t j = old_last; j < old_count; ++j)
+		{
+			strip->offsets.push_back(old->offsets[j] + shift);
+		}
+		strip->points.insert(strip->points.end(), old->points.begin() + old->offsets[old_last], old->points.end());
+	}
+	strip->offsets.push_back(strip->points.size());
+	CONTOUR_STAT_ADD(TessellatedPoints, produced);
+
+	cache->strip = std::move(strip);
+	cache->dirty = false;
+	return cache->strip;
+}
+
+void Contour::spliceTessellations(size_t first, size_t erased, size_t inserted)
+{
+	for (auto& cache : _tessellations)
+	{
+		if (!cache.dirty)
+		{
+			cache.dirty = true;
+			cache.dirty_first = first;
+			cache.dirty_last = first + inserted;
+			continue;
+		}
+		// Union with the range that is already stale, shifted past the splice
+		cache.dirty_first = std::min(cache.dirty_first, first);
+		cache.dirty_last = (cache.dirty_last >= first + erased) ? cache.dirty_last - erased + inserted : first + inserted;
 	}
-	return result;
 }
 
 
@@ -176,22 +511,17 @@ void Contour::exportContourToSVG(const std::string& filename) const
 	file << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"600\" height=\"600\" viewBox=\"-100 -100 600 600\">\n";
 	file << "<g fill=\"none\" stroke=\"black\" stroke-width=\"2\" stroke-Line2join=\"round\">\n";
 	double scale = 10;
-	const auto elements = this->getElements();
+	const auto strip = tessellate();
 	std::string pathData;
 
-	for (const auto& e : elements)
+	for (size_t e = 0; e + 1 < strip->offsets.size(); ++e)
 	{
-		std::vector<Point2> pts;
-		std::visit([&](const auto& element)
-		{
-			pts = element.getLineStrip();
-		}, e);
-
-		for (size_t j = 0; j < pts.size(); ++j)
+		for (size_t j = strip->offsets[e]; j < strip->offsets[e + 1]; ++j)
 		{
-			pathData += (j == 0 ? "M " : "L ") +
-				std::to_string(scale * pts[j].x) + " " +
-				std::to_string(scale * (1 - pts[j].y)) + " ";
+			const Point2& p = strip->points[j];
+			pathData += (j == strip->offsets[e] ? "M " : "L ") +
+				std::to_string(scale * p.x) + " " +
+				std::to_string(scale * (1 - p.y)) + " ";
 		}
 	}
 
@@ -201,7 +531,7 @@ void Contour::exportContourToSVG(const std::string& filename) const
 
 void Contour::print(const std::string& padding) const
 {
-	std::shared_lock lock(_mutex);
+	auto lock = lockShared(_mutex);
 	std::cout << padding << "Contour with " << _elements.size() << " segments:\n";
 
 	for (const auto& e : _elements)
@@ -217,21 +547,25 @@ bool Contour::computeValidity() const
 {
 	if (this->_elements.size() < 2) return true;
 
-	auto get_point = [](const auto& element, double t)
+	// Check if the distance between consecutive points is less than EPS. The end points are cached in the
+	// segments, they are packed a block at a time and compared by firstOpenJoint.
+	constexpr size_t BLOCK = 256;
+	double end_x[BLOCK], end_y[BLOCK], start_x[BLOCK], start_y[BLOCK];
+	auto next = _elements.begin();
+	auto current = next++;
+	while (next != _elements.end())
 	{
-		return std::visit([t](const auto& seg)
+		size_t count = 0;
+		for (; count < BLOCK && next != _elements.end(); ++count, current = next++)
 		{
-			return seg.getCoordinate(t);
-		}, element);
-	};
-
-	// Check if the distance between consecutive points is less than EPS
-	for (size_t i = 0; i < _elements.size() - 1; ++i)
-	{
-		Point2 end = get_point(_elements[i], 1.0);
-		Point2 start = get_point(_elements[i + 1], 0.0);
-
-		if (!start.isCloseTo(end, EPS))
+			const Point2& end = asSegment(*current).endPoint();
+			const Point2& start = asSegment(*next).startPoint();
+			end_x[count] = end.x;
+			end_y[count] = end.y;
+			start_x[count] = start.x;
+			start_y[count] = start.y;
+		}
+		if (firstOpenJoint(end_x, end_y, start_x, start_y, count, EPS) < count)
 		{
 			return false;
 		}
@@ -258,6 +592,87 @@ Contour contourFromPoints(const std::vector<Point2>& pts)
 	return c;
 }
 
+ContourElement reverseElement(const ContourElement& element)
+{
+	if (const Line2* line = std::get_if<Line2>(&element))
+	{
+		return line->reversed();
+	}
+	if (const Arc* arc = std::get_if<Arc>(&element))
+	{
+		// getCoordinate follows start_angle to end_angle whatever forwards says, so the angles swap as well
+		return Arc(arc->getCenter(), arc->getRadius(), arc->getEndAngle(), arc->getStartAngle(), arc->getResolution(), !arc->isForwards());
+	}
+	if (const CubicBezier* curve = std::get_if<CubicBezier>(&element))
+	{
+		return CubicBezier(curve->getEnd(), curve->getControl2(), curve->getControl1(), curve->getStart(), curve->flatness);
+	}
+	if (const BSpline* spline = std::get_if<BSpline>(&element))
+	{
+		// Mirrored knots u -> first + last - u
+		std::vector<Point2> points(spline->getControlPoints().rbegin(), spline->getControlPoints().rend());
+		const std::vector<double>& knots = spline->getKnots();
+		std::vector<double> mirrored(knots.size());
+		for (size_t i = 0; i < knots.size(); ++i)
+		{
+			mirrored[i] = knots.front() + knots.back() - knots[knots.size() - 1 - i];
+		}
+		return BSpline(std::move(points), std::move(mirrored), spline->getDegree(), spline->flatness);
+	}
+	const Clothoid& clothoid = std::get<Clothoid>(element);
+	return Clothoid(clothoid.getCoordinate(1.0), clothoid.getHeading(1.0) + PI, -clothoid.getCurvature(1.0),
+		clothoid.getSharpness(), clothoid.getLength(), clothoid.getFlatness());
+}
+
+double elementHeading(const ContourElement& element, double t)
+{
+	if (t < 0 || t > 1)
+	{
+		throw std::invalid_argument("argument is out of bounds");
+	}
+
+	Point2 direction{ 0.0, 0.0 };
+	if (const Line2* line = std::get_if<Line2>(&element))
+	{
+		const Point2 a = line->getCoordinate(0.0);
+		const Point2 b = line->getCoordinate(1.0);
+		direction = Point2({ b.x - a.x, b.y - a.y });
+	}
+	else if (const Arc* arc = std::get_if<Arc>(&element))
+	{
+		// The angle moves from start_angle to end_angle regardless of forwards, see Arc::getAngle
+		return arc->getAngle(t) + ((arc->getEndAngle() >= arc->getStartAngle()) ? 0.5 * PI : -0.5 * PI);
+	}
+	else if (const Clothoid* clothoid = std::get_if<Clothoid>(&element))
+	{
+		return clothoid->getHeading(t);
+	}
+	else if (const CubicBezier* curve = std::get_if<CubicBezier>(&element))
+	{
+		direction = curve->getDerivative(t);
+	}
+	else if (const BSpline* spline = std::get_if<BSpline>(&element))
+	{
+		direction = spline->getDerivative(t);
+	}
+
+	if (direction.x * direction.x + direction.y * direction.y < EPS * EPS)
+	{
+		// Coinciding control points stop the curve for an instant, the secant still has the right direction
+		const double h = 1E-6;
+		const Point2 a = std::visit([&](const auto& seg) { return seg.getCoordinate(std::max(t - h, 0.0)); }, element);
+		const Point2 b = std::visit([&](const auto& seg) { return seg.getCoordinate(std::min(t + h, 1.0)); }, element);
+		direction = Point2({ b.x - a.x, b.y - a.y });
+	}
+	return std::atan2(direction.y, direction.x);
+}
+
+Clothoid connectWithClothoid(const ContourElement& from, const ContourElement& to, double flatness)
+{
+	const Point2 start = std::visit([](const auto& seg) { return seg.getCoordinate(1.0); }, from);
+	const Point2 end = std::visit([](const auto& seg) { return seg.getCoordinate(0.0); }, to);
+	return Clothoid::fitG1(start, elementHeading(from, 1.0), end, elementHeading(to, 0.0), flatness);
+}
 
 // Brute force uniqueness check
 bool vectorContoursUniqueness(const std::vector<Contour>& contours)
@@ -0,0 +1,228 @@
+#include <Config.h>
+#include <ContourAssembly.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+	constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+	struct Cell {
+		int64_t x;
+		int64_t y;
+		bool operator==(const Cell& other) const { return x == other.x && y == other.y; }
+	};
+
+	// splitmix64 finalizer, spreads neighbouring cells over the table
+	uint64_t mix(uint64_t x)
+	{
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+	// Uniform grid over the end points with cells of twice the search radius, so a query touches at most 2 x 2 cells.
+	// Cells live in an open addressing table, each holds an intrusive list of points threaded through _next.
+	class EndpointGrid {
+	public:
+		EndpointGrid(const std::vector<Point2>& points, double radius)
+			: _radius(radius), _inverse(1.0 / (2 * radius)), _next(points.size(), NONE)
+		{
+			size_t capacity = 16;
+			while (capacity < 2 * points.size())
+			{
+				capacity *= 2;
+			}
+			_mask = capacity - 1;
+			_cells.resize(capacity);
+			_heads.assign(capacity, NONE);
+
+			for (uint32_t i = 0; i < points.size(); ++i)
+			{
+				const Cell cell = cellOf(points[i].x, points[i].y);
+				size_t slot = mix(hash(cell)) & _mask;
+				while (_heads[slot] != NONE && !(_cells[slot] == cell))
+				{
+					slot = (slot + 1) & _mask;
+				}
+				_cells[slot] = cell;
+				_next[i] = _heads[slot];
+				_heads[slot] = i;
+			}
+		}
+
+		template <typename Visitor>
+		void forEachNear(const Point2& point, Visitor&& visit) const
+		{
+			const Cell low = cellOf(point.x - _radius, point.y - _radius);
+			const Cell high = cellOf(point.x + _radius, point.y + _radius);
+			for (int64_t x = low.x; x <= high.x; ++x)
+			{
+				for (int64_t y = low.y; y <= high.y; ++y)
+				{
+					for (uint32_t i = find(Cell{ x, y }); i != NONE; i = _next[i])
+					{
+						visit(i);
+					}
+				}
+			}
+		}
+
+	private:
+		static uint64_t hash(const Cell& cell)
+		{
+			return static_cast<uint64_t>(cell.x) ^ mix(static_cast<uint64_t>(cell.y));
+		}
+
+		uint32_t find(const Cell& cell) const
+		{
+			for (size_t slot = mix(hash(cell)) & _mask; _heads[slot] != NONE; slot = (slot + 1) & _mask)
+			{
+				if (_cells[slot] == cell)
+				{
+					return _heads[slot];
+				}
+			}
+			return NONE;
+		}
+
+		Cell cellOf(double x, double y) const
+		{
+			constexpr double LIMIT = 4E18;
+			return Cell{ static_cast<int64_t>(std::floor(std::clamp(x * _inverse, -LIMIT, LIMIT))),
+				static_cast<int64_t>(std::floor(std::clamp(y * _inverse, -LIMIT, LIMIT))) };
+		}
+
+		double _radius;
+		double _inverse;
+		size_t _mask = 0;
+		std::vector<Cell> _cells;
+		std::vector<uint32_t> _heads;
+		std::vector<uint32_t> _next;
+	};
+}
+
+std::vector<Contour> assembleContours(const std::vector<ContourElement>& elements, double tolerance)
+{
+	if (tolerance <= 0)
+	{
+		throw std::invalid_argument("tolerance must be positive and non zero");
+	}
+	if (2 * elements.size() >= NONE)
+	{
+		throw std::invalid_argument("too many elements to assemble");
+	}
+
+	// End point 2 i is the start of element i, 2 i + 1 its end
+	std::vector<Point2> points(2 * elements.size());
+	for (size_t i = 0; i < elements.size(); ++i)
+	{
+		std::visit([&](const auto& seg)
+		{
+			points[2 * i] = seg.getCoordinate(0.0);
+			points[2 * i + 1] = seg.getCoordinate(1.0);
+		}, elements[i]);
+	}
+	const EndpointGrid grid(points, tolerance);
+	const double tolerance2 = tolerance * tolerance;
+	auto near = [&](const Point2& a, const Point2& b)
+	{
+		return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) <= tolerance2;
+	};
+
+	std::vector<char> used(elements.size(), 0);
+
+	// Closest end point of an unused element within tolerance
+	auto findUnused = [&](const Point2& point)
+	{
+		uint32_t best = NONE;
+		double best_distance = std::numeric_limits<double>::max();
+		grid.forEachNear(point, [&](uint32_t i)
+		{
+			if (used[i / 2])
+			{
+				return;
+			}
+			const double d = (points[i].x - point.x) * (points[i].x - point.x) + (points[i].y - point.y) * (points[i].y - point.y);
+			if (d <= tolerance2 && d < best_distance)
+			{
+				best_distance = d;
+				best = i;
+			}
+		});
+		return best;
+	};
+
+	std::vector<Contour> contours;
+	std::deque<ContourElement> chain;
+	auto walk = [&](uint32_t seed)
+	{
+		// Seed is the end point the chain starts from
+		const uint32_t element = seed / 2;
+		used[element] = 1;
+		const bool as_is = (seed % 2 == 0);
+		chain.clear();
+		chain.push_back(as_is ? elements[element] : reverseElement(elements[element]));
+		const Point2 first = points[seed];
+		Point2 end = points[seed ^ 1u];
+
+		while (!near(end, first))
+		{
+			const uint32_t i = findUnused(end);
+			if (i == NONE)
+			{
+				break;
+			}
+			used[i / 2] = 1;
+			chain.push_back((i % 2 == 0) ? elements[i / 2] : reverseElement(elements[i / 2]));
+			end = points[i ^ 1u];
+		}
+
+		// Grow backwards from the seed unless the chain closed
+		Point2 start = first;
+		while (!near(end, start))
+		{
+			const uint32_t i = findUnused(start);
+			if (i == NONE)
+			{
+				break;
+			}
+			used[i / 2] = 1;
+			chain.push_front((i % 2 == 1) ? elements[i / 2] : reverseElement(elements[i / 2]));
+			start = points[i ^ 1u];
+		}
+
+		Contour contour;
+		contour.addItems(std::vector<ContourElement>(chain.begin(), chain.end()));
+		contours.push_back(std::move(contour));
+	};
+
+	// Open chains first: an end point shared by an odd number of elements must end a chain
+	for (uint32_t i = 0; i < points.size(); ++i)
+	{
+		if (used[i / 2])
+		{
+			continue;
+		}
+		size_t cluster = 0;
+		grid.forEachNear(points[i], [&](uint32_t j) { cluster += near(points[i], points[j]) ? 1 : 0; });
+		if (cluster % 2 == 1)
+		{
+			walk(i);
+		}
+	}
+	// Everything left forms closed loops
+	for (uint32_t i = 0; i < elements.size(); ++i)
+	{
+		if (!used[i])
+		{
+			walk(2 * i);
+		}
+	}
+	return contours;
+}
@@ -0,0 +1,298 @@
+#include <Config.h>
+#include <ContourDistance.h>
+#include <Parallel.h>
+#include <Predicates.h>
+
+#include <cmath>
+
+namespace
+{
+	constexpr size_t LEAF_SIZE = 4;
+
+	// Half open crossing rule of the ray from point towards +x with the straight piece a-b. The piece crosses the ray
+	// if point lies left of it going up or right of it going down, points on the piece do not count.
+	bool chordCrossesRay(const Point2& a, const Point2& b, const Point2& point)
+	{
+		if ((a.y > point.y) == (b.y > point.y))
+		{
+			return false;
+		}
+		const double side = orient2d(a, b, point);
+		return (b.y > a.y) ? side > 0 : side < 0;
+	}
+
+	bool crossesRay(const Line2& line, const Point2& point)
+	{
+		return chordCrossesRay(line.getCoordinate(0.0), line.getCoordinate(1.0), point);
+	}
+
+	// The arc and its chord enclose a circular segment. The ray crosses the arc an odd number of times
+	// exactly when it crosses the chord an odd number of times xor the point lies inside that segment.
+	bool crossesRay(const Arc& arc, const Point2& point)
+	{
+		const Point2 a = arc.getCoordinate(0.0);
+		const Point2 b = arc.getCoordinate(1.0);
+		bool crossing = chordCrossesRay(a, b, point);
+
+		if (circleSide(arc.getCenter(), arc.getRadius(), point) >= 0)
+		{
+			return crossing;
+		}
+
+		bool in_segment;
+		if (a.isCloseTo(b, EPS))
+		{
+			in_segment = true; // full circle, the segment is the whole disc
+		}
+		else
+		{
+			in_segment = (orient2d(a, b, point) > 0) == (orient2d(a, b, arc.getCoordinate(0.5)) > 0);
+		}
+		return crossing != in_segment;
+	}
+
+	// Curves count the crossings of their flattened strip, exact up to the flatness of the curve
+	template <typename Curve>
+	bool crossesRay(const Curve& curve, const Point2& point)
+	{
+		const BoundingBox box = curve.getBounds();
+		if (point.y < box.min.y || point.y > box.max.y || point.x > box.max.x)
+		{
+			return false;
+		}
+		const std::vector<Point2> strip = curve.getLineStrip();
+		bool crossing = false;
+		for (size_t i = 0; i + 1 < strip.size(); ++i)
+		{
+			crossing = crossing != chordCrossesRay(strip[i], strip[i + 1], point);
+		}
+		return crossing;
+	}
+
+	void evaluate(const ContourElement& element, size_t index, const Point2& point, ClosestPoint& best)
+	{
+		std::visit([&](const auto& seg)
+		{
+			const double t = seg.getClosestParameter(point);
+			const Point2 p = seg.getCoordinate(t);
+			const double dx = p.x - point.x;
+			const double dy = p.y - point.y;
+			const double d2 = dx * dx + dy * dy;
+			if (d2 < best.distance * best.distance)
+			{
+				best.point = p;
+				best.distance = std::sqrt(d2);
+				best.element_index = index;
+				best.t = t;
+			}
+		}, element);
+	}
+}
+
+ContourDistanceIndex::ContourDistanceIndex(const Contour& contour)
+	: _elements(contour.getElements())
+{
+	_closed = contour.isClosed();
+	_element_bounds.reserve(_elements.size());
+	for (const auto& e : _elements)
+	{
+		_element_bounds.emplace_back(std::visit([](const auto& seg) { return seg.getBounds(); }, e));
+	}
+	if (!_elements.empty())
+	{
+		_nodes.reserve(2 * (_elements.size() / LEAF_SIZE + 1));
+		build(0, _elements.size());
+	}
+}
+
+int ContourDistanceIndex::build(size_t first, size_t last)
+{
+	const int index = static_cast<int>(_nodes.size());
+	_nodes.push_back(Node{ BoundingBox(), first, last });
+
+	if (last - first <= LEAF_SIZE)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			_nodes[index].bounds.expand(_element_bounds[i]);
+		}
+		return index;
+	}
+
+	const size_t middle = first + (last - first) / 2;
+	const int left = build(first, middle);
+	const int right = build(middle, last);
+	_nodes[index].left = left;
+	_nodes[index].right = right;
+	_nodes[index].bounds = _nodes[left].bounds;
+	_nodes[index].bounds.expand(_nodes[right].bounds);
+	return index;
+}
+
+void ContourDistanceIndex::updateClosest(size_t index, const Point2& point, ClosestPoint& best) const
+{
+	evaluate(_elements[index], index, point, best);
+}
+
+bool ContourDistanceIndex::crossesRay(size_t index, const Point2& point) const
+{
+	return std::visit([&](const auto& seg) { return ::crossesRay(seg, point); }, _elements[index]);
+}
+
+ClosestPoint ContourDistanceIndex::closestPoint(const Point2& point, size_t hint) const
+{
+	ClosestPoint best;
+	if (_nodes.empty())
+	{
+		return best;
+	}
+
+	// Seeding with the hint gives a tight bound up front, nearby queries then touch very few nodes
+	if (hint < _elements.size())
+	{
+		updateClosest(hint, point, best);
+	}
+
+	int stack[128];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node& node = _nodes[stack[--top]];
+		if (node.bounds.distanceSquaredTo(point) >= best.distance * best.distance)
+		{
+			continue;
+		}
+		if (node.left < 0)
+		{
+			for (size_t i = node.first; i < node.last; ++i)
+			{
+				if (_element_bounds[i].distanceSquaredTo(point) < best.distance * best.distance)
+				{
+					updateClosest(i, point, best);
+				}
+			}
+			continue;
+		}
+
+		// Visit the nearer child first by pushing it last
+		const double dl = _nodes[node.left].bounds.distanceSquaredTo(point);
+		const double dr = _nodes[node.right].bounds.distanceSquaredTo(point);
+		stack[top++] = dl < dr ? node.right : node.left;
+		stack[top++] = dl < dr ? node.left : node.right;
+	}
+
+	best.signed_distance = best.distance;
+	if (_closed)
+	{
+		best.inside = contains(point);
+		if (best.inside)
+		{
+			best.signed_distance = -best.distance;
+		}
+	}
+	return best;
+}
+
+bool ContourDistanceIndex::contains(const Point2& point) const
+{
+	if (!_closed || _nodes.empty())
+	{
+		return false;
+	}
+
+	bool inside = false;
+	int stack[128];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node& node = _nodes[stack[--top]];
+		// Only elements reaching the ray can cross it or hold the point inside their circular segment
+		if (point.y < node.bounds.min.y || point.y > node.bounds.max.y || point.x > node.bounds.max.x)
+		{
+			continue;
+		}
+		if (node.left < 0)
+		{
+			for (size_t i = node.first; i < node.last; ++i)
+			{
+				if (crossesRay(i, point))
+				{
+					inside = !inside;
+				}
+			}
+			continue;
+		}
+		stack[top++] = node.left;
+		stack[top++] = node.right;
+	}
+	return inside;
+}
+
+std::vector<ClosestPoint> ContourDistanceIndex::closestPoints(const std::vector<Point2>& points, unsigned int num_threads) const
+{
+	std::vector<ClosestPoint> result(points.size());
+	parallelFor(points.size(), num_threads, [&](size_t first, size_t last)
+	{
+		size_t hint = 0;
+		for (size_t i = first; i < last; ++i)
+		{
+			result[i] = closestPoint(points[i], hint);
+			hint = result[i].element_index;
+		}
+	});
+	return result;
+}
+
+std::vector<double> ContourDistanceIndex::signedDistanceField(const DistanceFieldGrid& grid, unsigned int num_threads) const
+{
+	std::vector<double> field(grid.width * grid.height, std::numeric_limits<double>::infinity());
+	if (_nodes.empty())
+	{
+		return field;
+	}
+
+	parallelFor(grid.height, num_threads, [&](size_t first_row, size_t last_row)
+	{
+		size_t hint = 0;
+		for (size_t j = first_row; j < last_row; ++j)
+		{
+			for (size_t i = 0; i < grid.width; ++i)
+			{
+				const Point2 p({ grid.origin.x + i * grid.spacing, grid.origin.y + j * grid.spacing });
+				const ClosestPoint c = closestPoint(p, hint);
+				field[j * grid.width + i] = c.signed_distance;
+				hint = c.element_index;
+			}
+		}
+	});
+	return field;
+}
+
+ClosestPoint closestPoint(const Contour& contour, const Point2& point)
+{
+	const auto elements = contour.getElements();
+	ClosestPoint best;
+	for (size_t i = 0; i < elements.size(); ++i)
+	{
+		evaluate(elements[i], i, point, best);
+	}
+	best.signed_distance = best.distance;
+
+	if (!elements.empty() && contour.isClosed())
+	{
+		for (const auto& e : elements)
+		{
+			if (std::visit([&](const auto& seg) { return crossesRay(seg, point); }, e))
+			{
+				best.inside = !best.inside;
+			}
+		}
+		if (best.inside)
+		{
+			best.signed_distance = -best.distance;
+		}
+	}
+	return best;
+}
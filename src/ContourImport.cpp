@@ -0,0 +1,931 @@
+#include <Config.h>
+#include <ContourImport.h>
+#include <MappedFile.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+	constexpr size_t MIN_BYTES_PER_THREAD = size_t(1) << 16;
+
+	std::string_view trim(std::string_view text)
+	{
+		const size_t first = text.find_first_not_of(" \t\r");
+		if (first == std::string_view::npos)
+		{
+			return {};
+		}
+		return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+	}
+
+	double parseDouble(std::string_view text)
+	{
+		text = trim(text);
+		if (!text.empty() && text.front() == '+')
+		{
+			text.remove_prefix(1);
+		}
+		double value = 0.0;
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc() || end != text.data() + text.size())
+		{
+			throw std::invalid_argument("malformed number: " + std::string(text));
+		}
+		return value;
+	}
+
+	int parseInt(std::string_view text)
+	{
+		text = trim(text);
+		int value = 0;
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc() || end != text.data() + text.size())
+		{
+			throw std::invalid_argument("malformed group code: " + std::string(text));
+		}
+		return value;
+	}
+
+	// Line2 refuses end points closer than EPS in both coordinates
+	bool lineFits(const Point2& a, const Point2& b)
+	{
+		return fabs(a.x - b.x) >= EPS || fabs(a.y - b.y) >= EPS;
+	}
+
+	/* Collects the elements of one contour. Elements that start within snap of the end of the chain are made to meet
+	 * it exactly, by moving the end of a Line2 on either side or with a short Line2 between two curves, so contours
+	 * built from rounded Arc end points stay valid. */
+	class ChainBuilder {
+	public:
+		explicit ChainBuilder(double snap) : _snap(snap) {}
+
+		bool empty() const { return _elements.empty(); }
+
+		// Returns false and leaves the chain alone if element starts further than snap from its end
+		bool append(ContourElement element)
+		{
+			if (_elements.empty())
+			{
+				_elements.push_back(std::move(element));
+				return true;
+			}
+			const Point2 from = asSegment(_elements.back()).endPoint();
+			const Point2 to = asSegment(element).startPoint();
+			if (to.isCloseTo(from, EPS))
+			{
+				_elements.push_back(std::move(element));
+				return true;
+			}
+			if (std::hypot(to.x - from.x, to.y - from.y) > _snap)
+			{
+				return false;
+			}
+			if (std::holds_alternative<Line2>(element))
+			{
+				const Point2 end = asSegment(element).endPoint();
+				if (lineFits(from, end))
+				{
+					_elements.push_back(Line2(from, end));
+				}
+				return true;
+			}
+			if (std::holds_alternative<Line2>(_elements.back()))
+			{
+				const Point2 start = asSegment(_elements.back()).startPoint();
+				_elements.pop_back();
+				if (lineFits(start, to))
+				{
+					_elements.push_back(Line2(start, to));
+				}
+				return append(std::move(element));
+			}
+			if (lineFits(from, to))
+			{
+				_elements.push_back(Line2(from, to));
+			}
+			_elements.push_back(std::move(element));
+			return true;
+		}
+
+		// Joins the end of the chain to its start
+		void close()
+		{
+			if (_elements.empty())
+			{
+				return;
+			}
+			const Point2 first = asSegment(_elements.front()).startPoint();
+			const Point2 last = asSegment(_elements.back()).endPoint();
+			if (first.isCloseTo(last, EPS))
+			{
+				return;
+			}
+			if (std::hypot(first.x - last.x, first.y - last.y) > _snap || _elements.size() < 2)
+			{
+				if (lineFits(last, first))
+				{
+					_elements.push_back(Line2(last, first));
+				}
+				return;
+			}
+			if (const Line2* line = std::get_if<Line2>(&_elements.back()); line && lineFits(line->startPoint(), first))
+			{
+				_elements.back() = Line2(line->startPoint(), first);
+			}
+			else if (const Line2* line = std::get_if<Line2>(&_elements.front()); line && lineFits(last, line->endPoint()))
+			{
+				_elements.front() = Line2(last, line->endPoint());
+			}
+			else if (lineFits(last, first))
+			{
+				_elements.push_back(Line2(last, first));
+			}
+		}
+
+		Contour take()
+		{
+			Contour contour;
+			contour.addItems(_elements);
+			_elements.clear();
+			return contour;
+		}
+
+	private:
+		double _snap;
+		std::vector<ContourElement> _elements;
+	};
+
+	// Start of the next line at or after position
+	size_t lineStart(std::string_view text, size_t position)
+	{
+		if (position == 0 || position >= text.size() || text[position - 1] == '\n')
+		{
+			return std::min(position, text.size());
+		}
+		const size_t eol = text.find('\n', position);
+		return eol == std::string_view::npos ? text.size() : eol + 1;
+	}
+
+	// Splits [first, last) into parts ranges that each start at a boundary found by next
+	template <typename Next>
+	std::vector<size_t> split(std::string_view text, size_t first, size_t last, size_t parts, Next next)
+	{
+		std::vector<size_t> cuts{ first };
+		for (size_t k = 1; k < parts; ++k)
+		{
+			const size_t cut = std::min(last, next(text, first + (last - first) * k / parts));
+			if (cut > cuts.back())
+			{
+				cuts.push_back(cut);
+			}
+		}
+		if (last > cuts.back())
+		{
+			cuts.push_back(last);
+		}
+		return cuts;
+	}
+
+	// Threads for a chunk, small inputs are parsed on the calling thread
+	size_t chunkThreads(const ImportOptions& options, size_t bytes)
+	{
+		return resolveThreadCount(options.num_threads, bytes / MIN_BYTES_PER_THREAD);
+	}
+
+	// DXF
+
+	// Line pairs of group code and value
+	class DxfPairs {
+	public:
+		explicit DxfPairs(std::string_view text) : _text(text) {}
+
+		bool next(int& code, std::string_view& value)
+		{
+			if (_position >= _text.size())
+			{
+				return false;
+			}
+			const std::string_view code_line = line();
+			if (trim(code_line).empty() && _position >= _text.size())
+			{
+				return false;
+			}
+			code = parseInt(code_line);
+			if (_position >= _text.size())
+			{
+				throw std::invalid_argument("DXF group code without a value");
+			}
+			value = trim(line());
+			return true;
+		}
+
+		size_t position() const { return _position; }
+
+	private:
+		std::string_view line()
+		{
+			const size_t eol = _text.find('\n', _position);
+			const size_t end = eol == std::string_view::npos ? _text.size() : eol;
+			const std::string_view result = _text.substr(_position, end - _position);
+			_position = end + 1;
+			return result;
+		}
+
+		std::string_view _text;
+		size_t _position = 0;
+	};
+
+	// Start of the next entity, a group code 0 line followed by an entity type, at or after position
+	size_t nextEntity(std::string_view text, size_t position)
+	{
+		for (size_t line = lineStart(text, position); line < text.size();)
+		{
+			const size_t eol = text.find('\n', line);
+			if (eol == std::string_view::npos)
+			{
+				break;
+			}
+			if (trim(text.substr(line, eol - line)) == "0")
+			{
+				const size_t end = std::min(text.find('\n', eol + 1), text.size());
+				const std::string_view type = trim(text.substr(eol + 1, end - eol - 1));
+				if (!type.empty() && type.front() >= 'A' && type.front() <= 'Z' &&
+					std::all_of(type.begin(), type.end(), [](char c) { return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'; }))
+				{
+					return line;
+				}
+			}
+			line = eol + 1;
+		}
+		return text.size();
+	}
+
+	// First entity of the ENTITIES section, the whole text if it has no sections, npos if there are no entities
+	size_t entitiesStart(std::string_view text)
+	{
+		DxfPairs pairs(text);
+		int code;
+		std::string_view value;
+		if (!pairs.next(code, value))
+		{
+			return std::string_view::npos;
+		}
+		if (code != 0 || value != "SECTION")
+		{
+			return 0;
+		}
+		bool section = true;
+		do
+		{
+			if (section && code == 2 && value == "ENTITIES")
+			{
+				return pairs.position();
+			}
+			section = code == 0 && value == "SECTION";
+		} while (pairs.next(code, value));
+		return std::string_view::npos;
+	}
+
+	struct DxfEntity {
+		enum class Kind { Piece, Contour, End };
+		Kind kind;
+		std::vector<ContourElement> elements; // one element for a Piece
+	};
+
+	// Arc from a to b whose included angle is 4 atan(bulge), counter clockwise for a positive bulge
+	Arc bulgeArc(const Point2& a, const Point2& b, double bulge, unsigned int resolution)
+	{
+		const double dx = b.x - a.x;
+		const double dy = b.y - a.y;
+		// The center lies on the left normal of the chord, (1 - bulge^2) / (4 bulge) chord lengths from its middle
+		const double k = (1 - bulge * bulge) / (4 * bulge);
+		const Point2 center({ (a.x + b.x) / 2 - dy * k, (a.y + b.y) / 2 + dx * k });
+		const double radius = std::hypot(dx, dy) * (1 + bulge * bulge) / (4 * fabs(bulge));
+		const double start = std::atan2(a.y - center.y, a.x - center.x);
+		return Arc(center, radius, start, start + 4 * std::atan(bulge), resolution);
+	}
+
+	class DxfEntityBuilder {
+	public:
+		explicit DxfEntityBuilder(const ImportOptions& options) : _options(options) {}
+
+		void begin(std::string_view type)
+		{
+			_type = type;
+			_x.assign(4, 0.0);
+			_radius = 0.0;
+			_start_angle = 0.0;
+			_end_angle = 0.0;
+			_flags = 0;
+			_vertices.clear();
+			_bulges.clear();
+		}
+
+		void field(int code, std::string_view value)
+		{
+			if (_type == "LWPOLYLINE")
+			{
+				switch (code)
+				{
+				case 10: _vertices.push_back(Point2({ parseDouble(value), 0.0 })); _bulges.push_back(0.0); break;
+				case 20: if (!_vertices.empty()) _vertices.back().y = parseDouble(value); break;
+				case 42: if (!_bulges.empty()) _bulges.back() = parseDouble(value); break;
+				case 70: _flags = parseInt(value); break;
+				default: break;
+				}
+				return;
+			}
+			switch (code)
+			{
+			case 10: _x[0] = parseDouble(value); break;
+			case 20: _x[1] = parseDouble(value); break;
+			case 11: _x[2] = parseDouble(value); break;
+			case 21: _x[3] = parseDouble(value); break;
+			case 40: _radius = parseDouble(value); break;
+			case 50: _start_angle = parseDouble(value); break;
+			case 51: _end_angle = parseDouble(value); break;
+			default: break;
+			}
+		}
+
+		void end(std::vector<DxfEntity>& out) const
+		{
+			const Point2 first({ _x[0], _x[1] });
+			if (_type == "LINE")
+			{
+				const Point2 second({ _x[2], _x[3] });
+				if (lineFits(first, second))
+				{
+					out.push_back(DxfEntity{ DxfEntity::Kind::Piece, { Line2(first, second) } });
+				}
+			}
+			else if (_type == "ARC")
+			{
+				// Degrees, counter clockwise from the start to the end angle
+				double sweep = _end_angle - _start_angle;
+				while (sweep <= 0) sweep += 360.0;
+				while (sweep > 360.0) sweep -= 360.0;
+				const double start = _start_angle * PI / 180.0;
+				out.push_back(DxfEntity{ DxfEntity::Kind::Piece,
+					{ Arc(first, _radius, start, start + sweep * PI / 180.0, _options.arc_resolution) } });
+			}
+			else if (_type == "CIRCLE")
+			{
+				out.push_back(DxfEntity{ DxfEntity::Kind::Contour, { Arc(first, _radius, 0.0, 2 * PI, _options.arc_resolution) } });
+			}
+			else if (_type == "LWPOLYLINE")
+			{
+				polyline(out);
+			}
+			else if (_type == "ENDSEC" || _type == "EOF")
+			{
+				out.push_back(DxfEntity{ DxfEntity::Kind::End, {} });
+			}
+		}
+
+	private:
+		void polyline(std::vector<DxfEntity>& out) const
+		{
+			const bool closed = (_flags & 1) != 0;
+			const size_t n = _vertices.size();
+			ChainBuilder chain(_options.snap_tolerance);
+			for (size_t i = 0; i + 1 < n || (closed && i < n && n > 1); ++i)
+			{
+				const Point2& a = _vertices[i];
+				const Point2& b = _vertices[(i + 1) % n];
+				if (!lineFits(a, b))
+				{
+					continue;
+				}
+				ContourElement element = (_bulges[i] != 0.0) ? ContourElement(bulgeArc(a, b, _bulges[i], _options.arc_resolution))
+					: ContourElement(Line2(a, b));
+				if (!chain.append(element))
+				{
+					throw std::invalid_argument("LWPOLYLINE segments do not meet");
+				}
+			}
+			if (closed)
+			{
+				chain.close();
+			}
+			if (!chain.empty())
+			{
+				out.push_back(DxfEntity{ DxfEntity::Kind::Contour, chain.take().getElements() });
+			}
+		}
+
+		const ImportOptions& _options;
+		std::string_view _type;
+		std::vector<double> _x;
+		double _radius = 0.0;
+		double _start_angle = 0.0;
+		double _end_angle = 0.0;
+		int _flags = 0;
+		std::vector<Point2> _vertices;
+		std::vector<double> _bulges;
+	};
+
+	// Entities of a range that starts at an entity boundary
+	std::vector<DxfEntity> parseEntities(std::string_view text, const ImportOptions& options)
+	{
+		std::vector<DxfEntity> entities;
+		DxfEntityBuilder builder(options);
+		DxfPairs pairs(text);
+		int code;
+		std::string_view value;
+		bool open = false;
+		while (pairs.next(code, value))
+		{
+			if (code == 0)
+			{
+				if (open)
+				{
+					builder.end(entities);
+					if (!entities.empty() && entities.back().kind == DxfEntity::Kind::End)
+					{
+						return entities;
+					}
+				}
+				builder.begin(value);
+				open = true;
+			}
+			else if (open)
+			{
+				builder.field(code, value);
+			}
+		}
+		if (open)
+		{
+			builder.end(entities);
+		}
+		return entities;
+	}
+
+	size_t importDXFText(std::string_view text, MappedFile* file, const ContourConsumer& consumer, const ImportOptions& options)
+	{
+		size_t position = entitiesStart(text);
+		if (position == std::string_view::npos)
+		{
+			return 0;
+		}
+		position = nextEntity(text, position);
+
+		size_t emitted = 0;
+		auto emit = [&](Contour&& contour)
+		{
+			consumer(std::move(contour));
+			++emitted;
+		};
+		ChainBuilder chain(options.snap_tolerance);
+		bool done = false;
+		while (!done && position < text.size())
+		{
+			const size_t end = nextEntity(text, std::min(text.size(), position + std::max<size_t>(options.chunk_size, 1)));
+			const size_t threads = chunkThreads(options, end - position);
+			const std::vector<size_t> cuts = split(text, position, end, threads, nextEntity);
+			std::vector<std::vector<DxfEntity>> parsed(cuts.size() - 1);
+			parallelFor(parsed.size(), static_cast<unsigned int>(threads), [&](size_t first, size_t last)
+			{
+				for (size_t k = first; k < last; ++k)
+				{
+					parsed[k] = parseEntities(text.substr(cuts[k], cuts[k + 1] - cuts[k]), options);
+				}
+			});
+
+			for (auto& entities : parsed)
+			{
+				for (auto& entity : entities)
+				{
+					if (entity.kind == DxfEntity::Kind::End)
+					{
+						done = true;
+						break;
+					}
+					if (entity.kind == DxfEntity::Kind::Piece && chain.append(entity.elements.front()))
+					{
+						continue;
+					}
+					if (!chain.empty())
+					{
+						emit(chain.take());
+					}
+					if (entity.kind == DxfEntity::Kind::Piece)
+					{
+						chain.append(std::move(entity.elements.front()));
+					}
+					else
+					{
+						Contour contour;
+						contour.addItems(entity.elements);
+						emit(std::move(contour));
+					}
+				}
+				if (done)
+				{
+					break;
+				}
+			}
+			if (file)
+			{
+				file->release(end);
+			}
+			position = end;
+		}
+		if (!chain.empty())
+		{
+			emit(chain.take());
+		}
+		return emitted;
+	}
+
+	// SVG
+
+	bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	// Start of the next <path element at or after position
+	size_t nextPath(std::string_view text, size_t position)
+	{
+		while (position < text.size())
+		{
+			const size_t found = text.find("<path", position);
+			if (found == std::string_view::npos || found + 5 >= text.size())
+			{
+				break;
+			}
+			const char c = text[found + 5];
+			if (isSpace(c) || c == '/' || c == '>')
+			{
+				return found;
+			}
+			position = found + 5;
+		}
+		return text.size();
+	}
+
+	// Value of the d attribute of the tag starting at position, empty if there is none
+	std::string_view pathData(std::string_view text, size_t position)
+	{
+		const size_t close = std::min(text.find('>', position), text.size());
+		const std::string_view tag = text.substr(position, close - position);
+		for (size_t at = tag.find('d'); at != std::string_view::npos; at = tag.find('d', at + 1))
+		{
+			if (at == 0 || !isSpace(tag[at - 1]))
+			{
+				continue;
+			}
+			size_t i = at + 1;
+			while (i < tag.size() && isSpace(tag[i])) ++i;
+			if (i >= tag.size() || tag[i] != '=')
+			{
+				continue;
+			}
+			++i;
+			while (i < tag.size() && isSpace(tag[i])) ++i;
+			if (i >= tag.size() || (tag[i] != '"' && tag[i] != '\''))
+			{
+				continue;
+			}
+			const size_t end = tag.find(tag[i], i + 1);
+			if (end == std::string_view::npos)
+			{
+				throw std::invalid_argument("unterminated path data");
+			}
+			return tag.substr(i + 1, end - i - 1);
+		}
+		return {};
+	}
+
+	class PathParser {
+	public:
+		PathParser(std::string_view data, const ImportOptions& options)
+			: _data(data), _options(options), _chain(options.snap_tolerance)
+		{
+		}
+
+		std::vector<Contour> parse()
+		{
+			char command = 0;
+			while (true)
+			{
+				skipSeparators();
+				if (_position >= _data.size())
+				{
+					break;
+				}
+				const char c = _data[_position];
+				if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))
+				{
+					command = c;
+					++_position;
+					if (command == 'Z' || command == 'z')
+					{
+						closePath();
+						continue;
+					}
+				}
+				else if (command == 0 || command == 'Z' || command == 'z')
+				{
+					throw std::invalid_argument("path data must start with a command");
+				}
+				command = segment(command);
+			}
+			flush();
+			return std::move(_contours);
+		}
+
+	private:
+		// One set of parameters, returns the command that implicitly follows
+		char segment(char command)
+		{
+			const bool relative = command >= 'a' && command <= 'z';
+			const Point2 base = relative ? _cursor : Point2({ 0.0, 0.0 });
+			switch (command)
+			{
+			case 'M':
+			case 'm':
+			{
+				flush();
+				_cursor = point(base);
+				_start = _cursor;
+				return relative ? 'l' : 'L';
+			}
+			case 'L':
+			case 'l':
+				lineTo(point(base));
+				break;
+			case 'H':
+			case 'h':
+				lineTo(Point2({ base.x + number(), _cursor.y }));
+				break;
+			case 'V':
+			case 'v':
+				lineTo(Point2({ _cursor.x, base.y + number() }));
+				break;
+			case 'C':
+			case 'c':
+			{
+				const Point2 c1 = point(base);
+				const Point2 c2 = point(base);
+				const Point2 end = point(base);
+				if (lineFits(_cursor, end) || lineFits(_cursor, c1) || lineFits(_cursor, c2))
+				{
+					add(CubicBezier(_cursor, c1, c2, end));
+				}
+				_cursor = end;
+				break;
+			}
+			case 'A':
+			case 'a':
+			{
+				const double rx = number();
+				const double ry = number();
+				const double rotation = number() * PI / 180.0;
+				const bool large = flag();
+				const bool sweep = flag();
+				arcTo(rx, ry, rotation, large, sweep, point(base));
+				break;
+			}
+			default:
+				throw std::invalid_argument(std::string("unsupported path command ") + command);
+			}
+			return command;
+		}
+
+		void lineTo(const Point2& to)
+		{
+			if (lineFits(_cursor, to))
+			{
+				add(Line2(_cursor, to));
+			}
+			_cursor = to;
+		}
+
+		// Endpoint to center conversion of the SVG specification (implementation notes, F.6.5)
+		void arcTo(double rx, double ry, double rotation, bool large, bool sweep, const Point2& to)
+		{
+			const Point2 from = _cursor;
+			rx = fabs(rx);
+			ry = fabs(ry);
+			if (!lineFits(from, to))
+			{
+				return;
+			}
+			if (rx == 0 || ry == 0)
+			{
+				lineTo(to);
+				return;
+			}
+			const double c = std::cos(rotation);
+			const double s = std::sin(rotation);
+			const double hx = (from.x - to.x) / 2;
+			const double hy = (from.y - to.y) / 2;
+			const double x1 = c * hx + s * hy;
+			const double y1 = -s * hx + c * hy;
+			const double lambda = x1 * x1 / (rx * rx) + y1 * y1 / (ry * ry);
+			if (lambda > 1)
+			{
+				rx *= std::sqrt(lambda);
+				ry *= std::sqrt(lambda);
+			}
+			const double numerator = rx * rx * ry * ry - rx * rx * y1 * y1 - ry * ry * x1 * x1;
+			const double denominator = rx * rx * y1 * y1 + ry * ry * x1 * x1;
+			const double coefficient = (large != sweep ? 1.0 : -1.0) * std::sqrt(std::max(0.0, numerator / denominator));
+			const double cx1 = coefficient * rx * y1 / ry;
+			const double cy1 = -coefficient * ry * x1 / rx;
+			const Point2 center({ c * cx1 - s * cy1 + (from.x + to.x) / 2, s * cx1 + c * cy1 + (from.y + to.y) / 2 });
+
+			const double ux = (x1 - cx1) / rx;
+			const double uy = (y1 - cy1) / ry;
+			const double vx = (-x1 - cx1) / rx;
+			const double vy = (-y1 - cy1) / ry;
+			const double theta = std::atan2(uy, ux);
+			double delta = std::atan2(ux * vy - uy * vx, ux * vx + uy * vy);
+			if (!sweep && delta > 0) delta -= 2 * PI;
+			if (sweep && delta < 0) delta += 2 * PI;
+
+			if (fabs(rx - ry) <= 1E-12 * std::max(rx, ry))
+			{
+				add(Arc(center, rx, theta + rotation, theta + rotation + delta, _options.arc_resolution));
+				_cursor = to;
+				return;
+			}
+			const size_t n = std::max<size_t>(1, static_cast<size_t>(std::ceil(fabs(delta) / (2 * PI) * _options.ellipse_segments)));
+			for (size_t i = 1; i < n; ++i)
+			{
+				const double angle = theta + delta * i / n;
+				lineTo(Point2({ center.x + rx * c * std::cos(angle) - ry * s * std::sin(angle),
+					center.y + rx * s * std::cos(angle) + ry * c * std::sin(angle) }));
+			}
+			lineTo(to);
+		}
+
+		void add(ContourElement element)
+		{
+			if (!_chain.append(element))
+			{
+				_contours.push_back(_chain.take());
+				_chain.append(std::move(element));
+			}
+		}
+
+		void closePath()
+		{
+			lineTo(_start);
+			_chain.close();
+			flush();
+			_cursor = _start;
+		}
+
+		void flush()
+		{
+			if (!_chain.empty())
+			{
+				_contours.push_back(_chain.take());
+			}
+		}
+
+		void skipSeparators()
+		{
+			while (_position < _data.size() && (isSpace(_data[_position]) || _data[_position] == ','))
+			{
+				++_position;
+			}
+		}
+
+		double number()
+		{
+			skipSeparators();
+			size_t position = _position;
+			if (position < _data.size() && _data[position] == '+')
+			{
+				++position;
+			}
+			double value = 0.0;
+			const auto [end, error] = std::from_chars(_data.data() + position, _data.data() + _data.size(), value);
+			if (error != std::errc())
+			{
+				throw std::invalid_argument("malformed path data at offset " + std::to_string(_position));
+			}
+			_position = static_cast<size_t>(end - _data.data());
+			return value;
+		}
+
+		Point2 point(const Point2& base)
+		{
+			const double x = number();
+			const double y = number();
+			return Point2({ base.x + x, base.y + y });
+		}
+
+		// Arc flags may be written without separators, "a1 1 0 01 1 1"
+		bool flag()
+		{
+			skipSeparators();
+			if (_position >= _data.size() || (_data[_position] != '0' && _data[_position] != '1'))
+			{
+				throw std::invalid_argument("malformed arc flag at offset " + std::to_string(_position));
+			}
+			return _data[_position++] == '1';
+		}
+
+		std::string_view _data;
+		const ImportOptions& _options;
+		size_t _position = 0;
+		Point2 _cursor{ 0.0, 0.0 };
+		Point2 _start{ 0.0, 0.0 };
+		ChainBuilder _chain;
+		std::vector<Contour> _contours;
+	};
+
+	// Contours of every <path starting in [first, last)
+	std::vector<Contour> parsePaths(std::string_view text, size_t first, size_t last, const ImportOptions& options)
+	{
+		std::vector<Contour> contours;
+		for (size_t at = nextPath(text, first); at < last; at = nextPath(text, at + 5))
+		{
+			auto path = PathParser(pathData(text, at), options).parse();
+			std::move(path.begin(), path.end(), std::back_inserter(contours));
+		}
+		return contours;
+	}
+
+	size_t importSVGText(std::string_view text, MappedFile* file, const ContourConsumer& consumer, const ImportOptions& options)
+	{
+		size_t emitted = 0;
+		size_t position = nextPath(text, 0);
+		while (position < text.size())
+		{
+			const size_t end = nextPath(text, std::min(text.size(), position + std::max<size_t>(options.chunk_size, 1)));
+			const size_t threads = chunkThreads(options, end - position);
+			const std::vector<size_t> cuts = split(text, position, end, threads, nextPath);
+			std::vector<std::vector<Contour>> parsed(cuts.size() - 1);
+			parallelFor(parsed.size(), static_cast<unsigned int>(threads), [&](size_t first, size_t last)
+			{
+				for (size_t k = first; k < last; ++k)
+				{
+					parsed[k] = parsePaths(text, cuts[k], cuts[k + 1], options);
+				}
+			});
+			for (auto& contours : parsed)
+			{
+				for (auto& contour : contours)
+				{
+					consumer(std::move(contour));
+					++emitted;
+				}
+			}
+			if (file)
+			{
+				file->release(end);
+			}
+			position = end;
+		}
+		return emitted;
+	}
+
+	std::vector<Contour> collect(const std::function<size_t(const ContourConsumer&)>& import)
+	{
+		std::vector<Contour> contours;
+		import([&](Contour&& contour) { contours.push_back(std::move(contour)); });
+		return contours;
+	}
+}
+
+size_t importDXF(const std::string& filename, const ContourConsumer& consumer, const ImportOptions& options)
+{
+	MappedFile file(filename);
+	return importDXFText(file.view(), &file, consumer, options);
+}
+
+std::vector<Contour> importDXF(const std::string& filename, const ImportOptions& options)
+{
+	return collect([&](const ContourConsumer& consumer) { return importDXF(filename, consumer, options); });
+}
+
+std::vector<Contour> parseDXF(std::string_view text, const ImportOptions& options)
+{
+	return collect([&](const ContourConsumer& consumer) { return importDXFText(text, nullptr, consumer, options); });
+}
+
+size_t importSVG(const std::string& filename, const ContourConsumer& consumer, const ImportOptions& options)
+{
+	MappedFile file(filename);
+	return importSVGText(file.view(), &file, consumer, options);
+}
+
+std::vector<Contour> importSVG(const std::string& filename, const ImportOptions& options)
+{
+	return collect([&](const ContourConsumer& consumer) { return importSVG(filename, consumer, options); });
+}
+
+std::vector<Contour> parseSVGPath(std::string_view path_data, const ImportOptions& options)
+{
+	return PathParser(path_data, options).parse();
+}
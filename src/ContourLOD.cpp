@@ -0,0 +1,285 @@
+#include <Config.h>
+#include <ContourLOD.h>
+
+#include <cmath>
+
+namespace
+{
+	double distanceToSegmentSquared(const Point2& p, const Point2& a, const Point2& b)
+	{
+		const double dx = b.x - a.x;
+		const double dy = b.y - a.y;
+		const double len2 = dx * dx + dy * dy;
+		double t = len2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0.0;
+		t = std::clamp(t, 0.0, 1.0);
+		const double ex = a.x + t * dx - p.x;
+		const double ey = a.y + t * dy - p.y;
+		return ex * ex + ey * ey;
+	}
+
+	// Points of an element in the direction of getCoordinate, and the distance between the chords and the element
+	double elementPoints(const ContourElement& element, std::vector<Point2>& out)
+	{
+		if (const Arc* arc = std::get_if<Arc>(&element))
+		{
+			const auto strip = arc->getLineStrip();
+			out.insert(out.end(), strip.begin(), strip.end());
+			const double step = fabs(arc->getEndAngle() - arc->getStartAngle()) / arc->getResolution();
+			return arc->getRadius() * (1 - std::cos(step / 2)); // sagitta of one chord
+		}
+		if (const CubicBezier* curve = std::get_if<CubicBezier>(&element))
+		{
+			const auto strip = curve->getLineStrip();
+			out.insert(out.end(), strip.begin(), strip.end());
+			return curve->flatness;
+		}
+		if (const BSpline* spline = std::get_if<BSpline>(&element))
+		{
+			const auto strip = spline->getLineStrip();
+			out.insert(out.end(), strip.begin(), strip.end());
+			return spline->flatness;
+		}
+		if (const Clothoid* clothoid = std::get_if<Clothoid>(&element))
+		{
+			const auto strip = clothoid->getLineStrip();
+			out.insert(out.end(), strip.begin(), strip.end());
+			return clothoid->getFlatness();
+		}
+		std::visit([&](const auto& seg)
+		{
+			out.push_back(seg.getCoordinate(0.0));
+			out.push_back(seg.getCoordinate(1.0));
+		}, element);
+		return 0.0;
+	}
+}
+
+std::vector<Point2> simplifyPolyline(const std::vector<Point2>& points, double tolerance)
+{
+	if (points.size() <= 2)
+	{
+		return points;
+	}
+
+	std::vector<char> keep(points.size(), 0);
+	keep.front() = 1;
+	keep.back() = 1;
+	const double tolerance2 = tolerance * tolerance;
+
+	// Explicit stack, deep recursion on long strips would overflow
+	std::vector<std::pair<size_t, size_t>> stack;
+	stack.emplace_back(0, points.size() - 1);
+	while (!stack.empty())
+	{
+		const auto [first, last] = stack.back();
+		stack.pop_back();
+
+		double worst = 0.0;
+		size_t worst_index = first;
+		for (size_t i = first + 1; i < last; ++i)
+		{
+			const double d = distanceToSegmentSquared(points[i], points[first], points[last]);
+			if (d > worst)
+			{
+				worst = d;
+				worst_index = i;
+			}
+		}
+		if (worst > tolerance2)
+		{
+			keep[worst_index] = 1;
+			stack.emplace_back(first, worst_index);
+			stack.emplace_back(worst_index, last);
+		}
+	}
+
+	std::vector<Point2> result;
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		if (keep[i])
+		{
+			result.push_back(points[i]);
+		}
+	}
+	return result;
+}
+
+ContourLOD::ContourLOD(const Contour& contour, double base_tolerance, size_t max_levels)
+	: _contour(contour), _base_tolerance(base_tolerance), _max_levels(std::max<size_t>(1, max_levels))
+{
+	update();
+}
+
+ContourLOD::~ContourLOD()
+{
+	{
+		std::lock_guard lock(_mutex);
+		_stopping = true;
+	}
+	wait();
+}
+
+std::shared_ptr<const ContourLOD::Pyramid> ContourLOD::build(std::vector<ContourElement> elements, uint64_t revision,
+	double base_tolerance, size_t max_levels)
+{
+	auto pyramid = std::make_shared<Pyramid>();
+	pyramid->revision = revision;
+
+	// Level 0, consecutive elements that meet share their joint point
+	LODLevel base;
+	std::vector<Point2> pts;
+	BoundingBox bounds;
+	for (const auto& e : elements)
+	{
+		pts.clear();
+		base.max_error = std::max(base.max_error, elementPoints(e, pts));
+		if (base.points.empty() || !pts.front().isCloseTo(base.points.back(), EPS))
+		{
+			base.run_offsets.push_back(base.points.size());
+			base.points.push_back(pts.front());
+		}
+		base.points.insert(base.points.end(), pts.begin() + 1, pts.end());
+		bounds.expand(std::visit([](const auto& seg) { return seg.getBounds(); }, e));
+	}
+
+	if (base_tolerance <= 0.0)
+	{
+		const double diagonal = bounds.isEmpty() ? 0.0 : std::hypot(bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y);
+		base_tolerance = std::max(diagonal * 1E-6, 1E-12);
+	}
+	pyramid->base_tolerance = base_tolerance;
+	pyramid->levels.push_back(std::move(base));
+
+	// Simplifying level k - 1 with base * 2^(k - 1) keeps the error of level k below e0 + base * (2^k - 1)
+	double step = base_tolerance;
+	while (pyramid->levels.size() < max_levels)
+	{
+		const LODLevel& previous = pyramid->levels.back();
+		LODLevel next;
+		next.max_error = previous.max_error + step;
+		for (size_t r = 0; r < previous.run_offsets.size(); ++r)
+		{
+			const size_t first = previous.run_offsets[r];
+			const size_t last = (r + 1 < previous.run_offsets.size()) ? previous.run_offsets[r + 1] : previous.points.size();
+			const std::vector<Point2> run(previous.points.begin() + first, previous.points.begin() + last);
+			const auto simplified = simplifyPolyline(run, step);
+			next.run_offsets.push_back(next.points.size());
+			next.points.insert(next.points.end(), simplified.begin(), simplified.end());
+		}
+
+		const bool exhausted = next.points.size() == 2 * next.run_offsets.size();
+		pyramid->levels.push_back(std::move(next));
+		if (exhausted)
+		{
+			break; // every run is a single line, coarser levels would be identical
+		}
+		step *= 2;
+	}
+	return pyramid;
+}
+
+bool ContourLOD::update()
+{
+	std::lock_guard lock(_mutex);
+	// A running rebuild starts the next one itself if the contour changed meanwhile
+	if (_building || (_pyramid && _pyramid->revision == _contour.revision()))
+	{
+		return false;
+	}
+	_building = true;
+	_pending = std::async(std::launch::async, [this]() { rebuild(); });
+	return true;
+}
+
+// Worker of update(), takes its own snapshot so callers never copy the elements
+void ContourLOD::rebuild()
+{
+	for (;;)
+	{
+		// Revision before the elements: an edit in between leaves the pyramid stale instead of hiding the edit
+		const uint64_t revision = _contour.revision();
+		auto pyramid = build(_contour.getElements(), revision, _base_tolerance, _max_levels);
+		std::lock_guard publish(_mutex);
+		_pyramid = std::move(pyramid);
+		if (_stopping || _contour.revision() == revision)
+		{
+			_building = false;
+			return;
+		}
+	}
+}
+
+void ContourLOD::wait()
+{
+	std::future<void> pending;
+	{
+		std::lock_guard lock(_mutex);
+		if (!_pending.valid())
+		{
+			return;
+		}
+		pending = std::move(_pending);
+	}
+	pending.wait();
+}
+
+bool ContourLOD::isReady() const
+{
+	std::lock_guard lock(_mutex);
+	return _pyramid != nullptr;
+}
+
+bool ContourLOD::isStale() const
+{
+	std::lock_guard lock(_mutex);
+	return !_pyramid || _pyramid->revision != _contour.revision();
+}
+
+size_t ContourLOD::levelCount() const
+{
+	std::lock_guard lock(_mutex);
+	return _pyramid ? _pyramid->levels.size() : 0;
+}
+
+std::shared_ptr<const LODLevel> ContourLOD::level(size_t index) const
+{
+	std::lock_guard lock(_mutex);
+	if (!_pyramid || index >= _pyramid->levels.size())
+	{
+		return nullptr;
+	}
+	// Aliasing pointer, keeps the whole pyramid alive while the level is in use
+	return std::shared_ptr<const LODLevel>(_pyramid, &_pyramid->levels[index]);
+}
+
+std::shared_ptr<const LODLevel> ContourLOD::select(double pixels_per_unit, double pixel_tolerance) const
+{
+	std::shared_ptr<const Pyramid> pyramid;
+	{
+		std::lock_guard lock(_mutex);
+		pyramid = _pyramid;
+	}
+	if (!pyramid)
+	{
+		return nullptr;
+	}
+
+	const auto& levels = pyramid->levels;
+	const double tolerance = pixel_tolerance / pixels_per_unit;
+	size_t k = 0;
+	if (tolerance > levels[0].max_error)
+	{
+		const double ratio = (tolerance - levels[0].max_error) / pyramid->base_tolerance + 1.0;
+		k = static_cast<size_t>(std::min<double>(static_cast<double>(levels.size() - 1), std::floor(std::log2(ratio))));
+	}
+	// The closed form can be off by one from rounding, each loop runs at most once
+	while (k > 0 && levels[k].max_error > tolerance)
+	{
+		--k;
+	}
+	while (k + 1 < levels.size() && levels[k + 1].max_error <= tolerance)
+	{
+		++k;
+	}
+	return std::shared_ptr<const LODLevel>(pyramid, &levels[k]);
+}
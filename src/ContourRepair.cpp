@@ -0,0 +1,235 @@
+#include <Config.h>
+#include <ContourRepair.h>
+#include <ContourSink.h>
+
+#include <cmath>
+#include <optional>
+
+namespace
+{
+	Point2 startOf(const ContourElement& element)
+	{
+		return std::visit([](const auto& seg) { return seg.getCoordinate(0.0); }, element);
+	}
+
+	Point2 endOf(const ContourElement& element)
+	{
+		return std::visit([](const auto& seg) { return seg.getCoordinate(1.0); }, element);
+	}
+
+	double distance(const Point2& a, const Point2& b)
+	{
+		return std::hypot(b.x - a.x, b.y - a.y);
+	}
+
+	double elementSize(const ContourElement& element)
+	{
+		if (const Line2* line = std::get_if<Line2>(&element))
+		{
+			return distance(line->getCoordinate(0.0), line->getCoordinate(1.0));
+		}
+		if (const Arc* arc = std::get_if<Arc>(&element))
+		{
+			return arc->getRadius() * fabs(arc->getEndAngle() - arc->getStartAngle());
+		}
+		const BoundingBox box = std::visit([](const auto& seg) { return seg.getBounds(); }, element);
+		return std::hypot(box.max.x - box.min.x, box.max.y - box.min.y);
+	}
+
+	// Copy of element with its start (at_start) or end moved to point, nullopt for rigid elements
+	std::optional<ContourElement> moveEnd(const ContourElement& element, bool at_start, const Point2& point)
+	{
+		try
+		{
+			if (const Line2* line = std::get_if<Line2>(&element))
+			{
+				return at_start ? Line2(point, line->getCoordinate(1.0)) : Line2(line->getCoordinate(0.0), point);
+			}
+			if (const CubicBezier* curve = std::get_if<CubicBezier>(&element))
+			{
+				// Moving the control point along keeps the end tangent
+				const Point2& end = at_start ? curve->getStart() : curve->getEnd();
+				const Point2& control = at_start ? curve->getControl1() : curve->getControl2();
+				const Point2 moved({ control.x + point.x - end.x, control.y + point.y - end.y });
+				if (at_start)
+				{
+					return CubicBezier(point, moved, curve->getControl2(), curve->getEnd(), curve->flatness);
+				}
+				return CubicBezier(curve->getStart(), curve->getControl1(), moved, point, curve->flatness);
+			}
+			if (const BSpline* spline = std::get_if<BSpline>(&element))
+			{
+				// Clamped, the curve ends in the first and last control points
+				std::vector<Point2> points = spline->getControlPoints();
+				(at_start ? points.front() : points.back()) = point;
+				return BSpline(std::move(points), spline->getKnots(), spline->getDegree(), spline->flatness);
+			}
+		}
+		catch (const std::invalid_argument&)
+		{
+			// The move collapsed the element, leave the joint open
+		}
+		return std::nullopt;
+	}
+
+	// Makes the end of a meet the start of b, returns false if both are rigid
+	bool snap(ContourElement& a, ContourElement& b)
+	{
+		const Point2 end = endOf(a);
+		const Point2 start = startOf(b);
+		const Point2 middle({ (end.x + start.x) / 2, (end.y + start.y) / 2 });
+
+		std::optional<ContourElement> moved_a = moveEnd(a, false, middle);
+		std::optional<ContourElement> moved_b = moveEnd(b, true, middle);
+		if (moved_a && moved_b)
+		{
+			a = std::move(*moved_a);
+			b = std::move(*moved_b);
+			return true;
+		}
+		if ((moved_b = moveEnd(b, true, end)))
+		{
+			b = std::move(*moved_b);
+			return true;
+		}
+		if ((moved_a = moveEnd(a, false, start)))
+		{
+			a = std::move(*moved_a);
+			return true;
+		}
+		return false;
+	}
+
+	// Arcs on the same circle turning the same way, where b continues a
+	bool mergeArcs(ContourElement& a, const ContourElement& b, double tolerance)
+	{
+		const Arc* first = std::get_if<Arc>(&a);
+		const Arc* second = std::get_if<Arc>(&b);
+		if (!first || !second ||
+			!first->getCenter().isCloseTo(second->getCenter(), tolerance) ||
+			fabs(first->getRadius() - second->getRadius()) > tolerance)
+		{
+			return false;
+		}
+		const double sweep_a = first->getEndAngle() - first->getStartAngle();
+		const double sweep_b = second->getEndAngle() - second->getStartAngle();
+		if ((sweep_a > 0) != (sweep_b > 0) || fabs(sweep_a + sweep_b) > 2 * PI ||
+			!endOf(a).isCloseTo(startOf(b), tolerance + first->getRadius() * 1E-12))
+		{
+			return false;
+		}
+		a = Arc(first->getCenter(), first->getRadius(), first->getStartAngle(), first->getStartAngle() + sweep_a + sweep_b,
+			first->getResolution() + second->getResolution(), first->isForwards());
+		return true;
+	}
+
+	class VectorSink : public ContourSink {
+	public:
+		explicit VectorSink(std::vector<ContourElement>& out)
+			: _out(out)
+		{
+		}
+
+		void push(const ContourElement& element) override
+		{
+			_out.push_back(element);
+		}
+
+	private:
+		std::vector<ContourElement>& _out;
+	};
+}
+
+Contour repairContour(const Contour& contour, const RepairOptions& options, RepairReport* report)
+{
+	RepairReport result;
+	const std::vector<ContourElement> input = contour.getElements();
+	result.input_elements = input.size();
+	const double degenerate = options.degenerate_length > 0 ? options.degenerate_length : options.snap_tolerance;
+
+	// Drop degenerate elements and merge co-circular arcs
+	std::vector<ContourElement> elements;
+	elements.reserve(input.size());
+	for (const auto& e : input)
+	{
+		if (elementSize(e) < degenerate)
+		{
+			++result.dropped_degenerate;
+			continue;
+		}
+		if (!elements.empty() && mergeArcs(elements.back(), e, options.arc_tolerance))
+		{
+			++result.merged_arcs;
+			continue;
+		}
+		elements.push_back(e);
+	}
+
+	// Snap joints, rigid pairs get a bridge
+	std::vector<ContourElement> snapped;
+	snapped.reserve(elements.size());
+	auto join = [&](ContourElement& a, ContourElement& b, std::vector<ContourElement>& bridges)
+	{
+		const double gap = distance(endOf(a), startOf(b));
+		if (gap < EPS)
+		{
+			return;
+		}
+		if (gap > options.snap_tolerance)
+		{
+			++result.open_gaps;
+			return;
+		}
+		if (snap(a, b))
+		{
+			++result.snapped_joints;
+			return;
+		}
+		try
+		{
+			bridges.push_back(Line2(endOf(a), startOf(b)));
+			++result.bridged_joints;
+		}
+		catch (const std::invalid_argument&)
+		{
+			++result.open_gaps;
+		}
+	};
+	for (size_t i = 0; i < elements.size(); ++i)
+	{
+		if (i > 0)
+		{
+			std::vector<ContourElement> bridge;
+			join(snapped.back(), elements[i], bridge);
+			snapped.insert(snapped.end(), bridge.begin(), bridge.end());
+		}
+		snapped.push_back(std::move(elements[i]));
+	}
+	if (options.close && snapped.size() > 1 && distance(endOf(snapped.back()), startOf(snapped.front())) <= options.snap_tolerance)
+	{
+		std::vector<ContourElement> bridge;
+		join(snapped.back(), snapped.front(), bridge);
+		snapped.insert(snapped.end(), bridge.begin(), bridge.end());
+	}
+
+	// Collinear Line2 runs, the simplifying sink only merges runs whose joints already meet
+	std::vector<ContourElement> merged;
+	merged.reserve(snapped.size());
+	VectorSink collector(merged);
+	SimplifyingSink simplify(collector, options.collinear_tolerance);
+	for (const auto& e : snapped)
+	{
+		simplify.push(e);
+	}
+	simplify.finish();
+	result.merged_lines = simplify.inputCount() - simplify.outputCount();
+
+	Contour repaired;
+	repaired.addItems(merged);
+	result.output_elements = merged.size();
+	if (report)
+	{
+		*report = result;
+	}
+	return repaired;
+}
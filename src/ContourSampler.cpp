@@ -0,0 +1,476 @@
+#include <Config.h>
+#include <ContourSampler.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+namespace
+{
+	double segmentDistance(const Point2& point, const Point2& a, const Point2& b)
+	{
+		const double abx = b.x - a.x;
+		const double aby = b.y - a.y;
+		const double length2 = abx * abx + aby * aby;
+		double t = 0.0;
+		if (length2 > 0)
+		{
+			t = std::clamp(((point.x - a.x) * abx + (point.y - a.y) * aby) / length2, 0.0, 1.0);
+		}
+		return std::hypot(point.x - a.x - t * abx, point.y - a.y - t * aby);
+	}
+
+	void checkOptions(double t0, double t1, const SamplerOptions& options)
+	{
+		if (!(t0 < t1))
+		{
+			throw std::invalid_argument("sampling needs t0 < t1");
+		}
+		if (!(options.tolerance > 0))
+		{
+			throw std::invalid_argument("tolerance must be positive");
+		}
+	}
+
+	struct Span { /*!< Parameter interval with the curve evaluated at both ends and the middle */
+		double a;
+		double b;
+		Point2 pa;
+		Point2 pm;
+		Point2 pb;
+	};
+
+	// Dormand-Prince 5(4) tableau (J. R. Dormand, P. J. Prince, A family of embedded Runge-Kutta formulae, 1980)
+	constexpr double C[7] = { 0.0, 1.0 / 5, 3.0 / 10, 4.0 / 5, 8.0 / 9, 1.0, 1.0 };
+	constexpr double A[7][6] = {
+		{},
+		{ 1.0 / 5 },
+		{ 3.0 / 40, 9.0 / 40 },
+		{ 44.0 / 45, -56.0 / 15, 32.0 / 9 },
+		{ 19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729 },
+		{ 9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656 },
+		{ 35.0 / 384, 0.0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84 },
+	};
+	// Fifth order weights minus the embedded fourth order ones, the last stage is f at the new state
+	constexpr double E[7] = { 71.0 / 57600, 0.0, -71.0 / 16695, 71.0 / 1920, -17253.0 / 339200, 22.0 / 525, -1.0 / 40 };
+
+	class DormandPrince { /*!< One trial step of the integrator, the last stage of an accepted step is the first of the next */
+	public:
+		DormandPrince(const OdeFunction& f, const OdeState& y0, double t0)
+			: _f(f), _stage(y0.size())
+		{
+			for (auto& k : _k)
+			{
+				k.resize(y0.size());
+			}
+			_f(t0, y0, _k[0]);
+		}
+
+		// Computes the state after h into y1 and returns the scaled error norm, at most 1 is acceptable
+		double step(double t, double h, const OdeState& y, double tolerance, OdeState& y1)
+		{
+			const size_t n = y.size();
+			for (size_t s = 1; s < 7; ++s)
+			{
+				OdeState& target = s < 6 ? _stage : y1;
+				for (size_t i = 0; i < n; ++i)
+				{
+					double sum = 0.0;
+					for (size_t j = 0; j < s; ++j)
+					{
+						sum += A[s][j] * _k[j][i];
+					}
+					target[i] = y[i] + h * sum;
+				}
+				_f(t + C[s] * h, target, _k[s]);
+			}
+
+			double error = 0.0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				double sum = 0.0;
+				for (size_t j = 0; j < 7; ++j)
+				{
+					sum += E[j] * _k[j][i];
+				}
+				const double scale = tolerance * (1.0 + std::max(fabs(y[i]), fabs(y1[i])));
+				error = std::max(error, fabs(h * sum) / scale);
+			}
+			return error;
+		}
+
+		void accept() { std::swap(_k[0], _k[6]); }
+
+		// Derivatives at the start and the end of the last trial step
+		const OdeState& startSlope() const { return _k[0]; }
+		const OdeState& endSlope() const { return _k[6]; }
+
+	private:
+		const OdeFunction& _f;
+		OdeState _k[7];
+		OdeState _stage;
+	};
+
+	// Cubic Hermite interpolant of a step of length h at theta in [0, 1]
+	void hermite(const OdeState& y0, const OdeState& y1, const OdeState& f0, const OdeState& f1, double h, double theta,
+		OdeState& out)
+	{
+		const double u = 1.0 - theta;
+		const double h00 = (1.0 + 2.0 * theta) * u * u;
+		const double h10 = theta * u * u * h;
+		const double h01 = theta * theta * (3.0 - 2.0 * theta);
+		const double h11 = -theta * theta * u * h;
+		for (size_t i = 0; i < y0.size(); ++i)
+		{
+			out[i] = h00 * y0[i] + h10 * f0[i] + h01 * y1[i] + h11 * f1[i];
+		}
+	}
+
+	class ElementFitter { /*!< Greedy fit of a polyline: from each anchor the longest Line2 and the longest Arc are
+		searched by doubling and bisecting the end point, the one reaching further is emitted */
+	public:
+		ElementFitter(const std::vector<Point2>& points, const SamplerOptions& options, ContourSink& out)
+			: _options(options), _tolerance(options.tolerance / 2), _out(out)
+		{
+			_points.reserve(points.size());
+			for (const auto& p : points)
+			{
+				if (_points.empty() || fabs(p.x - _points.back().x) >= EPS || fabs(p.y - _points.back().y) >= EPS)
+				{
+					_points.push_back(p);
+				}
+			}
+		}
+
+		void run()
+		{
+			if (_points.size() < 2)
+			{
+				return;
+			}
+			_anchor = _points[0];
+			_first = 0;
+			const size_t n = _points.size();
+			while (_first + 1 < n)
+			{
+				const size_t line_end = furthest(_first + 1, [this](size_t j) { return lineFits(j); });
+				size_t arc_end = 0;
+				if (_options.fit_arcs && _first + 2 < n)
+				{
+					arc_end = furthest(_first + 2, [this](size_t j) { return arcTo(j).has_value(); });
+				}
+
+				if (arc_end > line_end)
+				{
+					const Arc arc = *arcTo(arc_end);
+					// The pending Line2 ends exactly where the Arc starts, a few ulps from the sample
+					flushLine(arc.startPoint());
+					_out.push(arc);
+					_after_arc = true;
+					_anchor = arc.endPoint();
+					_first = arc_end;
+				}
+				else if (line_end > 0)
+				{
+					flushLine(_anchor);
+					_line_start = _anchor;
+					_after_arc = false;
+					_anchor = _points[line_end];
+					_first = line_end;
+				}
+				else
+				{
+					// The end of the last Arc is within EPS of the next point
+					++_first;
+				}
+			}
+			flushLine(_anchor);
+		}
+
+	private:
+		void flushLine(const Point2& end)
+		{
+			if (_line_start)
+			{
+				_out.push(Line2(*_line_start, end));
+				_line_start.reset();
+			}
+		}
+
+		// Largest j >= first with fits(j), 0 if first does not fit
+		template <typename Fits>
+		size_t furthest(size_t first, Fits fits) const
+		{
+			if (!fits(first))
+			{
+				return 0;
+			}
+			const size_t last = _points.size() - 1;
+			size_t good = first;
+			size_t bad = last + 1;
+			for (size_t step = 1; good < last; step *= 2)
+			{
+				const size_t next = std::min(last, good + step);
+				if (!fits(next))
+				{
+					bad = next;
+					break;
+				}
+				good = next;
+			}
+			while (bad - good > 1)
+			{
+				const size_t middle = good + (bad - good) / 2;
+				if (fits(middle))
+				{
+					good = middle;
+				}
+				else
+				{
+					bad = middle;
+				}
+			}
+			return good;
+		}
+
+		bool lineFits(size_t j) const
+		{
+			const Point2& b = _points[j];
+			if (fabs(b.x - _anchor.x) < EPS && fabs(b.y - _anchor.y) < EPS)
+			{
+				return false;
+			}
+			for (size_t k = _first + 1; k < j; ++k)
+			{
+				if (segmentDistance(_points[k], _anchor, b) > _tolerance)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Arc from the anchor through two samples at a third and two thirds of the way to point j, if every sample and
+		// chord midpoint is close to it. The third points keep the circle defined when point j closes a full turn.
+		std::optional<Arc> arcTo(size_t j) const
+		{
+			const size_t third = _first + std::max<size_t>(1, (j - _first) / 3);
+			const Point2& a = _anchor;
+			const Point2& m = _points[third];
+			const Point2& b = _points[std::max(third + 1, _first + 2 * (j - _first) / 3)];
+			const double mx = m.x - a.x;
+			const double my = m.y - a.y;
+			const double bx = b.x - a.x;
+			const double by = b.y - a.y;
+			const double m2 = mx * mx + my * my;
+			const double b2 = bx * bx + by * by;
+			const double d = 2.0 * (mx * by - my * bx);
+			if (fabs(d) <= 1E-12 * std::sqrt(m2 * b2))
+			{
+				return std::nullopt;
+			}
+			const Point2 center({ a.x + (by * m2 - my * b2) / d, a.y + (mx * b2 - bx * m2) / d });
+			const double radius = std::hypot(a.x - center.x, a.y - center.y);
+			// Beyond this the rounding of center + radius * (cos, sin) alone exceeds the tolerance
+			if (radius * 1E-10 > _tolerance)
+			{
+				return std::nullopt;
+			}
+
+			const double direction = d > 0 ? 1.0 : -1.0;
+			const double start = std::atan2(a.y - center.y, a.x - center.x);
+			double angle = start;
+			double sweep = 0.0;
+			Point2 previous = a;
+			for (size_t k = _first + 1; k <= j; ++k)
+			{
+				const Point2& p = _points[k];
+				const Point2 chord_middle({ 0.5 * (previous.x + p.x), 0.5 * (previous.y + p.y) });
+				if (fabs(std::hypot(p.x - center.x, p.y - center.y) - radius) > _tolerance ||
+					fabs(std::hypot(chord_middle.x - center.x, chord_middle.y - center.y) - radius) > _tolerance)
+				{
+					return std::nullopt;
+				}
+				const double next = std::atan2(p.y - center.y, p.x - center.x);
+				const double delta = std::remainder(next - angle, 2 * PI);
+				// Samples must run around the circle one way, in steps that leave no doubt about the direction
+				if (delta * direction <= 0 || fabs(delta) > 0.5 * PI)
+				{
+					return std::nullopt;
+				}
+				sweep += delta;
+				angle = next;
+				previous = p;
+			}
+			if (fabs(sweep) > 2 * PI + 1E-9)
+			{
+				return std::nullopt;
+			}
+			Arc arc(center, radius, start, start + std::clamp(sweep, -2 * PI, 2 * PI), _options.arc_resolution);
+			// Nothing can be stretched between two Arcs, the joint has to hold as computed
+			if (_after_arc && !arc.startPoint().isCloseTo(_anchor, EPS))
+			{
+				return std::nullopt;
+			}
+			return arc;
+		}
+
+		const SamplerOptions& _options;
+		double _tolerance;
+		ContourSink& _out;
+		std::vector<Point2> _points;
+		Point2 _anchor{ 0.0, 0.0 };
+		size_t _first = 0; // index of the sample the anchor stands for
+		std::optional<Point2> _line_start; // Line2 from here to the anchor, pushed once its end is final
+		bool _after_arc = false;
+	};
+}
+
+std::vector<Point2> sampleCurvePoints(const ParametricCurve& curve, double t0, double t1, const SamplerOptions& options)
+{
+	checkOptions(t0, t1, options);
+	const double tolerance = options.tolerance / 2;
+	const size_t spans = std::max<size_t>(1, options.initial_spans);
+
+	std::vector<Point2> points{ curve(t0) };
+	std::vector<Span> stack;
+	for (size_t s = 0; s < spans; ++s)
+	{
+		const double a = t0 + (t1 - t0) * s / spans;
+		const double b = s + 1 == spans ? t1 : t0 + (t1 - t0) * (s + 1) / spans;
+		stack.push_back(Span{ a, b, points.back(), curve(0.5 * (a + b)), curve(b) });
+		while (!stack.empty())
+		{
+			const Span span = stack.back();
+			stack.pop_back();
+			const double m = 0.5 * (span.a + span.b);
+			const Point2 q1 = curve(0.5 * (span.a + m));
+			const Point2 q3 = curve(0.5 * (m + span.b));
+			const double deviation = std::max({ segmentDistance(q1, span.pa, span.pb), segmentDistance(span.pm, span.pa, span.pb),
+				segmentDistance(q3, span.pa, span.pb) });
+			if (deviation > tolerance && span.b - span.a > options.min_step)
+			{
+				// Left half on top, samples come out in order
+				stack.push_back(Span{ m, span.b, span.pm, q3, span.pb });
+				stack.push_back(Span{ span.a, m, span.pa, q1, span.pm });
+			}
+			else
+			{
+				points.push_back(span.pb);
+			}
+		}
+	}
+	return points;
+}
+
+std::vector<Point2> sampleOdePoints(const OdeFunction& f, const OdeState& y0, double t0, double t1,
+	const SamplerOptions& options, const StateProjection& projection)
+{
+	checkOptions(t0, t1, options);
+	if (!projection && y0.size() < 2)
+	{
+		throw std::invalid_argument("the default projection needs at least two state components");
+	}
+	const auto project = [&](const OdeState& y)
+	{
+		return projection ? projection(y) : Point2({ y[0], y[1] });
+	};
+	const double tolerance = options.tolerance / 2;
+
+	DormandPrince integrator(f, y0, t0);
+	OdeState y = y0;
+	OdeState y1(y0.size());
+	OdeState between(y0.size());
+	std::vector<Point2> points{ project(y) };
+	double t = t0;
+	double h = (t1 - t0) / std::max<size_t>(1, options.initial_spans);
+	bool done = false;
+	while (!done)
+	{
+		const bool last = t + h >= t1;
+		if (last)
+		{
+			h = t1 - t;
+		}
+		const double error = integrator.step(t, h, y, options.integration_tolerance, y1);
+
+		// Chord error of the step, estimated from the cubic Hermite interpolant of the states and slopes at its ends
+		const Point2 p0 = points.back();
+		const Point2 p1 = project(y1);
+		double deviation = 0.0;
+		for (double theta : { 0.25, 0.5, 0.75 })
+		{
+			hermite(y, y1, integrator.startSlope(), integrator.endSlope(), h, theta, between);
+			deviation = std::max(deviation, segmentDistance(project(between), p0, p1));
+		}
+
+		const double error_factor = error > 0 ? 0.9 * std::pow(error, -0.2) : 5.0;
+		const double chord_factor = deviation > 0 ? 0.9 * std::sqrt(tolerance / deviation) : 5.0;
+		const double factor = std::clamp(std::min(error_factor, chord_factor), 0.2, 5.0);
+		if (error <= 1.0 && deviation <= tolerance)
+		{
+			t = last ? t1 : t + h;
+			done = last;
+			std::swap(y, y1);
+			integrator.accept();
+			points.push_back(p1);
+		}
+		else if (h <= options.min_step)
+		{
+			throw std::runtime_error("RK45 step fell below min_step");
+		}
+		h = std::max(h * factor, options.min_step);
+	}
+	return points;
+}
+
+void fitElements(const std::vector<Point2>& points, const SamplerOptions& options, ContourSink& out)
+{
+	ElementFitter(points, options, out).run();
+}
+
+void sampleCurve(const ParametricCurve& curve, double t0, double t1, ContourSink& out, const SamplerOptions& options)
+{
+	fitElements(sampleCurvePoints(curve, t0, t1, options), options, out);
+	out.finish();
+}
+
+Contour sampleCurve(const ParametricCurve& curve, double t0, double t1, const SamplerOptions& options)
+{
+	Contour contour;
+	ContourCollectorSink sink(contour);
+	sampleCurve(curve, t0, t1, sink, options);
+	return contour;
+}
+
+void sampleOde(const OdeFunction& f, const OdeState& y0, double t0, double t1, ContourSink& out,
+	const SamplerOptions& options, const StateProjection& projection)
+{
+	fitElements(sampleOdePoints(f, y0, t0, t1, options, projection), options, out);
+	out.finish();
+}
+
+Contour sampleOde(const OdeFunction& f, const OdeState& y0, double t0, double t1, const SamplerOptions& options,
+	const StateProjection& projection)
+{
+	Contour contour;
+	ContourCollectorSink sink(contour);
+	sampleOde(f, y0, t0, t1, sink, options, projection);
+	return contour;
+}
+
+std::vector<Contour> sampleOdes(const OdeFunction& f, const std::vector<OdeState>& initial_states, double t0, double t1,
+	const SamplerOptions& options, const StateProjection& projection)
+{
+	std::vector<Contour> contours(initial_states.size());
+	parallelFor(initial_states.size(), options.num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			contours[i] = sampleOde(f, initial_states[i], t0, t1, options, projection);
+		}
+	});
+	return contours;
+}
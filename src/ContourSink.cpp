@@ -0,0 +1,469 @@
+#include <Config.h>
+#include <ContourSink.h>
+
+#include <cstdint>
+#include <istream>
+
+namespace
+{
+	Point2 startOf(const ContourElement& element)
+	{
+		return std::visit([](const auto& seg) { return seg.getCoordinate(0.0); }, element);
+	}
+
+	Point2 endOf(const ContourElement& element)
+	{
+		return std::visit([](const auto& seg) { return seg.getCoordinate(1.0); }, element);
+	}
+
+	template <typename T>
+	void writeValue(std::ostream& out, T value)
+	{
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool readValue(std::istream& in, T& value)
+	{
+		return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	constexpr uint8_t TAG_LINE2 = 0;
+	constexpr uint8_t TAG_ARC = 1;
+	constexpr uint8_t TAG_CUBIC_BEZIER = 2;
+	constexpr uint8_t TAG_BSPLINE = 3;
+	constexpr uint8_t TAG_CLOTHOID = 4;
+
+	void writePoint(std::ostream& out, const Point2& p)
+	{
+		writeValue(out, p.x);
+		writeValue(out, p.y);
+	}
+
+	Point2 readPoint(std::istream& in, const char* record)
+	{
+		double x, y;
+		if (!readValue(in, x) || !readValue(in, y)) throw std::runtime_error(std::string("Truncated ") + record + " record.");
+		return Point2({ x, y });
+	}
+}
+
+PointSink::PointSink(ContourSink& next)
+	: _next(next)
+{
+}
+
+void PointSink::push(const Point2& point)
+{
+	if (_has_last && !point.isCloseTo(_last, EPS))
+	{
+		_next.push(Line2(_last, point));
+	}
+	if (!_has_last || !point.isCloseTo(_last, EPS))
+	{
+		_last = point;
+	}
+	_has_last = true;
+}
+
+void PointSink::finish()
+{
+	_has_last = false;
+	_next.finish();
+}
+
+ContourCollectorSink::ContourCollectorSink(Contour& contour)
+	: _contour(contour)
+{
+}
+
+void ContourCollectorSink::push(const ContourElement& element)
+{
+	_contour.addItem(element);
+}
+
+ValidatingSink::ValidatingSink(ContourSink& next, double tolerance, bool throw_on_gap)
+	: _next(next), _tolerance(tolerance), _throw_on_gap(throw_on_gap)
+{
+}
+
+void ValidatingSink::push(const ContourElement& element)
+{
+	if (_count > 0 && !startOf(element).isCloseTo(_last_end, _tolerance))
+	{
+		++_gaps;
+		if (_throw_on_gap)
+		{
+			throw std::runtime_error("Contour stream has a gap before element " + std::to_string(_count));
+		}
+	}
+	_last_end = endOf(element);
+	++_count;
+	_next.push(element);
+}
+
+void ValidatingSink::finish()
+{
+	_next.finish();
+}
+
+SimplifyingSink::SimplifyingSink(ContourSink& next, double tolerance)
+	: _next(next), _cone(tolerance)
+{
+	if (tolerance < 0)
+	{
+		throw std::invalid_argument("tolerance must be non negative");
+	}
+}
+
+void SimplifyingSink::push(const ContourElement& element)
+{
+	++_input;
+	const Line2* line = std::get_if<Line2>(&element);
+	if (!line)
+	{
+		flush();
+		emit(element);
+		return;
+	}
+
+	const Point2 start = line->getCoordinate(0.0);
+	const Point2 end = line->getCoordinate(1.0);
+	if (_run_length > 0 && start.isCloseTo(_end, EPS))
+	{
+		if (_cone.admits(end))
+		{
+			_cone.add(end);
+			_end = end;
+			++_run_length;
+			return;
+		}
+	}
+
+	flush();
+	_first = element;
+	_run_length = 1;
+	_anchor = start;
+	_end = end;
+	_cone.reset(start);
+	_cone.add(end);
+}
+
+void SimplifyingSink::flush()
+{
+	if (_run_length == 1)
+	{
+		emit(*_first);
+	}
+	else if (_run_length > 1)
+	{
+		emit(Line2(_anchor, _end));
+	}
+	_run_length = 0;
+	_first.reset();
+}
+
+void SimplifyingSink::emit(const ContourElement& element)
+{
+	++_output;
+	_next.push(element);
+}
+
+void SimplifyingSink::finish()
+{
+	flush();
+	_next.finish();
+}
+
+SvgSink::SvgSink(const std::string& filename, double scale)
+	: _file(filename), _scale(scale)
+{
+	if (!_file.is_open())
+	{
+		throw std::runtime_error("Failed to open file.");
+	}
+	_file << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"600\" height=\"600\" viewBox=\"-100 -100 600 600\">\n";
+	_file << "<g fill=\"none\" stroke=\"black\" stroke-width=\"2\" stroke-Line2join=\"round\">\n";
+	_file << "<path d=\"";
+}
+
+void SvgSink::push(const ContourElement& element)
+{
+	const std::vector<Point2> pts = std::visit([](const auto& seg) { return seg.getLineStrip(); }, element);
+	for (size_t j = 0; j < pts.size(); ++j)
+	{
+		// Joined elements continue the path, the shared point is written once
+		const bool joined = j == 0 && _started && pts[j].isCloseTo(_last, EPS);
+		if (!joined)
+		{
+			_file << ((j == 0) ? "M " : "L ") << std::to_string(_scale * pts[j].x) << " "
+				<< std::to_string(_scale * (1 - pts[j].y)) << " ";
+		}
+	}
+	if (!pts.empty())
+	{
+		_last = pts.back();
+		_started = true;
+	}
+}
+
+void SvgSink::finish()
+{
+	if (_finished)
+	{
+		return;
+	}
+	_finished = true;
+	_file << "\" />\n</g>\n</svg>\n";
+	_file.close();
+}
+
+BinarySink::BinarySink(std::ostream& out)
+	: _out(out)
+{
+}
+
+void BinarySink::push(const ContourElement& element)
+{
+	if (const Arc* arc = std::get_if<Arc>(&element))
+	{
+		writeValue(_out, TAG_ARC);
+		writeValue(_out, arc->getCenter().x);
+		writeValue(_out, arc->getCenter().y);
+		writeValue(_out, arc->getRadius());
+		writeValue(_out, arc->getStartAngle());
+		writeValue(_out, arc->getEndAngle());
+		writeValue(_out, static_cast<uint32_t>(arc->getResolution()));
+		writeValue(_out, static_cast<uint8_t>(arc->isForwards() ? 1 : 0));
+		return;
+	}
+	if (const CubicBezier* curve = std::get_if<CubicBezier>(&element))
+	{
+		writeValue(_out, TAG_CUBIC_BEZIER);
+		writePoint(_out, curve->getStart());
+		writePoint(_out, curve->getControl1());
+		writePoint(_out, curve->getControl2());
+		writePoint(_out, curve->getEnd());
+		writeValue(_out, curve->flatness);
+		return;
+	}
+	if (const BSpline* spline = std::get_if<BSpline>(&element))
+	{
+		writeValue(_out, TAG_BSPLINE);
+		writeValue(_out, static_cast<uint32_t>(spline->getDegree()));
+		writeValue(_out, static_cast<uint32_t>(spline->getControlPoints().size()));
+		for (const auto& p : spline->getControlPoints())
+		{
+			writePoint(_out, p);
+		}
+		for (double k : spline->getKnots())
+		{
+			writeValue(_out, k);
+		}
+		writeValue(_out, spline->flatness);
+		return;
+	}
+	if (const Clothoid* clothoid = std::get_if<Clothoid>(&element))
+	{
+		writeValue(_out, TAG_CLOTHOID);
+		writePoint(_out, clothoid->getStart());
+		writeValue(_out, clothoid->getHeading(0.0));
+		writeValue(_out, clothoid->getCurvature(0.0));
+		writeValue(_out, clothoid->getSharpness());
+		writeValue(_out, clothoid->getLength());
+		writeValue(_out, clothoid->getFlatness());
+		return;
+	}
+	const Point2 start = startOf(element);
+	const Point2 end = endOf(element);
+	writeValue(_out, TAG_LINE2);
+	writeValue(_out, start.x);
+	writeValue(_out, start.y);
+	writeValue(_out, end.x);
+	writeValue(_out, end.y);
+}
+
+void BinarySink::finish()
+{
+	_out.flush();
+}
+
+size_t readBinaryStream(std::istream& in, ContourSink& sink)
+{
+	size_t count = 0;
+	uint8_t tag;
+	while (readValue(in, tag))
+	{
+		if (tag == TAG_LINE2)
+		{
+			double v[4];
+			for (double& x : v)
+			{
+				if (!readValue(in, x)) throw std::runtime_error("Truncated Line2 record.");
+			}
+			sink.push(Line2(Point2({ v[0], v[1] }), Point2({ v[2], v[3] })));
+		}
+		else if (tag == TAG_ARC)
+		{
+			double v[5];
+			uint32_t resolution;
+			uint8_t forwards;
+			for (double& x : v)
+			{
+				if (!readValue(in, x)) throw std::runtime_error("Truncated Arc record.");
+			}
+			if (!readValue(in, resolution) || !readValue(in, forwards)) throw std::runtime_error("Truncated Arc record.");
+			sink.push(Arc(Point2({ v[0], v[1] }), v[2], v[3], v[4], resolution, forwards != 0));
+		}
+		else if (tag == TAG_CUBIC_BEZIER)
+		{
+			Point2 p[4];
+			for (Point2& x : p)
+			{
+				x = readPoint(in, "CubicBezier");
+			}
+			double flatness;
+			if (!readValue(in, flatness)) throw std::runtime_error("Truncated CubicBezier record.");
+			sink.push(CubicBezier(p[0], p[1], p[2], p[3], flatness));
+		}
+		else if (tag == TAG_BSPLINE)
+		{
+			uint32_t degree, count;
+			if (!readValue(in, degree) || !readValue(in, count)) throw std::runtime_error("Truncated BSpline record.");
+			std::vector<Point2> points(count);
+			for (Point2& x : points)
+			{
+				x = readPoint(in, "BSpline");
+			}
+			std::vector<double> knots(static_cast<size_t>(count) + degree + 1);
+			for (double& x : knots)
+			{
+				if (!readValue(in, x)) throw std::runtime_error("Truncated BSpline record.");
+			}
+			double flatness;
+			if (!readValue(in, flatness)) throw std::runtime_error("Truncated BSpline record.");
+			sink.push(BSpline(std::move(points), std::move(knots), degree, flatness));
+		}
+		else if (tag == TAG_CLOTHOID)
+		{
+			const Point2 start = readPoint(in, "Clothoid");
+			double v[5];
+			for (double& x : v)
+			{
+				if (!readValue(in, x)) throw std::runtime_error("Truncated Clothoid record.");
+			}
+			sink.push(Clothoid(start, v[0], v[1], v[2], v[3], v[4]));
+		}
+		else
+		{
+			throw std::runtime_error("Unknown element tag in binary stream.");
+		}
+		++count;
+	}
+	sink.finish();
+	return count;
+}
+
+ThreadedSink::ThreadedSink(ContourSink& next, size_t capacity, size_t batch_size)
+	: _next(next), _capacity(std::max<size_t>(1, capacity)), _batch_size(std::max<size_t>(1, batch_size))
+{
+	_batch.reserve(_batch_size);
+	_worker = std::thread(&ThreadedSink::run, this);
+}
+
+ThreadedSink::~ThreadedSink()
+{
+	{
+		std::lock_guard lock(_mutex);
+		_closed = true;
+	}
+	_not_empty.notify_all();
+	_not_full.notify_all();
+	if (_worker.joinable())
+	{
+		_worker.join();
+	}
+}
+
+void ThreadedSink::push(const ContourElement& element)
+{
+	_batch.push_back(element);
+	if (_batch.size() >= _batch_size)
+	{
+		enqueue(std::move(_batch));
+		_batch = std::vector<ContourElement>();
+		_batch.reserve(_batch_size);
+	}
+}
+
+void ThreadedSink::enqueue(std::vector<ContourElement>&& batch)
+{
+	std::unique_lock lock(_mutex);
+	_not_full.wait(lock, [this] { return _queue.size() < _capacity || _error || _closed; });
+	if (_error)
+	{
+		std::rethrow_exception(_error);
+	}
+	_queue.push_back(std::move(batch));
+	lock.unlock();
+	_not_empty.notify_one();
+}
+
+void ThreadedSink::run()
+{
+	for (;;)
+	{
+		std::vector<ContourElement> batch;
+		{
+			std::unique_lock lock(_mutex);
+			_not_empty.wait(lock, [this] { return !_queue.empty() || _closed; });
+			if (_queue.empty())
+			{
+				return;
+			}
+			batch = std::move(_queue.front());
+			_queue.pop_front();
+		}
+		_not_full.notify_one();
+
+		try
+		{
+			for (const auto& e : batch)
+			{
+				_next.push(e);
+			}
+		}
+		catch (...)
+		{
+			std::lock_guard lock(_mutex);
+			_error = std::current_exception();
+			_queue.clear();
+			_closed = true;
+			_not_full.notify_all();
+			return;
+		}
+	}
+}
+
+void ThreadedSink::finish()
+{
+	if (!_batch.empty())
+	{
+		enqueue(std::move(_batch));
+		_batch = std::vector<ContourElement>();
+	}
+	{
+		std::lock_guard lock(_mutex);
+		_closed = true;
+	}
+	_not_empty.notify_all();
+	if (_worker.joinable())
+	{
+		_worker.join();
+	}
+	if (_error)
+	{
+		std::rethrow_exception(_error);
+	}
+	_next.finish();
+}
@@ -0,0 +1,157 @@
+#include <Config.h>
+#include <ContourStats.h>
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	constexpr size_t STAT_COUNT = static_cast<size_t>(ContourStat::Count);
+
+	const char* const STAT_NAMES[STAT_COUNT] = {
+		"shared_locks",
+		"exclusive_locks",
+		"contended_locks",
+		"lock_wait_ns",
+		"validity_cache_hits",
+		"validity_recomputes",
+		"validity_ns",
+		"element_vector_copies",
+		"elements_copied",
+		"tessellation_calls",
+		"tessellated_points",
+		"tessellation_ns",
+		"tessellation_cache_hits",
+	};
+
+#if CONTOUR_INSTRUMENTATION
+	struct ThreadStats;
+
+	// Registry of live threads plus the totals of threads that have exited
+	struct Registry {
+		std::mutex mutex;
+		std::vector<ThreadStats*> threads;
+		std::array<uint64_t, STAT_COUNT> retired{};
+	};
+
+	Registry& registry()
+	{
+		static Registry* instance = new Registry(); // never destroyed, threads may exit after static destruction
+		return *instance;
+	}
+
+	struct ThreadStats {
+		// Only the owning thread adds, relaxed atomics keep snapshots and resets race free
+		std::array<std::atomic<uint64_t>, STAT_COUNT> values{};
+
+		ThreadStats()
+		{
+			Registry& r = registry();
+			std::lock_guard lock(r.mutex);
+			r.threads.push_back(this);
+		}
+
+		~ThreadStats()
+		{
+			Registry& r = registry();
+			std::lock_guard lock(r.mutex);
+			for (size_t i = 0; i < STAT_COUNT; ++i)
+			{
+				r.retired[i] += values[i].load(std::memory_order_relaxed);
+			}
+			for (size_t i = 0; i < r.threads.size(); ++i)
+			{
+				if (r.threads[i] == this)
+				{
+					r.threads[i] = r.threads.back();
+					r.threads.pop_back();
+					break;
+				}
+			}
+		}
+	};
+
+	ThreadStats& threadStats()
+	{
+		thread_local ThreadStats stats;
+		return stats;
+	}
+#endif
+}
+
+#if CONTOUR_INSTRUMENTATION
+void recordContourStat(ContourStat stat, uint64_t value)
+{
+	threadStats().values[static_cast<size_t>(stat)].fetch_add(value, std::memory_order_relaxed);
+}
+#endif
+
+const char* contourStatName(ContourStat stat)
+{
+	const size_t i = static_cast<size_t>(stat);
+	return i < STAT_COUNT ? STAT_NAMES[i] : "unknown";
+}
+
+bool contourStatisticsEnabled()
+{
+	return CONTOUR_INSTRUMENTATION != 0;
+}
+
+ContourStatistics getContourStatistics()
+{
+	ContourStatistics snapshot;
+#if CONTOUR_INSTRUMENTATION
+	Registry& r = registry();
+	std::lock_guard lock(r.mutex);
+	snapshot.values = r.retired;
+	for (const ThreadStats* t : r.threads)
+	{
+		for (size_t i = 0; i < STAT_COUNT; ++i)
+		{
+			snapshot.values[i] += t->values[i].load(std::memory_order_relaxed);
+		}
+	}
+#endif
+	return snapshot;
+}
+
+void resetContourStatistics()
+{
+#if CONTOUR_INSTRUMENTATION
+	Registry& r = registry();
+	std::lock_guard lock(r.mutex);
+	r.retired.fill(0);
+	for (ThreadStats* t : r.threads)
+	{
+		for (auto& v : t->values)
+		{
+			v.store(0, std::memory_order_relaxed);
+		}
+	}
+#endif
+}
+
+std::string contourStatisticsToJSON()
+{
+	const ContourStatistics snapshot = getContourStatistics();
+	std::ostringstream out;
+	out << "{\"enabled\": " << (contourStatisticsEnabled() ? "true" : "false") << ", \"counters\": {";
+	for (size_t i = 0; i < STAT_COUNT; ++i)
+	{
+		out << (i == 0 ? "" : ", ") << "\"" << STAT_NAMES[i] << "\": " << snapshot.values[i];
+	}
+	out << "}}";
+	return out.str();
+}
+
+void dumpContourStatistics(const std::string& filename)
+{
+	std::ofstream file(filename);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open file.");
+	}
+	file << contourStatisticsToJSON() << "\n";
+}
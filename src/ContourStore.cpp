@@ -0,0 +1,543 @@
+#include <Config.h>
+#include <ContourStore.h>
+#include <JointValidity.h>
+#include <Parallel.h>
+
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+	constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+	constexpr size_t DEFAULT_SHARDS = 64;
+	constexpr size_t COMPACT_MIN_DEAD = 1024; // a shard compacts itself once this many and half its segments are garbage
+
+	enum Kind : uint32_t { LINE = 0, ARC = 1, CURVE = 2 };
+	constexpr unsigned int KIND_SHIFT = 30;
+	constexpr uint32_t INDEX_MASK = (uint32_t(1) << KIND_SHIFT) - 1;
+
+	uint32_t kindOf(uint32_t segment)
+	{
+		return segment >> KIND_SHIFT;
+	}
+
+	uint32_t indexOf(uint32_t segment)
+	{
+		return segment & INDEX_MASK;
+	}
+
+	uint32_t encode(uint32_t kind, size_t index)
+	{
+		if (index > INDEX_MASK)
+		{
+			throw std::invalid_argument("too many segments in a ContourStore shard");
+		}
+		return (kind << KIND_SHIFT) | static_cast<uint32_t>(index);
+	}
+
+	template <typename T>
+	size_t bytes(const std::vector<T>& v)
+	{
+		return v.capacity() * sizeof(T);
+	}
+}
+
+// Shared locks on every shard, taken in shard order so bulk readers never deadlock with each other
+class ContourStore::ReadLocks {
+public:
+	explicit ReadLocks(const ContourStore& store)
+	{
+		_locks.reserve(store._shards.size());
+		for (const auto& shard : store._shards)
+		{
+			_locks.emplace_back(shard->mutex);
+		}
+	}
+
+private:
+	std::vector<std::shared_lock<std::shared_mutex>> _locks;
+};
+
+ContourStore::ContourStore(size_t shards)
+{
+	if (shards == 0)
+	{
+		shards = DEFAULT_SHARDS;
+	}
+	_shard_bits = 0;
+	while ((size_t(1) << _shard_bits) < shards)
+	{
+		++_shard_bits;
+	}
+	if (_shard_bits > 16)
+	{
+		throw std::invalid_argument("too many shards");
+	}
+	_shards.resize(size_t(1) << _shard_bits);
+	for (auto& shard : _shards)
+	{
+		shard = std::make_unique<Shard>();
+	}
+}
+
+ContourStore::Shard& ContourStore::shardOf(ContourHandle handle, uint32_t& slot) const
+{
+	slot = handle >> _shard_bits;
+	return *_shards[handle & ((uint32_t(1) << _shard_bits) - 1)];
+}
+
+const ContourStore::Span& ContourStore::spanOf(const Shard& shard, uint32_t slot)
+{
+	if (slot >= shard.spans.size() || shard.spans[slot].first == NONE)
+	{
+		throw std::out_of_range("unknown contour handle");
+	}
+	return shard.spans[slot];
+}
+
+void ContourStore::append(Shard& shard, const std::vector<ContourElement>& elements, Span& span)
+{
+	// Every limit is checked before the first push, a throw must not leave the parallel arrays misaligned
+	size_t arcs = 0;
+	size_t curves = 0;
+	for (const auto& e : elements)
+	{
+		arcs += std::holds_alternative<Arc>(e) ? 1 : 0;
+		curves += (std::holds_alternative<Line2>(e) || std::holds_alternative<Arc>(e)) ? 0 : 1;
+	}
+	if (shard.segments.size() + elements.size() >= NONE ||
+		(arcs > 0 && shard.arc_cx.size() + arcs - 1 > INDEX_MASK) ||
+		(curves > 0 && shard.curves.size() + curves - 1 > INDEX_MASK))
+	{
+		throw std::invalid_argument("too many segments in a ContourStore shard");
+	}
+	span.first = static_cast<uint32_t>(shard.segments.size());
+	span.count = static_cast<uint32_t>(elements.size());
+	for (const auto& e : elements)
+	{
+		const Segment& segment = asSegment(e);
+		shard.start_x.push_back(segment.startPoint().x);
+		shard.start_y.push_back(segment.startPoint().y);
+		shard.end_x.push_back(segment.endPoint().x);
+		shard.end_y.push_back(segment.endPoint().y);
+		if (std::holds_alternative<Line2>(e))
+		{
+			shard.segments.push_back(encode(LINE, 0));
+		}
+		else if (const Arc* arc = std::get_if<Arc>(&e))
+		{
+			shard.segments.push_back(encode(ARC, shard.arc_cx.size()));
+			shard.arc_cx.push_back(arc->getCenter().x);
+			shard.arc_cy.push_back(arc->getCenter().y);
+			shard.arc_radius.push_back(arc->getRadius());
+			shard.arc_start.push_back(arc->getStartAngle());
+			shard.arc_end.push_back(arc->getEndAngle());
+			shard.arc_resolution.push_back(arc->getResolution());
+			shard.arc_forwards.push_back(arc->isForwards() ? 1 : 0);
+		}
+		else
+		{
+			shard.segments.push_back(encode(CURVE, shard.curves.size()));
+			shard.curves.push_back(e);
+		}
+	}
+}
+
+ContourElement ContourStore::element(const Shard& shard, uint32_t s)
+{
+	const uint32_t segment = shard.segments[s];
+	const uint32_t i = indexOf(segment);
+	switch (kindOf(segment))
+	{
+	case LINE:
+		return Line2(Point2({ shard.start_x[s], shard.start_y[s] }), Point2({ shard.end_x[s], shard.end_y[s] }));
+	case ARC:
+		return Arc(Point2({ shard.arc_cx[i], shard.arc_cy[i] }), shard.arc_radius[i], shard.arc_start[i], shard.arc_end[i],
+			shard.arc_resolution[i], shard.arc_forwards[i] != 0);
+	default:
+		return shard.curves[i];
+	}
+}
+
+bool ContourStore::spanIsValid(const Shard& shard, const Span& span)
+{
+	if (span.count < 2)
+	{
+		return true;
+	}
+	// Joint k joins the end of segment first + k to the start of segment first + k + 1
+	const size_t joints = span.count - 1;
+	return firstOpenJoint(shard.end_x.data() + span.first, shard.end_y.data() + span.first,
+		shard.start_x.data() + span.first + 1, shard.start_y.data() + span.first + 1, joints, EPS) == joints;
+}
+
+BoundingBox ContourStore::spanBounds(const Shard& shard, const Span& span)
+{
+	BoundingBox box;
+	for (uint32_t s = span.first; s < span.first + span.count; ++s)
+	{
+		if (kindOf(shard.segments[s]) == LINE)
+		{
+			box.expand(Point2({ shard.start_x[s], shard.start_y[s] }));
+			box.expand(Point2({ shard.end_x[s], shard.end_y[s] }));
+		}
+		else
+		{
+			box.expand(asSegment(element(shard, s)).getBounds());
+		}
+	}
+	return box;
+}
+
+void ContourStore::compactShard(Shard& shard)
+{
+	Shard fresh;
+	fresh.segments.reserve(shard.segments.size() - shard.dead_segments);
+	for (auto& span : shard.spans)
+	{
+		if (span.first == NONE)
+		{
+			continue;
+		}
+		const uint32_t first = static_cast<uint32_t>(fresh.segments.size());
+		for (uint32_t s = span.first; s < span.first + span.count; ++s)
+		{
+			const uint32_t segment = shard.segments[s];
+			const uint32_t i = indexOf(segment);
+			fresh.start_x.push_back(shard.start_x[s]);
+			fresh.start_y.push_back(shard.start_y[s]);
+			fresh.end_x.push_back(shard.end_x[s]);
+			fresh.end_y.push_back(shard.end_y[s]);
+			switch (kindOf(segment))
+			{
+			case LINE:
+				fresh.segments.push_back(segment);
+				break;
+			case ARC:
+				fresh.segments.push_back(encode(ARC, fresh.arc_cx.size()));
+				fresh.arc_cx.push_back(shard.arc_cx[i]);
+				fresh.arc_cy.push_back(shard.arc_cy[i]);
+				fresh.arc_radius.push_back(shard.arc_radius[i]);
+				fresh.arc_start.push_back(shard.arc_start[i]);
+				fresh.arc_end.push_back(shard.arc_end[i]);
+				fresh.arc_resolution.push_back(shard.arc_resolution[i]);
+				fresh.arc_forwards.push_back(shard.arc_forwards[i]);
+				break;
+			default:
+				fresh.segments.push_back(encode(CURVE, fresh.curves.size()));
+				fresh.curves.push_back(std::move(shard.curves[i]));
+				break;
+			}
+		}
+		span.first = first;
+	}
+	shard.segments.swap(fresh.segments);
+	shard.start_x.swap(fresh.start_x);
+	shard.start_y.swap(fresh.start_y);
+	shard.end_x.swap(fresh.end_x);
+	shard.end_y.swap(fresh.end_y);
+	shard.arc_cx.swap(fresh.arc_cx);
+	shard.arc_cy.swap(fresh.arc_cy);
+	shard.arc_radius.swap(fresh.arc_radius);
+	shard.arc_start.swap(fresh.arc_start);
+	shard.arc_end.swap(fresh.arc_end);
+	shard.arc_resolution.swap(fresh.arc_resolution);
+	shard.arc_forwards.swap(fresh.arc_forwards);
+	shard.curves.swap(fresh.curves);
+	shard.dead_segments = 0;
+}
+
+ContourHandle ContourStore::add(const std::vector<ContourElement>& elements)
+{
+	const uint32_t index = static_cast<uint32_t>(_next.fetch_add(1) & (_shards.size() - 1));
+	Shard& shard = *_shards[index];
+	std::unique_lock lock(shard.mutex);
+	if (shard.spans.size() >= (size_t(1) << (32 - _shard_bits)))
+	{
+		throw std::invalid_argument("too many contours in a ContourStore shard");
+	}
+	Span span{};
+	append(shard, elements, span);
+	shard.spans.push_back(span);
+	++shard.live;
+	return static_cast<ContourHandle>(((shard.spans.size() - 1) << _shard_bits) | index);
+}
+
+ContourHandle ContourStore::add(const Contour& contour)
+{
+	return add(contour.getElements());
+}
+
+std::vector<ContourHandle> ContourStore::addBatch(const std::vector<Contour>& contours, unsigned int num_threads)
+{
+	std::vector<ContourHandle> result(contours.size());
+	const size_t shards = _shards.size();
+	const size_t offset = _next.fetch_add(contours.size());
+	// Contour i goes to the shard that add() would have picked, every thread fills whole shards
+	parallelFor(shards, num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t index = first; index < last; ++index)
+		{
+			Shard& shard = *_shards[index];
+			std::unique_lock lock(shard.mutex);
+			for (size_t i = (index + shards - offset % shards) % shards; i < contours.size(); i += shards)
+			{
+				if (shard.spans.size() >= (size_t(1) << (32 - _shard_bits)))
+				{
+					throw std::invalid_argument("too many contours in a ContourStore shard");
+				}
+				Span span{};
+				append(shard, contours[i].getElements(), span);
+				shard.spans.push_back(span);
+				++shard.live;
+				result[i] = static_cast<ContourHandle>(((shard.spans.size() - 1) << _shard_bits) | index);
+			}
+		}
+	});
+	return result;
+}
+
+void ContourStore::replace(ContourHandle handle, const std::vector<ContourElement>& elements)
+{
+	uint32_t slot;
+	Shard& shard = shardOf(handle, slot);
+	std::unique_lock lock(shard.mutex);
+	const Span old = spanOf(shard, slot);
+	Span span{};
+	append(shard, elements, span);
+	shard.spans[slot] = span;
+	shard.dead_segments += old.count;
+	if (shard.dead_segments >= COMPACT_MIN_DEAD && 2 * shard.dead_segments > shard.segments.size())
+	{
+		compactShard(shard);
+	}
+}
+
+void ContourStore::remove(ContourHandle handle)
+{
+	uint32_t slot;
+	Shard& shard = shardOf(handle, slot);
+	std::unique_lock lock(shard.mutex);
+	const Span old = spanOf(shard, slot);
+	shard.spans[slot] = Span{ NONE, 0 };
+	shard.dead_segments += old.count;
+	--shard.live;
+	if (shard.dead_segments >= COMPACT_MIN_DEAD && 2 * shard.dead_segments > shard.segments.size())
+	{
+		compactShard(shard);
+	}
+}
+
+bool ContourStore::contains(ContourHandle handle) const
+{
+	uint32_t slot;
+	const Shard& shard = shardOf(handle, slot);
+	std::shared_lock lock(shard.mutex);
+	return slot < shard.spans.size() && shard.spans[slot].first != NONE;
+}
+
+std::vector<ContourElement> ContourStore::elements(ContourHandle handle) const
+{
+	uint32_t slot;
+	const Shard& shard = shardOf(handle, slot);
+	std::shared_lock lock(shard.mutex);
+	const Span& span = spanOf(shard, slot);
+	std::vector<ContourElement> result;
+	result.reserve(span.count);
+	for (uint32_t s = span.first; s < span.first + span.count; ++s)
+	{
+		result.push_back(element(shard, s));
+	}
+	return result;
+}
+
+Contour ContourStore::get(ContourHandle handle) const
+{
+	Contour contour;
+	contour.addItems(elements(handle));
+	return contour;
+}
+
+size_t ContourStore::segmentCount(ContourHandle handle) const
+{
+	uint32_t slot;
+	const Shard& shard = shardOf(handle, slot);
+	std::shared_lock lock(shard.mutex);
+	return spanOf(shard, slot).count;
+}
+
+bool ContourStore::isValid(ContourHandle handle) const
+{
+	uint32_t slot;
+	const Shard& shard = shardOf(handle, slot);
+	std::shared_lock lock(shard.mutex);
+	return spanIsValid(shard, spanOf(shard, slot));
+}
+
+BoundingBox ContourStore::bounds(ContourHandle handle) const
+{
+	uint32_t slot;
+	const Shard& shard = shardOf(handle, slot);
+	std::shared_lock lock(shard.mutex);
+	return spanBounds(shard, spanOf(shard, slot));
+}
+
+size_t ContourStore::size() const
+{
+	size_t total = 0;
+	for (const auto& shard : _shards)
+	{
+		std::shared_lock lock(shard->mutex);
+		total += shard->live;
+	}
+	return total;
+}
+
+std::vector<ContourHandle> ContourStore::handles() const
+{
+	ReadLocks locks(*this);
+	std::vector<ContourHandle> result;
+	for (size_t index = 0; index < _shards.size(); ++index)
+	{
+		const Shard& shard = *_shards[index];
+		for (size_t slot = 0; slot < shard.spans.size(); ++slot)
+		{
+			if (shard.spans[slot].first != NONE)
+			{
+				result.push_back(static_cast<ContourHandle>((slot << _shard_bits) | index));
+			}
+		}
+	}
+	return result;
+}
+
+std::vector<uint8_t> ContourStore::validate(const std::vector<ContourHandle>& handles, unsigned int num_threads) const
+{
+	ReadLocks locks(*this);
+	std::vector<uint8_t> result(handles.size());
+	parallelFor(handles.size(), num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			uint32_t slot;
+			const Shard& shard = shardOf(handles[i], slot);
+			result[i] = spanIsValid(shard, spanOf(shard, slot)) ? 1 : 0;
+		}
+	});
+	return result;
+}
+
+std::vector<BoundingBox> ContourStore::bounds(const std::vector<ContourHandle>& handles, unsigned int num_threads) const
+{
+	ReadLocks locks(*this);
+	std::vector<BoundingBox> result(handles.size());
+	parallelFor(handles.size(), num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			uint32_t slot;
+			const Shard& shard = shardOf(handles[i], slot);
+			result[i] = spanBounds(shard, spanOf(shard, slot));
+		}
+	});
+	return result;
+}
+
+std::vector<Contour> ContourStore::toContours(const std::vector<ContourHandle>& handles, unsigned int num_threads) const
+{
+	ReadLocks locks(*this);
+	std::vector<Contour> result(handles.size());
+	parallelFor(handles.size(), num_threads, [&](size_t first, size_t last)
+	{
+		std::vector<ContourElement> items;
+		for (size_t i = first; i < last; ++i)
+		{
+			uint32_t slot;
+			const Shard& shard = shardOf(handles[i], slot);
+			const Span& span = spanOf(shard, slot);
+			items.clear();
+			for (uint32_t s = span.first; s < span.first + span.count; ++s)
+			{
+				items.push_back(element(shard, s));
+			}
+			result[i].addItems(items);
+		}
+	});
+	return result;
+}
+
+void ContourStore::exportToSVG(const std::string& filename, const std::vector<ContourHandle>& handles, unsigned int num_threads) const
+{
+	std::ofstream file(filename);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open file.");
+	}
+
+	// Same layout as Contour::exportContourToSVG
+	const double scale = 10;
+	std::vector<std::string> paths(handles.size());
+	{
+		ReadLocks locks(*this);
+		parallelFor(handles.size(), num_threads, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; ++i)
+			{
+				uint32_t slot;
+				const Shard& shard = shardOf(handles[i], slot);
+				const Span& span = spanOf(shard, slot);
+				std::string& path = paths[i];
+				for (uint32_t s = span.first; s < span.first + span.count; ++s)
+				{
+					const std::vector<Point2> pts = asSegment(element(shard, s)).getLineStrip();
+					for (size_t j = 0; j < pts.size(); ++j)
+					{
+						path += (j == 0 ? "M " : "L ") +
+							std::to_string(scale * pts[j].x) + " " +
+							std::to_string(scale * (1 - pts[j].y)) + " ";
+					}
+				}
+			}
+		});
+	}
+
+	file << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"600\" height=\"600\" viewBox=\"-100 -100 600 600\">\n";
+	file << "<g fill=\"none\" stroke=\"black\" stroke-width=\"2\" stroke-linejoin=\"round\">\n";
+	for (const auto& path : paths)
+	{
+		file << "<path d=\"" << path << "\" />\n";
+	}
+	file << "</g>\n</svg>\n";
+}
+
+void ContourStore::compact(unsigned int num_threads)
+{
+	parallelFor(_shards.size(), num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t index = first; index < last; ++index)
+		{
+			Shard& shard = *_shards[index];
+			std::unique_lock lock(shard.mutex);
+			if (shard.dead_segments > 0)
+			{
+				compactShard(shard);
+			}
+		}
+	});
+}
+
+size_t ContourStore::memoryUsage() const
+{
+	size_t total = sizeof(*this) + _shards.size() * (sizeof(Shard) + sizeof(std::unique_ptr<Shard>));
+	for (const auto& shard : _shards)
+	{
+		std::shared_lock lock(shard->mutex);
+		total += bytes(shard->spans) + bytes(shard->segments);
+		total += bytes(shard->start_x) + bytes(shard->start_y) + bytes(shard->end_x) + bytes(shard->end_y);
+		total += bytes(shard->arc_cx) + bytes(shard->arc_cy) + bytes(shard->arc_radius) + bytes(shard->arc_start) + bytes(shard->arc_end);
+		total += bytes(shard->arc_resolution) + bytes(shard->arc_forwards) + bytes(shard->curves);
+	}
+	return total;
+}
@@ -0,0 +1,530 @@
+#include <Config.h>
+#include <ConvexHull.h>
+#include <Parallel.h>
+#include <Predicates.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+	constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+	constexpr double TWO_PI = 2 * PI;
+	constexpr size_t BLOCK = size_t(1) << 14; // sites per parallel block
+
+	struct ArcSite {
+		Point2 center;
+		double radius;
+		double start; // counter clockwise range [start, start + sweep], start in [0, 2 pi)
+		double sweep;
+	};
+
+	/* Points and arcs under one numbering, ids below points.size() are points. The support of a site in direction
+	 * theta is center . (cos theta, sin theta) + radius, points have radius 0 and arcs only support their own range. */
+	struct Sites {
+		std::vector<Point2> points;
+		std::vector<ArcSite> arcs;
+
+		const Point2& center(uint32_t id) const
+		{
+			return id < points.size() ? points[id] : arcs[id - points.size()].center;
+		}
+
+		double radius(uint32_t id) const
+		{
+			return id < points.size() ? 0.0 : arcs[id - points.size()].radius;
+		}
+
+		double support(uint32_t id, double theta) const
+		{
+			const Point2& c = center(id);
+			return c.x * cos(theta) + c.y * sin(theta) + radius(id);
+		}
+	};
+
+	// The hull as the site with the largest support for each direction, pieces start at direction 0 and
+	// each runs until the next one begins, the last until 2 pi. NONE marks directions without support.
+	struct Piece {
+		double begin;
+		uint32_t site;
+	};
+	using Envelope = std::vector<Piece>;
+
+	double wrap(double theta)
+	{
+		theta = std::fmod(theta, TWO_PI);
+		if (theta < 0)
+		{
+			theta += TWO_PI;
+		}
+		return theta < TWO_PI ? theta : 0.0;
+	}
+
+	void append(Envelope& envelope, double begin, uint32_t site)
+	{
+		if (envelope.empty() || envelope.back().site != site)
+		{
+			envelope.push_back(Piece{ begin, site });
+		}
+	}
+
+	// Directions in (first, last) where a and b support equally, where (a.c - b.c) . u + a.r - b.r = 0
+	size_t crossings(const Sites& sites, uint32_t a, uint32_t b, double first, double last, double (&out)[2])
+	{
+		const double p = sites.center(a).x - sites.center(b).x;
+		const double q = sites.center(a).y - sites.center(b).y;
+		const double m = std::hypot(p, q);
+		const double r = sites.radius(a) - sites.radius(b);
+		if (m == 0 || fabs(r) > m)
+		{
+			return 0;
+		}
+		const double phi = atan2(q, p);
+		const double delta = acos(-r / m);
+		size_t count = 0;
+		for (double theta : { wrap(phi - delta), wrap(phi + delta) })
+		{
+			if (theta > first && theta < last && (count == 0 || theta != out[0]))
+			{
+				out[count++] = theta;
+			}
+		}
+		if (count == 2 && out[1] < out[0])
+		{
+			std::swap(out[0], out[1]);
+		}
+		return count;
+	}
+
+	Envelope merge(const Envelope& a, const Envelope& b, const Sites& sites)
+	{
+		Envelope merged;
+		merged.reserve(a.size() + b.size());
+		size_t i = 0;
+		size_t j = 0;
+		double t = 0.0;
+		while (i < a.size() && j < b.size())
+		{
+			const double end_a = (i + 1 < a.size()) ? a[i + 1].begin : TWO_PI;
+			const double end_b = (j + 1 < b.size()) ? b[j + 1].begin : TWO_PI;
+			const double end = std::min(end_a, end_b);
+			const uint32_t site_a = a[i].site;
+			const uint32_t site_b = b[j].site;
+			if (end > t)
+			{
+				if (site_a == NONE || site_b == NONE)
+				{
+					append(merged, t, site_a == NONE ? site_b : site_a);
+				}
+				else
+				{
+					// Between the crossings one site wins throughout
+					auto choose = [&](double from, double to)
+					{
+						const double middle = (from + to) / 2;
+						append(merged, from, sites.support(site_a, middle) >= sites.support(site_b, middle) ? site_a : site_b);
+					};
+					double cuts[2];
+					const size_t count = crossings(sites, site_a, site_b, t, end, cuts);
+					double from = t;
+					for (size_t k = 0; k < count; ++k)
+					{
+						choose(from, cuts[k]);
+						from = cuts[k];
+					}
+					choose(from, end);
+				}
+			}
+			if (end == end_a) ++i;
+			if (end == end_b) ++j;
+			t = end;
+		}
+		return merged;
+	}
+
+	// Intersection of the half planes normal . p < offset, with unit normals
+	struct HalfPlanes {
+		struct Plane {
+			double nx;
+			double ny;
+			double offset;
+		};
+		std::vector<Plane> planes;
+
+		bool containsDisk(const Point2& center, double radius) const
+		{
+			if (planes.size() < 3)
+			{
+				return false;
+			}
+			for (const auto& plane : planes)
+			{
+				if (plane.nx * center.x + plane.ny * center.y + radius >= plane.offset)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	/* Polygon of the extreme points in eight directions. It lies inside the hull, so the points and the circles
+	 * inside it can be dropped in a linear pass before sorting. */
+	HalfPlanes extremePolygon(const std::vector<Point2>& points, size_t first, size_t last)
+	{
+		HalfPlanes inner;
+		if (last - first < 64)
+		{
+			return inner;
+		}
+		// Directions counter clockwise from +x, in steps of 45 degrees
+		constexpr double DX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+		constexpr double DY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+		size_t extreme[8] = {};
+		double best[8];
+		std::fill(std::begin(best), std::end(best), -std::numeric_limits<double>::infinity());
+		for (size_t i = first; i < last; ++i)
+		{
+			for (size_t k = 0; k < 8; ++k)
+			{
+				const double d = DX[k] * points[i].x + DY[k] * points[i].y;
+				if (d > best[k])
+				{
+					best[k] = d;
+					extreme[k] = i;
+				}
+			}
+		}
+		std::vector<Point2> polygon;
+		for (size_t k = 0; k < 8; ++k)
+		{
+			const Point2& p = points[extreme[k]];
+			if (polygon.empty() || p.x != polygon.back().x || p.y != polygon.back().y)
+			{
+				polygon.push_back(p);
+			}
+		}
+		if (polygon.size() > 1 && polygon.front().x == polygon.back().x && polygon.front().y == polygon.back().y)
+		{
+			polygon.pop_back();
+		}
+		for (size_t k = 0; polygon.size() >= 3 && k < polygon.size(); ++k)
+		{
+			const Point2& a = polygon[k];
+			const Point2& b = polygon[(k + 1) % polygon.size()];
+			const double length = std::hypot(b.x - a.x, b.y - a.y);
+			const double nx = (b.y - a.y) / length;
+			const double ny = -(b.x - a.x) / length;
+			inner.planes.push_back(HalfPlanes::Plane{ nx, ny, nx * a.x + ny * a.y });
+		}
+		return inner;
+	}
+
+	// Monotone chain over points, each hull vertex supports the directions between the normals of its edges
+	Envelope pointEnvelope(const Sites& sites, std::vector<uint32_t> ids)
+	{
+		const auto& points = sites.points;
+		std::sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b)
+		{
+			return points[a].x < points[b].x || (points[a].x == points[b].x && points[a].y < points[b].y);
+		});
+		ids.erase(std::unique(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b)
+		{
+			return points[a].x == points[b].x && points[a].y == points[b].y;
+		}), ids.end());
+		if (ids.size() < 2)
+		{
+			return Envelope{ Piece{ 0.0, ids.empty() ? NONE : ids.front() } };
+		}
+
+		// Exact sign, a rounded cross product can keep a nearly collinear point and break the convexity of the chain
+		auto turn = [&](uint32_t o, uint32_t a, uint32_t b)
+		{
+			return orient2d(points[o], points[a], points[b]);
+		};
+		std::vector<uint32_t> hull(2 * ids.size());
+		size_t k = 0;
+		for (size_t i = 0; i < ids.size(); ++i)
+		{
+			while (k >= 2 && turn(hull[k - 2], hull[k - 1], ids[i]) <= 0) --k;
+			hull[k++] = ids[i];
+		}
+		for (size_t i = ids.size() - 1, lower = k + 1; i-- > 0;)
+		{
+			while (k >= lower && turn(hull[k - 2], hull[k - 1], ids[i]) <= 0) --k;
+			hull[k++] = ids[i];
+		}
+		hull.resize(k - 1);
+
+		Envelope envelope;
+		envelope.reserve(hull.size() + 1);
+		for (size_t v = 0; v < hull.size(); ++v)
+		{
+			const Point2& p = points[hull[(v + hull.size() - 1) % hull.size()]];
+			const Point2& q = points[hull[v]];
+			// Outward normal of the edge arriving at q
+			envelope.push_back(Piece{ wrap(atan2(-(q.x - p.x), q.y - p.y)), hull[v] });
+		}
+		std::sort(envelope.begin(), envelope.end(), [](const Piece& a, const Piece& b) { return a.begin < b.begin; });
+		if (envelope.front().begin > 0)
+		{
+			envelope.insert(envelope.begin(), Piece{ 0.0, envelope.back().site });
+		}
+		return envelope;
+	}
+
+	// Supporting lines of the edges of a point hull
+	HalfPlanes hullPlanes(const Sites& sites, const Envelope& hull)
+	{
+		HalfPlanes edges;
+		for (size_t i = 0; hull.size() >= 3 && i < hull.size(); ++i)
+		{
+			// Each piece starts at the normal of the edge arriving at its vertex, except a first piece that only wraps around
+			if (i == 0 && hull.front().site == hull.back().site)
+			{
+				continue;
+			}
+			const Point2& vertex = sites.points[hull[i].site];
+			const double nx = cos(hull[i].begin);
+			const double ny = sin(hull[i].begin);
+			edges.planes.push_back(HalfPlanes::Plane{ nx, ny, nx * vertex.x + ny * vertex.y });
+		}
+		return edges;
+	}
+
+	Envelope arcEnvelope(const Sites& sites, uint32_t id)
+	{
+		const ArcSite& arc = sites.arcs[id - sites.points.size()];
+		if (arc.sweep >= TWO_PI)
+		{
+			return Envelope{ Piece{ 0.0, id } };
+		}
+		const double end = arc.start + arc.sweep;
+		if (end > TWO_PI)
+		{
+			return Envelope{ Piece{ 0.0, id }, Piece{ end - TWO_PI, NONE }, Piece{ arc.start, id } };
+		}
+		Envelope envelope{ Piece{ 0.0, arc.start > 0 ? NONE : id } };
+		if (arc.start > 0)
+		{
+			envelope.push_back(Piece{ arc.start, id });
+		}
+		if (end < TWO_PI)
+		{
+			envelope.push_back(Piece{ end, NONE });
+		}
+		return envelope;
+	}
+
+	Envelope arcsEnvelope(const Sites& sites, const uint32_t* ids, size_t count)
+	{
+		if (count == 0)
+		{
+			return Envelope{ Piece{ 0.0, NONE } };
+		}
+		if (count == 1)
+		{
+			return arcEnvelope(sites, ids[0]);
+		}
+		const size_t half = count / 2;
+		return merge(arcsEnvelope(sites, ids, half), arcsEnvelope(sites, ids + half, count - half), sites);
+	}
+
+	Envelope blockEnvelope(const Sites& sites, size_t p0, size_t p1, size_t a0, size_t a1)
+	{
+		const HalfPlanes inner = extremePolygon(sites.points, p0, p1);
+		std::vector<uint32_t> ids;
+		for (size_t i = p0; i < p1; ++i)
+		{
+			if (!inner.containsDisk(sites.points[i], 0.0))
+			{
+				ids.push_back(static_cast<uint32_t>(i));
+			}
+		}
+		const Envelope hull = pointEnvelope(sites, std::move(ids));
+
+		// Arcs whose whole circle lies inside the hull of the points cannot reach the hull
+		const HalfPlanes edges = hullPlanes(sites, hull);
+		std::vector<uint32_t> outside;
+		for (size_t a = a0; a < a1; ++a)
+		{
+			const ArcSite& arc = sites.arcs[a];
+			if (!inner.containsDisk(arc.center, arc.radius) && !edges.containsDisk(arc.center, arc.radius))
+			{
+				outside.push_back(static_cast<uint32_t>(sites.points.size() + a));
+			}
+		}
+		return merge(hull, arcsEnvelope(sites, outside.data(), outside.size()), sites);
+	}
+
+	Envelope hullEnvelope(const Sites& sites, unsigned int num_threads)
+	{
+		const size_t points = sites.points.size();
+		const size_t arcs = sites.arcs.size();
+		const unsigned int blocks = resolveThreadCount(num_threads, (points + arcs) / BLOCK);
+		std::vector<Envelope> envelopes(blocks);
+		parallelFor(blocks, blocks, [&](size_t first, size_t last)
+		{
+			for (size_t b = first; b < last; ++b)
+			{
+				envelopes[b] = blockEnvelope(sites, points * b / blocks, points * (b + 1) / blocks,
+					arcs * b / blocks, arcs * (b + 1) / blocks);
+			}
+		});
+		// Pairwise merges, a level at a time
+		while (envelopes.size() > 1)
+		{
+			std::vector<Envelope> next((envelopes.size() + 1) / 2);
+			parallelFor(next.size(), num_threads, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+				{
+					next[i] = (2 * i + 1 < envelopes.size()) ? merge(envelopes[2 * i], envelopes[2 * i + 1], sites)
+						: std::move(envelopes[2 * i]);
+				}
+			});
+			envelopes = std::move(next);
+		}
+		return std::move(envelopes.front());
+	}
+
+	// Arcs for arc pieces, joined by the Line2s along the supporting lines between consecutive sites
+	Contour toContour(const Sites& sites, const Envelope& envelope)
+	{
+		struct Span {
+			double begin;
+			double end;
+			uint32_t site;
+		};
+		std::vector<Span> spans;
+		spans.reserve(envelope.size());
+		for (size_t i = 0; i < envelope.size(); ++i)
+		{
+			const double end = (i + 1 < envelope.size()) ? envelope[i + 1].begin : TWO_PI;
+			spans.push_back(Span{ envelope[i].begin, end, envelope[i].site });
+		}
+		if (spans.size() > 1 && spans.front().site == spans.back().site)
+		{
+			spans.back().end = spans.front().end + TWO_PI;
+			spans.erase(spans.begin());
+		}
+
+		std::vector<ContourElement> elements;
+		Point2 first;
+		Point2 cursor;
+		bool started = false;
+		auto lineTo = [&](const Point2& to)
+		{
+			if (!started)
+			{
+				first = to;
+				started = true;
+			}
+			else if (fabs(to.x - cursor.x) >= EPS || fabs(to.y - cursor.y) >= EPS)
+			{
+				elements.push_back(Line2(cursor, to));
+			}
+		};
+		for (const auto& span : spans)
+		{
+			const Point2& center = sites.center(span.site);
+			const double radius = sites.radius(span.site);
+			if (radius > 0 && radius * (span.end - span.begin) >= EPS)
+			{
+				const Arc arc(center, radius, span.begin, span.end);
+				lineTo(arc.getCoordinate(0.0));
+				elements.push_back(arc);
+				cursor = arc.getCoordinate(1.0);
+			}
+			else
+			{
+				const double middle = (span.begin + span.end) / 2;
+				const Point2 p({ center.x + radius * cos(middle), center.y + radius * sin(middle) });
+				lineTo(p);
+				cursor = p;
+			}
+		}
+		if (started)
+		{
+			lineTo(first);
+		}
+
+		Contour hull;
+		if (elements.size() > 1 || (elements.size() == 1 && std::holds_alternative<Arc>(elements.front())))
+		{
+			hull.addItems(elements);
+		}
+		return hull;
+	}
+
+	Contour hullOf(const Sites& sites, const HullOptions& options)
+	{
+		if (sites.points.size() + sites.arcs.size() >= NONE)
+		{
+			throw std::invalid_argument("too many elements to hull");
+		}
+		if (sites.points.empty())
+		{
+			return Contour();
+		}
+		return toContour(sites, hullEnvelope(sites, options.num_threads));
+	}
+}
+
+Contour convexHull(const std::vector<ContourElement>& elements, const HullOptions& options)
+{
+	Sites sites;
+	sites.points.reserve(2 * elements.size());
+	for (const auto& e : elements)
+	{
+		if (const Line2* line = std::get_if<Line2>(&e))
+		{
+			sites.points.push_back(line->getCoordinate(0.0));
+			sites.points.push_back(line->getCoordinate(1.0));
+		}
+		else if (const Arc* arc = std::get_if<Arc>(&e))
+		{
+			sites.points.push_back(arc->getCoordinate(0.0));
+			sites.points.push_back(arc->getCoordinate(1.0));
+			const double sweep = fabs(arc->getEndAngle() - arc->getStartAngle());
+			if (sweep > 0)
+			{
+				sites.arcs.push_back(ArcSite{ arc->getCenter(), arc->getRadius(), wrap(std::min(arc->getStartAngle(), arc->getEndAngle())), sweep });
+			}
+		}
+		else
+		{
+			const std::vector<Point2> strip = std::visit([](const auto& seg) { return seg.getLineStrip(); }, e);
+			sites.points.insert(sites.points.end(), strip.begin(), strip.end());
+		}
+	}
+	return hullOf(sites, options);
+}
+
+Contour convexHull(const Contour& contour, const HullOptions& options)
+{
+	return convexHull(contour.getElements(), options);
+}
+
+Contour convexHull(const std::vector<Point2>& points, const HullOptions& options)
+{
+	Sites sites;
+	sites.points = points;
+	return hullOf(sites, options);
+}
+
+std::vector<Contour> convexHullBatch(const std::vector<Contour>& contours, const HullOptions& options)
+{
+	std::vector<Contour> hulls(contours.size());
+	parallelFor(contours.size(), options.num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			hulls[i] = convexHull(contours[i], HullOptions{ 1 });
+		}
+	});
+	return hulls;
+}
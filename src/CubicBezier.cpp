@@ -0,0 +1,287 @@
+#include <Config.h>
+#include <CubicBezier.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+	// Pieces needing more steps than this are split in half instead, so the steps follow the curvature
+	constexpr size_t MAX_FORWARD_STEPS = 16;
+	constexpr int MAX_SUBDIVISION_DEPTH = 24;
+
+	struct Controls {
+		Point2 p[4];
+	};
+
+	// Wang's bound: n uniform steps keep every chord of a cubic within tolerance of the curve
+	size_t stepCount(const Controls& c, double tolerance)
+	{
+		double longest = 0.0;
+		for (int i = 0; i < 2; ++i)
+		{
+			const double dx = c.p[i].x - 2 * c.p[i + 1].x + c.p[i + 2].x;
+			const double dy = c.p[i].y - 2 * c.p[i + 1].y + c.p[i + 2].y;
+			longest = std::max(longest, dx * dx + dy * dy);
+		}
+		const double n = std::ceil(std::sqrt(0.75 * std::sqrt(longest) / tolerance));
+		return std::max<size_t>(1, static_cast<size_t>(std::min(n, 1E9)));
+	}
+
+	// de Casteljau split at t = 0.5
+	void split(const Controls& c, Controls& left, Controls& right)
+	{
+		auto mid = [](const Point2& a, const Point2& b) { return Point2({ (a.x + b.x) / 2, (a.y + b.y) / 2 }); };
+		const Point2 a = mid(c.p[0], c.p[1]);
+		const Point2 b = mid(c.p[1], c.p[2]);
+		const Point2 d = mid(c.p[2], c.p[3]);
+		const Point2 ab = mid(a, b);
+		const Point2 bd = mid(b, d);
+		const Point2 center = mid(ab, bd);
+		left = Controls{ { c.p[0], a, ab, center } };
+		right = Controls{ { center, bd, d, c.p[3] } };
+	}
+
+	// Appends n uniform steps of the piece (without its start point), three additions per point
+	void forwardDifference(const Controls& c, size_t n, std::vector<Point2>& out)
+	{
+		const double h = 1.0 / static_cast<double>(n);
+		const double h2 = h * h;
+		const double h3 = h2 * h;
+		double coord[2][4];
+		for (int axis = 0; axis < 2; ++axis)
+		{
+			auto v = [&](int i) { return axis == 0 ? c.p[i].x : c.p[i].y; };
+			// Power basis a t^3 + b t^2 + c t + d
+			const double a = -v(0) + 3 * v(1) - 3 * v(2) + v(3);
+			const double b = 3 * v(0) - 6 * v(1) + 3 * v(2);
+			const double cc = -3 * v(0) + 3 * v(1);
+			coord[axis][0] = v(0);
+			coord[axis][1] = a * h3 + b * h2 + cc * h;
+			coord[axis][2] = 6 * a * h3 + 2 * b * h2;
+			coord[axis][3] = 6 * a * h3;
+		}
+		for (size_t i = 1; i < n; ++i)
+		{
+			for (auto& f : coord)
+			{
+				f[0] += f[1];
+				f[1] += f[2];
+				f[2] += f[3];
+			}
+			out.push_back(Point2({ coord[0][0], coord[1][0] }));
+		}
+		out.push_back(c.p[3]); // exact end point, no accumulated drift at the joints
+	}
+
+	// Real roots in (0, 1) of a t^2 + b t + c
+	void unitRoots(double a, double b, double c, std::vector<double>& roots)
+	{
+		if (fabs(a) < EPS)
+		{
+			if (fabs(b) > EPS)
+			{
+				roots.push_back(-c / b);
+			}
+		}
+		else
+		{
+			const double disc = b * b - 4 * a * c;
+			if (disc >= 0)
+			{
+				const double s = std::sqrt(disc);
+				roots.push_back((-b + s) / (2 * a));
+				roots.push_back((-b - s) / (2 * a));
+			}
+		}
+		roots.erase(std::remove_if(roots.begin(), roots.end(), [](double t) { return !(t > 0.0 && t < 1.0); }), roots.end());
+	}
+}
+
+CubicBezier::CubicBezier(const Point2& s, const Point2& c1, const Point2& c2, const Point2& e, double flat)
+{
+	if (flat <= 0)
+	{
+		throw std::invalid_argument("flatness must be positive and non zero");
+	}
+	if (s.isCloseTo(e, EPS) && s.isCloseTo(c1, EPS) && s.isCloseTo(c2, EPS))
+	{
+		throw std::invalid_argument("CubicBezier control points are all the same");
+	}
+
+	start = s;
+	control1 = c1;
+	control2 = c2;
+	end = e;
+	flatness = flat;
+	cacheEndpoints();
+}
+
+CubicBezier::CubicBezier(const Point2& point, double flat)
+	: start(point), control1(point), control2(point), end(point), flatness(flat)
+{
+	cacheEndpoints();
+}
+
+// Gets coordinate on the curve in Bernstein form, t<-[0,1]
+Point2 CubicBezier::getCoordinate(double t) const
+{
+	if (t < 0 || t > 1)
+	{
+		throw std::invalid_argument("argument is out of bounds");
+	}
+
+	const double mt = 1 - t;
+	const double b0 = mt * mt * mt;
+	const double b1 = 3 * mt * mt * t;
+	const double b2 = 3 * mt * t * t;
+	const double b3 = t * t * t;
+	return Point2({ b0 * start.x + b1 * control1.x + b2 * control2.x + b3 * end.x,
+		b0 * start.y + b1 * control1.y + b2 * control2.y + b3 * end.y });
+}
+
+Point2 CubicBezier::getDerivative(double t) const
+{
+	const double mt = 1 - t;
+	const double d0 = 3 * mt * mt;
+	const double d1 = 6 * mt * t;
+	const double d2 = 3 * t * t;
+	return Point2({ d0 * (control1.x - start.x) + d1 * (control2.x - control1.x) + d2 * (end.x - control2.x),
+		d0 * (control1.y - start.y) + d1 * (control2.y - control1.y) + d2 * (end.y - control2.y) });
+}
+
+bool CubicBezier::operator==(const Segment& other) const
+{
+	auto curve = dynamic_cast<const CubicBezier*>(&other);
+	if (!curve) return false;
+	return start.isCloseTo(curve->start, EPS) &&
+		control1.isCloseTo(curve->control1, EPS) &&
+		control2.isCloseTo(curve->control2, EPS) &&
+		end.isCloseTo(curve->end, EPS);
+}
+
+void CubicBezier::print(const std::string& padding) const
+{
+	std::cout << padding << "CUBIC BEZIER\n";
+	std::cout << "  " << padding << "(" << start.x << ", " << start.y << ") - "
+		<< "(" << control1.x << ", " << control1.y << ") - "
+		<< "(" << control2.x << ", " << control2.y << ") - "
+		<< "(" << end.x << ", " << end.y << ")\n";
+}
+
+std::vector<Point2> CubicBezier::getLineStrip() const
+{
+	return getLineStrip(flatness);
+}
+
+std::vector<Point2> CubicBezier::getLineStrip(double tolerance) const
+{
+	std::vector<Point2> points{ start };
+	appendLineStrip(tolerance, points);
+	return points;
+}
+
+// Adaptive subdivision until a piece is flat enough for a few forward differencing steps
+void CubicBezier::appendLineStrip(double tolerance, std::vector<Point2>& out) const
+{
+	if (tolerance <= 0)
+	{
+		throw std::invalid_argument("tolerance must be positive and non zero");
+	}
+
+	std::vector<std::pair<Controls, int>> stack;
+	stack.emplace_back(Controls{ { start, control1, control2, end } }, 0);
+	while (!stack.empty())
+	{
+		const auto [piece, depth] = stack.back();
+		stack.pop_back();
+
+		const size_t n = stepCount(piece, tolerance);
+		if (n <= MAX_FORWARD_STEPS || depth >= MAX_SUBDIVISION_DEPTH)
+		{
+			forwardDifference(piece, n, out);
+			continue;
+		}
+		Controls left, right;
+		split(piece, left, right);
+		stack.emplace_back(right, depth + 1);
+		stack.emplace_back(left, depth + 1); // popped first, the strip stays in order
+	}
+}
+
+// The box spans the end points and the extremes where the derivative of either axis vanishes
+BoundingBox CubicBezier::getBounds() const
+{
+	BoundingBox box;
+	box.expand(start);
+	box.expand(end);
+
+	std::vector<double> roots;
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		const double p0 = axis == 0 ? start.x : start.y;
+		const double p1 = axis == 0 ? control1.x : control1.y;
+		const double p2 = axis == 0 ? control2.x : control2.y;
+		const double p3 = axis == 0 ? end.x : end.y;
+		// B'(t) / 3 = a t^2 + b t + c
+		unitRoots(-p0 + 3 * p1 - 3 * p2 + p3, 2 * (p0 - 2 * p1 + p2), p1 - p0, roots);
+	}
+	for (double t : roots)
+	{
+		box.expand(getCoordinate(t));
+	}
+	return box;
+}
+
+// Coarse sampling picks the basin, Newton's method on (B(t) - p) . B'(t) = 0 refines it
+double CubicBezier::getClosestParameter(const Point2& point) const
+{
+	auto distance2 = [&](double t)
+	{
+		const Point2 p = getCoordinate(t);
+		return (p.x - point.x) * (p.x - point.x) + (p.y - point.y) * (p.y - point.y);
+	};
+
+	constexpr int SAMPLES = 32;
+	double best_t = 0.0;
+	double best = std::numeric_limits<double>::max();
+	for (int i = 0; i <= SAMPLES; ++i)
+	{
+		const double t = static_cast<double>(i) / SAMPLES;
+		const double d = distance2(t);
+		if (d < best)
+		{
+			best = d;
+			best_t = t;
+		}
+	}
+
+	double t = best_t;
+	for (int iteration = 0; iteration < 8; ++iteration)
+	{
+		const Point2 p = getCoordinate(t);
+		const Point2 d1 = getDerivative(t);
+		const double mt = 1 - t;
+		// Second derivative
+		const double ddx = 6 * (mt * (control2.x - 2 * control1.x + start.x) + t * (end.x - 2 * control2.x + control1.x));
+		const double ddy = 6 * (mt * (control2.y - 2 * control1.y + start.y) + t * (end.y - 2 * control2.y + control1.y));
+		const double ex = p.x - point.x;
+		const double ey = p.y - point.y;
+		const double f = ex * d1.x + ey * d1.y;
+		const double df = d1.x * d1.x + d1.y * d1.y + ex * ddx + ey * ddy;
+		if (fabs(df) < EPS)
+		{
+			break;
+		}
+		const double next = std::clamp(t - f / df, 0.0, 1.0);
+		if (fabs(next - t) < EPS)
+		{
+			t = next;
+			break;
+		}
+		t = next;
+	}
+	return distance2(t) <= best ? t : best_t;
+}
@@ -0,0 +1,61 @@
+#include <Config.h>
+#include <DirectionCone.h>
+
+#include <algorithm>
+#include <cmath>
+
+void DirectionCone::reset(const Point2& anchor)
+{
+	_anchor = anchor;
+	_open = false;
+	_reach = 0.0;
+}
+
+double DirectionCone::relativeAngle(const Point2& point) const
+{
+	const double dx = point.x - _anchor.x;
+	const double dy = point.y - _anchor.y;
+	return std::atan2(_reference.x * dy - _reference.y * dx, _reference.x * dx + _reference.y * dy);
+}
+
+bool DirectionCone::admits(const Point2& point) const
+{
+	// The line must not fall short of the farthest point either
+	const double reach = std::hypot(point.x - _anchor.x, point.y - _anchor.y);
+	if (reach < _reach - _tolerance)
+	{
+		return false;
+	}
+	if (!_open)
+	{
+		return true;
+	}
+	const double angle = relativeAngle(point);
+	return angle >= _low && angle <= _high;
+}
+
+// Every point of the run constrains the line to pass within tolerance of it
+void DirectionCone::add(const Point2& point)
+{
+	const double dx = point.x - _anchor.x;
+	const double dy = point.y - _anchor.y;
+	const double d = std::sqrt(dx * dx + dy * dy);
+	_reach = std::max(_reach, d);
+	if (d <= _tolerance)
+	{
+		return;
+	}
+
+	const double half_width = std::asin(_tolerance / d);
+	if (!_open)
+	{
+		_reference = Point2({ dx / d, dy / d });
+		_low = -half_width;
+		_high = half_width;
+		_open = true;
+		return;
+	}
+	const double angle = relativeAngle(point);
+	_low = std::max(_low, angle - half_width);
+	_high = std::min(_high, angle + half_width);
+}
@@ -0,0 +1,234 @@
+#include <Config.h>
+#include <GCodeExport.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+	// Longest word formatted at once, letter and number
+	constexpr size_t MAX_WORD = 64;
+}
+
+GCodeSink::GCodeSink(std::ostream& out, const GCodeOptions& options)
+	: _out(out), _options(options), _buffer(std::max<size_t>(options.buffer_size, 4 * MAX_WORD))
+{
+	if (_options.program)
+	{
+		text("G90 G17");
+		endLine();
+	}
+}
+
+GCodeSink::~GCodeSink()
+{
+	flush();
+}
+
+void GCodeSink::push(const ContourElement& element)
+{
+	if (const Line2* line = std::get_if<Line2>(&element))
+	{
+		start(line->startPoint());
+		lineTo(line->endPoint());
+		return;
+	}
+	if (const Arc* arc = std::get_if<Arc>(&element))
+	{
+		// An Arc runs from start_angle to end_angle whatever forwards says, the sign of the sweep is the direction of travel
+		const double sweep = arc->getAngle(1.0) - arc->getAngle(0.0);
+		if (sweep == 0.0)
+		{
+			return;
+		}
+		start(arc->startPoint());
+		const Point2& end = arc->endPoint();
+		text(sweep < 0 ? "G2" : "G3");
+		word('X', end.x);
+		word('Y', end.y);
+		word('I', arc->getCenter().x - _position.x);
+		word('J', arc->getCenter().y - _position.y);
+		if (!_feed_written && _options.feed_rate > 0)
+		{
+			word('F', _options.feed_rate);
+			_feed_written = true;
+		}
+		endLine();
+		_position = end;
+		return;
+	}
+	const std::vector<Point2> pts = std::visit([](const auto& seg) { return seg.getLineStrip(); }, element);
+	if (pts.empty())
+	{
+		return;
+	}
+	start(pts.front());
+	for (size_t i = 1; i < pts.size(); ++i)
+	{
+		if (!pts[i].isCloseTo(_position, EPS))
+		{
+			lineTo(pts[i]);
+		}
+	}
+}
+
+void GCodeSink::finish()
+{
+	if (_finished)
+	{
+		return;
+	}
+	_finished = true;
+	if (_options.use_z && _has_position)
+	{
+		text("G0");
+		word('Z', _options.safe_z);
+		endLine();
+	}
+	if (_options.program)
+	{
+		text("M2");
+		endLine();
+	}
+	flush();
+	_out.flush();
+}
+
+// Rapid move to point unless the tool is already there
+void GCodeSink::start(const Point2& point)
+{
+	if (_has_position && point.isCloseTo(_position, EPS))
+	{
+		return;
+	}
+	if (_options.use_z)
+	{
+		text("G0");
+		word('Z', _options.safe_z);
+		endLine();
+	}
+	text("G0");
+	word('X', point.x);
+	word('Y', point.y);
+	endLine();
+	if (_options.use_z)
+	{
+		text("G1");
+		word('Z', _options.cut_z);
+		if (!_feed_written && _options.feed_rate > 0)
+		{
+			word('F', _options.feed_rate);
+			_feed_written = true;
+		}
+		endLine();
+	}
+	_position = point;
+	_has_position = true;
+}
+
+void GCodeSink::lineTo(const Point2& point)
+{
+	text("G1");
+	word('X', point.x);
+	word('Y', point.y);
+	if (!_feed_written && _options.feed_rate > 0)
+	{
+		word('F', _options.feed_rate);
+		_feed_written = true;
+	}
+	endLine();
+	_position = point;
+}
+
+void GCodeSink::word(char letter, double value)
+{
+	reserve(MAX_WORD);
+	char* first = _buffer.data() + _used;
+	char* last = first + MAX_WORD;
+	*first++ = ' ';
+	*first++ = letter;
+	auto result = std::to_chars(first, last, value, std::chars_format::fixed, static_cast<int>(_options.precision));
+	if (result.ec != std::errc())
+	{
+		// Too many digits in fixed notation, the shortest form always fits
+		result = std::to_chars(first, last, value);
+	}
+	char* end = result.ptr;
+	if (std::find(first, end, '.') != end && std::find(first, end, 'e') == end)
+	{
+		while (end[-1] == '0') --end;
+		if (end[-1] == '.') --end;
+	}
+	if (end - first == 2 && first[0] == '-' && first[1] == '0')
+	{
+		// Rounded to -0
+		*first = '0';
+		end = first + 1;
+	}
+	_used = static_cast<size_t>(end - _buffer.data());
+}
+
+void GCodeSink::text(const char* value)
+{
+	const size_t length = std::strlen(value);
+	reserve(length);
+	std::memcpy(_buffer.data() + _used, value, length);
+	_used += length;
+}
+
+void GCodeSink::endLine()
+{
+	reserve(1);
+	_buffer[_used++] = '\n';
+}
+
+void GCodeSink::reserve(size_t bytes)
+{
+	if (_used + bytes > _buffer.size())
+	{
+		flush();
+	}
+}
+
+void GCodeSink::flush()
+{
+	if (_used > 0)
+	{
+		_out.write(_buffer.data(), static_cast<std::streamsize>(_used));
+		_used = 0;
+	}
+}
+
+void exportContourToGCode(const Contour& contour, const std::string& filename, const GCodeOptions& options)
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open file.");
+	}
+	GCodeSink sink(file, options);
+	for (const auto& e : contour.getElements())
+	{
+		sink.push(e);
+	}
+	sink.finish();
+}
+
+void exportContoursToGCode(const std::vector<Contour>& contours, const std::vector<std::string>& filenames, const GCodeOptions& options)
+{
+	if (contours.size() != filenames.size())
+	{
+		throw std::invalid_argument("one filename per contour is required");
+	}
+	parallelFor(contours.size(), options.num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			exportContourToGCode(contours[i], filenames[i], options);
+		}
+	});
+}
@@ -0,0 +1,245 @@
+#include <Config.h>
+#include <IndexedContour.h>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+	// Line2 refuses end points closer than EPS in both coordinates
+	bool lineFits(const Point2& a, const Point2& b)
+	{
+		return fabs(a.x - b.x) >= EPS || fabs(a.y - b.y) >= EPS;
+	}
+}
+
+IndexedContour::IndexedContour(const std::vector<Point2>& points, bool closed)
+{
+	_vertices.reserve(points.size());
+	_records.reserve(points.size());
+	for (const auto& p : points)
+	{
+		addPoint(p);
+	}
+	if (closed)
+	{
+		close();
+	}
+}
+
+IndexedContour::IndexedContour(const std::vector<ContourElement>& elements, double tolerance)
+{
+	_vertices.reserve(elements.size() + 1);
+	_records.reserve(elements.size());
+	for (const auto& e : elements)
+	{
+		addElement(e, tolerance);
+	}
+	// A single Line2 cannot be closed, a full circle can
+	if (_vertices.size() > 1 && (_records.size() > 1 || (_records[0] & CURVE)) && _vertices.back().isCloseTo(_vertices.front(), tolerance))
+	{
+		close(tolerance);
+	}
+}
+
+IndexedContour::IndexedContour(const Contour& contour, double tolerance)
+	: IndexedContour(contour.getElements(), tolerance)
+{
+}
+
+void IndexedContour::addPoint(const Point2& point)
+{
+	if (_closed)
+	{
+		throw std::invalid_argument("cannot extend a closed contour");
+	}
+	if (!_vertices.empty() && !lineFits(_vertices.back(), point))
+	{
+		return;
+	}
+	if (!_vertices.empty())
+	{
+		_records.push_back(0);
+	}
+	_vertices.push_back(point);
+}
+
+void IndexedContour::addElement(const ContourElement& element, double tolerance)
+{
+	if (_closed)
+	{
+		throw std::invalid_argument("cannot extend a closed contour");
+	}
+	append(element, tolerance);
+}
+
+void IndexedContour::append(const ContourElement& element, double tolerance)
+{
+	const Segment& segment = asSegment(element);
+	if (_vertices.empty())
+	{
+		_vertices.push_back(segment.startPoint());
+	}
+	else if (!segment.startPoint().isCloseTo(_vertices.back(), tolerance))
+	{
+		throw std::invalid_argument("element does not start at the end of the contour");
+	}
+
+	if (const Line2* line = std::get_if<Line2>(&element))
+	{
+		if (!lineFits(_vertices.back(), line->endPoint()))
+		{
+			throw std::invalid_argument("Line2 collapses onto the shared vertex");
+		}
+		_records.push_back(line->isForwards() ? 0 : REVERSED);
+		_vertices.push_back(line->endPoint());
+		return;
+	}
+
+	// The curve's own start point becomes the joint unless a curve already owns it
+	if (_records.empty() || (_records.back() & CURVE) == 0)
+	{
+		if (_vertices.size() > 1 && !lineFits(_vertices[_vertices.size() - 2], segment.startPoint()))
+		{
+			throw std::invalid_argument("Line2 collapses onto the shared vertex");
+		}
+		_vertices.back() = segment.startPoint();
+	}
+	else if (!segment.startPoint().isCloseTo(_vertices.back(), EPS))
+	{
+		// Both curves keep their own end points, a wider gap would survive into the elements
+		throw std::invalid_argument("consecutive curves do not meet within EPS");
+	}
+	if (_curves.size() >= REVERSED)
+	{
+		throw std::length_error("too many curves in an IndexedContour");
+	}
+	_records.push_back(CURVE | static_cast<uint32_t>(_curves.size()));
+	_curves.push_back(element);
+	_vertices.push_back(segment.endPoint());
+}
+
+void IndexedContour::close(double tolerance)
+{
+	if (_closed || _records.empty())
+	{
+		return;
+	}
+	const Point2 last = _vertices.back();
+	// Two curves can only share the joint if their own end points already meet
+	const bool curves = (_records.back() & CURVE) && (_records.front() & CURVE);
+	if (last.isCloseTo(_vertices.front(), curves ? EPS : tolerance))
+	{
+		if (_records.size() == 1 && (_records[0] & CURVE) == 0)
+		{
+			throw std::invalid_argument("a single Line2 cannot be closed");
+		}
+		// Share the first vertex, a curve ending the chain owns it unless a curve starts the chain
+		_vertices.pop_back();
+		if ((_records.back() & CURVE) && (_records.front() & CURVE) == 0)
+		{
+			_vertices.front() = last;
+		}
+	}
+	else
+	{
+		if (!lineFits(last, _vertices.front()))
+		{
+			throw std::invalid_argument("closing Line2 collapses onto the first vertex");
+		}
+		_records.push_back(0);
+	}
+	_closed = true;
+}
+
+ContourElement IndexedContour::element(size_t index) const
+{
+	if (index >= _records.size())
+	{
+		throw std::out_of_range("IndexedContour index out of range");
+	}
+	const uint32_t record = _records[index];
+	if (record & CURVE)
+	{
+		return _curves[record & ~(CURVE | REVERSED)];
+	}
+	const Point2& a = _vertices[index];
+	const Point2& b = _vertices[endVertex(index)];
+	if (record & REVERSED)
+	{
+		return Line2(b, a, false);
+	}
+	return Line2(a, b);
+}
+
+std::vector<ContourElement> IndexedContour::elements() const
+{
+	std::vector<ContourElement> result;
+	result.reserve(_records.size());
+	for (size_t i = 0; i < _records.size(); ++i)
+	{
+		result.push_back(element(i));
+	}
+	return result;
+}
+
+Contour IndexedContour::toContour() const
+{
+	Contour contour;
+	contour.addItems(elements());
+	return contour;
+}
+
+std::vector<Point2> IndexedContour::getLineStrip() const
+{
+	if (_curves.empty())
+	{
+		std::vector<Point2> strip = _vertices;
+		if (_closed)
+		{
+			strip.push_back(_vertices.front());
+		}
+		return strip;
+	}
+
+	std::vector<Point2> strip;
+	strip.reserve(_vertices.size() + 1);
+	if (!_vertices.empty())
+	{
+		strip.push_back(_vertices.front());
+	}
+	for (size_t i = 0; i < _records.size(); ++i)
+	{
+		if (_records[i] & CURVE)
+		{
+			const std::vector<Point2> pts = std::visit([](const auto& seg) { return seg.getLineStrip(); },
+				_curves[_records[i] & ~(CURVE | REVERSED)]);
+			for (size_t j = 1; j + 1 < pts.size(); ++j)
+			{
+				strip.push_back(pts[j]);
+			}
+		}
+		strip.push_back(_vertices[endVertex(i)]);
+	}
+	return strip;
+}
+
+BoundingBox IndexedContour::getBounds() const
+{
+	BoundingBox box;
+	for (const auto& v : _vertices)
+	{
+		box.expand(v);
+	}
+	for (const auto& c : _curves)
+	{
+		box.expand(std::visit([](const auto& seg) { return seg.getBounds(); }, c));
+	}
+	return box;
+}
+
+size_t IndexedContour::memoryUsage() const
+{
+	return _vertices.capacity() * sizeof(Point2) + _records.capacity() * sizeof(uint32_t) +
+		_curves.capacity() * sizeof(ContourElement);
+}
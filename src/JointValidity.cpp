@@ -0,0 +1,49 @@
+#include <Config.h>
+#include <JointValidity.h>
+#include <Parallel.h>
+
+#include <algorithm>
+
+size_t firstOpenJoint(const double* end_x, const double* end_y, const double* start_x, const double* start_y,
+	size_t count, double tolerance)
+{
+	constexpr size_t BLOCK = 64;
+	const double limit = tolerance * tolerance;
+	for (size_t first = 0; first < count; first += BLOCK)
+	{
+		const size_t last = std::min(count, first + BLOCK);
+		unsigned int open = 0;
+		for (size_t i = first; i < last; ++i)
+		{
+			const double dx = start_x[i] - end_x[i];
+			const double dy = start_y[i] - end_y[i];
+			open |= !(dx * dx + dy * dy < limit); // NaN counts as open, like isCloseTo
+		}
+		if (open)
+		{
+			for (size_t i = first; i < last; ++i)
+			{
+				const double dx = start_x[i] - end_x[i];
+				const double dy = start_y[i] - end_y[i];
+				if (!(dx * dx + dy * dy < limit))
+				{
+					return i;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+std::vector<uint8_t> validateContours(const std::vector<Contour>& contours, unsigned int num_threads)
+{
+	std::vector<uint8_t> result(contours.size());
+	parallelFor(contours.size(), num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			result[i] = contours[i].isValid() ? 1 : 0;
+		}
+	});
+	return result;
+}
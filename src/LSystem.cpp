@@ -0,0 +1,177 @@
+#include <Config.h>
+#include <LSystem.h>
+
+#include <limits>
+
+namespace
+{
+	// Appends to a Contour through addItems, one lock per batch instead of one per element
+	class BatchingContourSink : public ContourSink {
+	public:
+		explicit BatchingContourSink(Contour& contour)
+			: _contour(contour)
+		{
+			_batch.reserve(BATCH_SIZE);
+		}
+
+		void push(const ContourElement& element) override
+		{
+			_batch.push_back(element);
+			if (_batch.size() == BATCH_SIZE)
+			{
+				finish();
+			}
+		}
+
+		void finish() override
+		{
+			_contour.addItems(_batch);
+			_batch.clear();
+		}
+
+	private:
+		static constexpr size_t BATCH_SIZE = 4096;
+		Contour& _contour;
+		std::vector<ContourElement> _batch;
+	};
+}
+
+LSystem::LSystem(std::string axiom)
+	: _axiom(std::move(axiom))
+{
+}
+
+LSystem& LSystem::addRule(char symbol, std::string replacement)
+{
+	const unsigned char index = static_cast<unsigned char>(symbol);
+	_rules[index] = std::move(replacement);
+	_has_rule[index] = true;
+	return *this;
+}
+
+uint64_t LSystem::length(unsigned int iterations) const
+{
+	// lengths[s] is the length of symbol s after the current number of rewrites, saturating instead of overflowing
+	std::array<uint64_t, 256> lengths;
+	lengths.fill(1);
+	for (unsigned int i = 0; i < iterations; ++i)
+	{
+		std::array<uint64_t, 256> next = lengths;
+		for (size_t s = 0; s < 256; ++s)
+		{
+			if (!_has_rule[s])
+			{
+				continue;
+			}
+			uint64_t total = 0;
+			for (char c : _rules[s])
+			{
+				const uint64_t add = lengths[static_cast<unsigned char>(c)];
+				total = (add > std::numeric_limits<uint64_t>::max() - total) ? std::numeric_limits<uint64_t>::max() : total + add;
+			}
+			next[s] = total;
+		}
+		lengths = next;
+	}
+
+	uint64_t total = 0;
+	for (char c : _axiom)
+	{
+		const uint64_t add = lengths[static_cast<unsigned char>(c)];
+		total = (add > std::numeric_limits<uint64_t>::max() - total) ? std::numeric_limits<uint64_t>::max() : total + add;
+	}
+	return total;
+}
+
+std::string LSystem::expandToString(unsigned int iterations) const
+{
+	std::string result;
+	expand(iterations, [&](char symbol) { result.push_back(symbol); });
+	return result;
+}
+
+Turtle::Turtle(ContourSink& sink, const TurtleOptions& options)
+	: _sink(sink), _options(options), _position(options.start), _heading(options.heading)
+{
+	// Lookup table, interpret runs once per symbol of strings with billions of symbols
+	auto set = [&](char symbol, Command command) { _commands[static_cast<unsigned char>(symbol)] = command; };
+	for (char c : options.draw) set(c, Command::Draw);
+	for (char c : options.move) set(c, Command::Move);
+	set(options.turn_left, Command::Left);
+	set(options.turn_right, Command::Right);
+	set(options.turn_around, Command::Around);
+	set(options.push, Command::Push);
+	set(options.pop, Command::Pop);
+	set(options.arc_left, Command::ArcLeft);
+	set(options.arc_right, Command::ArcRight);
+}
+
+void Turtle::interpret(char symbol)
+{
+	switch (_commands[static_cast<unsigned char>(symbol)])
+	{
+	case Command::None:
+		break;
+	case Command::Draw:
+	case Command::Move:
+	{
+		const Point2 next({ _position.x + _options.step * std::cos(_heading), _position.y + _options.step * std::sin(_heading) });
+		if (_commands[static_cast<unsigned char>(symbol)] == Command::Draw)
+		{
+			_sink.push(Line2(_position, next));
+			++_count;
+		}
+		_position = next;
+		break;
+	}
+	case Command::Left:
+		_heading += _options.angle;
+		break;
+	case Command::Right:
+		_heading -= _options.angle;
+		break;
+	case Command::Around:
+		_heading += PI;
+		break;
+	case Command::Push:
+		_saved.emplace_back(_position, _heading);
+		break;
+	case Command::Pop:
+		if (!_saved.empty())
+		{
+			_position = _saved.back().first;
+			_heading = _saved.back().second;
+			_saved.pop_back();
+		}
+		break;
+	case Command::ArcLeft:
+	case Command::ArcRight:
+	{
+		// The center lies a step to the side the turtle turns to, the arc starts at the turtle
+		const double side = (_commands[static_cast<unsigned char>(symbol)] == Command::ArcLeft) ? 1.0 : -1.0;
+		const double r = _options.step;
+		const Point2 center({ _position.x - side * r * std::sin(_heading), _position.y + side * r * std::cos(_heading) });
+		const double start = _heading - side * 0.5 * PI;
+		const Arc arc(center, r, start, start + side * _options.angle, _options.arc_resolution);
+		_sink.push(arc);
+		++_count;
+		_position = arc.getCoordinate(1.0); // exactly where the arc ends, so the next element joins it
+		_heading += side * _options.angle;
+		break;
+	}
+	}
+}
+
+size_t generateLSystem(const LSystem& system, unsigned int iterations, ContourSink& sink, const TurtleOptions& options)
+{
+	Turtle turtle(sink, options);
+	system.expand(iterations, [&](char symbol) { turtle.interpret(symbol); });
+	sink.finish();
+	return turtle.elementCount();
+}
+
+size_t generateLSystem(const LSystem& system, unsigned int iterations, Contour& contour, const TurtleOptions& options)
+{
+	BatchingContourSink sink(contour);
+	return generateLSystem(system, iterations, sink, options);
+}
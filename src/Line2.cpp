@@ -9,24 +9,25 @@ Line2::Line2(Point2 s, Point2 e, bool fw)
 	if (fabs(start.x - end.x) < EPS && fabs(start.y - end.y) < EPS) {
 		throw std::invalid_argument("Line2 start and end points are the same");
 	}
+	cacheEndpoints();
 }
 // Gets coordinate on Line2, t<-[0,1]
 Point2 Line2::getCoordinate(double t) const
 {
 	Point2 p1;
 	/*
-	 * Please note: According to IEEE 754, precision is not an issue here, if t=0 or 1, we are at start or end.
-	  The "problem" occur when we use fractions, for instance 0.333333... cannot be represented exactly in binary form.
+	 * Please note: start + (end - start) * t can miss end by an ulp at t=1, so the weights are applied to both points.
+	  That way t=0 and t=1 give start and end exactly and joints built from the same points compare equal.
 	 */
 	if ((this)->forwards)
 	{
-		p1.x = start.x + (end.x - start.x) * t;
-		p1.y = start.y + (end.y - start.y) * t;
+		p1.x = start.x * (1 - t) + end.x * t;
+		p1.y = start.y * (1 - t) + end.y * t;
 	}
 	else
 	{
-		p1.x = end.x + (start.x - end.x) * t;
-		p1.y = end.y + (start.y - end.y) * t;
+		p1.x = end.x * (1 - t) + start.x * t;
+		p1.y = end.y * (1 - t) + start.y * t;
 	}
 	return p1;
 }
@@ -57,3 +58,26 @@ void Line2::print(const std::string& padding) const {
 std::vector<Point2> Line2::getLineStrip() const {
 	return std::vector{ Point2({ start.x, start.y }), Point2({ end.x,end.y }) };
 }
+
+BoundingBox Line2::getBounds() const {
+	BoundingBox box;
+	box.expand(start);
+	box.expand(end);
+	return box;
+}
+
+// Projection of point onto the line, clamped to the segment
+double Line2::getClosestParameter(const Point2& point) const {
+	const Point2 a = getCoordinate(0.0);
+	const Point2 b = getCoordinate(1.0);
+	const double abx = b.x - a.x;
+	const double aby = b.y - a.y;
+	const double t = ((point.x - a.x) * abx + (point.y - a.y) * aby) / (abx * abx + aby * aby);
+	return std::clamp(t, 0.0, 1.0);
+}
+
+Line2 Line2::reversed() const
+{
+	// The stored points swap, getLineStrip lists them in stored order
+	return Line2(endPoint(), startPoint());
+}
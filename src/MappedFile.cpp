@@ -0,0 +1,86 @@
+#include <Config.h>
+#include <MappedFile.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filename)
+{
+#ifndef _WIN32
+	const int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw std::runtime_error("Failed to open file.");
+	}
+	struct stat info;
+	if (::fstat(fd, &info) != 0)
+	{
+		::close(fd);
+		throw std::runtime_error("Failed to open file.");
+	}
+	_size = static_cast<size_t>(info.st_size);
+	if (_size > 0)
+	{
+		void* address = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address != MAP_FAILED)
+		{
+			::madvise(address, _size, MADV_SEQUENTIAL);
+			_data = static_cast<const char*>(address);
+			_mapped = true;
+		}
+	}
+	::close(fd);
+	if (_mapped || _size == 0)
+	{
+		return;
+	}
+#endif
+	// Fallback: read the whole file
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open file.");
+	}
+	_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	_data = _buffer.data();
+	_size = _buffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+	if (_mapped)
+	{
+		::munmap(const_cast<char*>(_data), _size);
+	}
+#endif
+}
+
+void MappedFile::release(size_t end)
+{
+#ifndef _WIN32
+	if (!_mapped)
+	{
+		return;
+	}
+	const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+	const size_t first = (_released + page - 1) / page * page;
+	const size_t last = std::min(end, _size) / page * page;
+	if (last > first)
+	{
+		::madvise(const_cast<char*>(_data) + first, last - first, MADV_DONTNEED);
+		_released = last;
+	}
+#else
+	(void)end;
+#endif
+}
@@ -0,0 +1,498 @@
+#include <Config.h>
+#include <MarchingSquares.h>
+#include <ContourRepair.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+	constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+	// Edge 2 (j * width + i) runs from sample (i, j) to (i + 1, j), edge 2 (j * width + i) + 1 to (i, j + 1).
+	// An isoline crosses each edge at most once, so a chain is the list of edges it crosses.
+	struct Chain {
+		std::vector<uint64_t> edges;
+		bool closed = false; // edges.front() == edges.back()
+	};
+
+	struct Segment {
+		uint32_t from; // tile local edges
+		uint32_t to;
+	};
+
+	class Field {
+	public:
+		Field(const std::vector<double>& values, const DistanceFieldGrid& grid)
+			: _values(values.data()), _grid(grid)
+		{
+		}
+
+		double at(size_t i, size_t j) const { return _values[j * _grid.width + i]; }
+
+		// Interpolated from the lower sample of the edge whichever cell asks, so neighbouring tiles agree exactly
+		Point2 crossing(uint64_t edge, double level) const
+		{
+			const size_t sample = static_cast<size_t>(edge / 2);
+			const size_t i = sample % _grid.width;
+			const size_t j = sample / _grid.width;
+			const double a = _values[sample];
+			const double b = (edge % 2 == 0) ? _values[sample + 1] : _values[sample + _grid.width];
+			const double t = (level - a) / (b - a);
+			if (edge % 2 == 0)
+			{
+				return Point2({ _grid.origin.x + (i + t) * _grid.spacing, _grid.origin.y + j * _grid.spacing });
+			}
+			return Point2({ _grid.origin.x + i * _grid.spacing, _grid.origin.y + (j + t) * _grid.spacing });
+		}
+
+	private:
+		const double* _values;
+		const DistanceFieldGrid& _grid;
+	};
+
+	// Cells [x0, x1) x [y0, y1) traced for every level in one pass
+	class TileTracer {
+	public:
+		TileTracer(const Field& field, size_t width, size_t x0, size_t y0, size_t x1, size_t y1, size_t num_levels)
+			: _field(field), _width(width), _x0(x0), _y0(y0), _stride(x1 - x0 + 1), _x1(x1), _y1(y1),
+			_segments(num_levels), _next(2 * _stride * (y1 - y0 + 1), NONE), _has_previous(_next.size(), 0)
+		{
+		}
+
+		std::vector<std::vector<Chain>> trace(const std::vector<double>& levels)
+		{
+			for (size_t j = _y0; j < _y1; ++j)
+			{
+				for (size_t i = _x0; i < _x1; ++i)
+				{
+					const double v[4] = { _field.at(i, j), _field.at(i + 1, j), _field.at(i + 1, j + 1), _field.at(i, j + 1) };
+					if (std::isnan(v[0]) || std::isnan(v[1]) || std::isnan(v[2]) || std::isnan(v[3]))
+					{
+						continue;
+					}
+					const double low = std::min(std::min(v[0], v[1]), std::min(v[2], v[3]));
+					const double high = std::max(std::max(v[0], v[1]), std::max(v[2], v[3]));
+					// Edges counter clockwise, edge k joins corner k to corner k + 1
+					const uint32_t edges[4] = { local(i, j, 0), local(i + 1, j, 1), local(i, j + 1, 0), local(i, j, 1) };
+					for (size_t k = 0; k < levels.size(); ++k)
+					{
+						if (levels[k] <= low || levels[k] > high)
+						{
+							continue;
+						}
+						cell(v, edges, levels[k], _segments[k]);
+					}
+				}
+			}
+
+			std::vector<std::vector<Chain>> chains(levels.size());
+			for (size_t k = 0; k < levels.size(); ++k)
+			{
+				link(_segments[k], chains[k]);
+			}
+			return chains;
+		}
+
+	private:
+		uint32_t local(size_t i, size_t j, uint32_t direction) const
+		{
+			return static_cast<uint32_t>(2 * ((j - _y0) * _stride + (i - _x0))) + direction;
+		}
+
+		uint64_t global(uint32_t edge) const
+		{
+			const size_t sample = edge / 2;
+			return 2 * static_cast<uint64_t>((_y0 + sample / _stride) * _width + _x0 + sample % _stride) + edge % 2;
+		}
+
+		// Walking the cell counter clockwise, an isoline leaves where the walk exits the region at or above the level
+		// and ends where the walk re-enters it, which keeps that region on its left. Saddles are split by the center value.
+		static void cell(const double (&v)[4], const uint32_t (&edges)[4], double level, std::vector<Segment>& out)
+		{
+			uint32_t crossings[4];
+			bool exits[4];
+			size_t count = 0;
+			for (size_t k = 0; k < 4; ++k)
+			{
+				const bool inside = v[k] >= level;
+				if (inside != (v[(k + 1) % 4] >= level))
+				{
+					crossings[count] = edges[k];
+					exits[count] = inside;
+					++count;
+				}
+			}
+			if (count == 2)
+			{
+				const size_t exit = exits[0] ? 0 : 1;
+				out.push_back(Segment{ crossings[exit], crossings[1 - exit] });
+				return;
+			}
+			// Four crossings alternate, the region of the center is connected through the cell
+			const bool center_inside = (v[0] + v[1] + v[2] + v[3]) / 4 >= level;
+			for (size_t c = 0; c < 4; ++c)
+			{
+				if (exits[c])
+				{
+					out.push_back(Segment{ crossings[c], crossings[center_inside ? (c + 1) % 4 : (c + 3) % 4] });
+				}
+			}
+		}
+
+		void link(std::vector<Segment>& segments, std::vector<Chain>& chains)
+		{
+			for (const auto& s : segments)
+			{
+				_next[s.from] = s.to;
+				_has_previous[s.to] = 1;
+			}
+			auto walk = [&](uint32_t first, bool closed)
+			{
+				Chain chain;
+				chain.closed = closed;
+				chain.edges.push_back(global(first));
+				for (uint32_t edge = first; _next[edge] != NONE;)
+				{
+					const uint32_t next = _next[edge];
+					_next[edge] = NONE;
+					chain.edges.push_back(global(next));
+					edge = next;
+				}
+				chains.push_back(std::move(chain));
+			};
+			// Chains that start at the tile border, then loops
+			for (const auto& s : segments)
+			{
+				if (!_has_previous[s.from])
+				{
+					walk(s.from, false);
+				}
+			}
+			for (const auto& s : segments)
+			{
+				if (_next[s.from] != NONE)
+				{
+					walk(s.from, true);
+				}
+			}
+			for (const auto& s : segments)
+			{
+				_has_previous[s.to] = 0;
+			}
+			segments.clear();
+			segments.shrink_to_fit();
+		}
+
+		const Field& _field;
+		size_t _width;
+		size_t _x0;
+		size_t _y0;
+		size_t _stride;
+		size_t _x1;
+		size_t _y1;
+		std::vector<std::vector<Segment>> _segments;
+		std::vector<uint32_t> _next;
+		std::vector<char> _has_previous;
+	};
+
+	// Joins chains that end on a tile border to the chain that continues in the neighbouring tile
+	std::vector<Chain> stitch(std::vector<Chain>& open)
+	{
+		std::unordered_map<uint64_t, size_t> by_first;
+		std::unordered_set<uint64_t> lasts;
+		by_first.reserve(open.size());
+		lasts.reserve(open.size());
+		for (size_t c = 0; c < open.size(); ++c)
+		{
+			by_first.emplace(open[c].edges.front(), c);
+			lasts.insert(open[c].edges.back());
+		}
+
+		std::vector<Chain> stitched;
+		std::vector<char> used(open.size(), 0);
+		auto walk = [&](size_t first)
+		{
+			Chain chain = std::move(open[first]);
+			used[first] = 1;
+			for (auto it = by_first.find(chain.edges.back()); it != by_first.end(); it = by_first.find(chain.edges.back()))
+			{
+				if (it->second == first)
+				{
+					chain.closed = true;
+					break;
+				}
+				if (used[it->second])
+				{
+					break;
+				}
+				used[it->second] = 1;
+				const auto& more = open[it->second].edges;
+				chain.edges.insert(chain.edges.end(), more.begin() + 1, more.end());
+			}
+			stitched.push_back(std::move(chain));
+		};
+		for (size_t c = 0; c < open.size(); ++c)
+		{
+			if (!used[c] && lasts.count(open[c].edges.front()) == 0)
+			{
+				walk(c);
+			}
+		}
+		for (size_t c = 0; c < open.size(); ++c)
+		{
+			if (!used[c])
+			{
+				walk(c);
+			}
+		}
+		return stitched;
+	}
+
+	bool circleThrough(const Point2& a, const Point2& b, const Point2& c, Point2& center, double& radius)
+	{
+		const double bx = b.x - a.x, by = b.y - a.y;
+		const double cx = c.x - a.x, cy = c.y - a.y;
+		const double d = 2 * (bx * cy - by * cx);
+		if (fabs(d) < EPS)
+		{
+			return false;
+		}
+		const double b2 = bx * bx + by * by;
+		const double c2 = cx * cx + cy * cy;
+		const double ux = (cy * b2 - by * c2) / d;
+		const double uy = (bx * c2 - cx * b2) / d;
+		center = Point2({ a.x + ux, a.y + uy });
+		radius = std::hypot(ux, uy);
+		return true;
+	}
+
+	// Arc through points[first] and points[last] that all points in between lie on within tolerance, turning one way
+	std::optional<Arc> fitArc(const std::vector<Point2>& points, size_t first, size_t last, double tolerance)
+	{
+		Point2 center;
+		double radius;
+		if (!circleThrough(points[first], points[(first + last) / 2], points[last], center, radius))
+		{
+			return std::nullopt;
+		}
+		double sweep = 0.0;
+		for (size_t k = first; k <= last; ++k)
+		{
+			const double dx = points[k].x - center.x, dy = points[k].y - center.y;
+			if (fabs(std::hypot(dx, dy) - radius) > tolerance)
+			{
+				return std::nullopt;
+			}
+			if (k < last)
+			{
+				const double ex = points[k + 1].x - center.x, ey = points[k + 1].y - center.y;
+				const double turn = atan2(dx * ey - dy * ex, dx * ex + dy * ey);
+				if (turn == 0.0 || (sweep != 0.0 && (turn > 0) != (sweep > 0)))
+				{
+					return std::nullopt;
+				}
+				sweep += turn;
+			}
+		}
+		// A run that stays within tolerance of its chord is better left to lines, so is a full circle
+		if (radius * (1 - cos(sweep / 2)) <= tolerance || fabs(sweep) >= 2 * PI - 1E-6)
+		{
+			return std::nullopt;
+		}
+		const double start = atan2(points[first].y - center.y, points[first].x - center.x);
+		return Arc(center, radius, start, start + sweep);
+	}
+
+	std::optional<Contour> buildContour(const Field& field, const Chain& chain, double level, const IsolineOptions& options,
+		double spacing)
+	{
+		std::vector<Point2> points;
+		points.reserve(chain.edges.size());
+		for (uint64_t edge : chain.edges)
+		{
+			const Point2 p = field.crossing(edge, level);
+			// Crossings on a sample that equals the level coincide
+			if (points.empty() || fabs(p.x - points.back().x) >= EPS || fabs(p.y - points.back().y) >= EPS)
+			{
+				points.push_back(p);
+			}
+		}
+		if (points.size() < 2)
+		{
+			return std::nullopt;
+		}
+
+		std::vector<ContourElement> elements;
+		elements.reserve(points.size());
+		if (!options.fit_arcs)
+		{
+			for (size_t k = 0; k + 1 < points.size(); ++k)
+			{
+				elements.push_back(Line2(points[k], points[k + 1]));
+			}
+			Contour contour;
+			contour.addItems(elements);
+			return contour;
+		}
+
+		// Longest arc from each point, found by doubling the run and bisecting
+		const double tolerance = options.arc_tolerance * spacing;
+		const size_t shortest = std::max<size_t>(options.min_arc_points, 3) - 1;
+		for (size_t k = 0; k + 1 < points.size();)
+		{
+			std::optional<Arc> arc;
+			size_t good = 0;
+			size_t bad = shortest;
+			while (k + bad < points.size())
+			{
+				std::optional<Arc> fit = fitArc(points, k, k + bad, tolerance);
+				if (!fit)
+				{
+					break;
+				}
+				arc = fit;
+				good = bad;
+				bad *= 2;
+			}
+			if (!arc)
+			{
+				elements.push_back(Line2(points[k], points[k + 1]));
+				++k;
+				continue;
+			}
+			bad = std::min(bad, points.size() - k);
+			while (bad - good > 1)
+			{
+				const size_t middle = (good + bad) / 2;
+				if (std::optional<Arc> fit = fitArc(points, k, k + middle, tolerance))
+				{
+					arc = fit;
+					good = middle;
+				}
+				else
+				{
+					bad = middle;
+				}
+			}
+			elements.push_back(*arc);
+			k += good;
+		}
+
+		// Arc ends are computed from the circle and miss the crossings by rounding, repair makes the joints meet
+		Contour contour;
+		contour.addItems(elements);
+		RepairOptions repair;
+		repair.snap_tolerance = 1E-6 * spacing;
+		repair.close = chain.closed;
+		return repairContour(contour, repair);
+	}
+}
+
+std::vector<std::vector<Contour>> extractIsolines(const std::vector<double>& values, const DistanceFieldGrid& grid,
+	const std::vector<double>& levels, const IsolineOptions& options)
+{
+	if (grid.width < 2 || grid.height < 2)
+	{
+		throw std::invalid_argument("grid needs at least 2 x 2 samples");
+	}
+	if (values.size() != grid.width * grid.height)
+	{
+		throw std::invalid_argument("values do not match the grid size");
+	}
+	if (grid.spacing <= 0)
+	{
+		throw std::invalid_argument("grid spacing must be positive and non zero");
+	}
+	if (options.tile_size == 0 || 2 * (options.tile_size + 1) * (options.tile_size + 1) >= NONE)
+	{
+		throw std::invalid_argument("tile size out of range");
+	}
+	if (options.fit_arcs && options.arc_tolerance <= 0)
+	{
+		throw std::invalid_argument("arc tolerance must be positive and non zero");
+	}
+
+	const Field field(values, grid);
+	const size_t cells_x = grid.width - 1;
+	const size_t cells_y = grid.height - 1;
+	const size_t tiles_x = (cells_x + options.tile_size - 1) / options.tile_size;
+	const size_t tiles_y = (cells_y + options.tile_size - 1) / options.tile_size;
+
+	// tile_chains[tile][level]
+	std::vector<std::vector<std::vector<Chain>>> tile_chains(tiles_x * tiles_y);
+	parallelFor(tile_chains.size(), options.num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t t = first; t < last; ++t)
+		{
+			const size_t x0 = (t % tiles_x) * options.tile_size;
+			const size_t y0 = (t / tiles_x) * options.tile_size;
+			TileTracer tracer(field, grid.width, x0, y0, std::min(cells_x, x0 + options.tile_size),
+				std::min(cells_y, y0 + options.tile_size), levels.size());
+			tile_chains[t] = tracer.trace(levels);
+		}
+	});
+
+	// Loops that stay inside a tile are done, the rest is stitched per level
+	struct Job {
+		size_t level;
+		Chain chain;
+	};
+	std::vector<Job> jobs;
+	for (size_t k = 0; k < levels.size(); ++k)
+	{
+		std::vector<Chain> open;
+		for (auto& tile : tile_chains)
+		{
+			for (auto& chain : tile[k])
+			{
+				if (chain.closed)
+				{
+					jobs.push_back(Job{ k, std::move(chain) });
+				}
+				else
+				{
+					open.push_back(std::move(chain));
+				}
+			}
+			tile[k].clear();
+		}
+		for (auto& chain : stitch(open))
+		{
+			jobs.push_back(Job{ k, std::move(chain) });
+		}
+	}
+	tile_chains.clear();
+
+	std::vector<std::optional<Contour>> contours(jobs.size());
+	parallelFor(jobs.size(), options.num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t j = first; j < last; ++j)
+		{
+			contours[j] = buildContour(field, jobs[j].chain, levels[jobs[j].level], options, grid.spacing);
+		}
+	});
+
+	std::vector<std::vector<Contour>> result(levels.size());
+	for (size_t j = 0; j < jobs.size(); ++j)
+	{
+		if (contours[j])
+		{
+			result[jobs[j].level].push_back(std::move(*contours[j]));
+		}
+	}
+	return result;
+}
+
+std::vector<Contour> extractIsolines(const std::vector<double>& values, const DistanceFieldGrid& grid, double level,
+	const IsolineOptions& options)
+{
+	return std::move(extractIsolines(values, grid, std::vector<double>{ level }, options).front());
+}
@@ -0,0 +1,8 @@
+#include <Config.h>
+#include <PointRange.h>
+#include <ContourStats.h>
+
+ContourPointView::ContourPointView(const Contour& contour, const TessellationSettings& settings)
+	: _lock(lockShared(contour._mutex)), _points(contour._elements.begin(), contour._elements.end(), settings)
+{
+}
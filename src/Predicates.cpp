@@ -0,0 +1,265 @@
+#include <Config.h>
+#include <Predicates.h>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Half an ulp of 1, the relative rounding error of a double operation
+	constexpr double EPSILON = 1.1102230246251565e-16;
+	// Forward error bounds of the floating point determinants (J. R. Shewchuk, Adaptive Precision Floating-Point
+	// Arithmetic and Fast Robust Geometric Predicates, 1997)
+	constexpr double ORIENT_BOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+	constexpr double INCIRCLE_BOUND = (10.0 + 96.0 * EPSILON) * EPSILON;
+	// |dx|^2 + |dy|^2 - r^2 with rounded differences, squares and sums stays within 8 rounding errors of its terms
+	constexpr double CIRCLE_BOUND = 8.0 * EPSILON;
+
+	/* Exact arithmetic on expansions: sums of doubles whose components do not overlap, stored in increasing order of
+	 * magnitude with zeros dropped. The sum is the exact value, the last component has its sign. */
+	using Expansion = std::vector<double>;
+
+	void twoSum(double a, double b, double& x, double& y)
+	{
+		x = a + b;
+		const double bv = x - a;
+		const double av = x - bv;
+		y = (a - av) + (b - bv);
+	}
+
+	void fastTwoSum(double a, double b, double& x, double& y)
+	{
+		// |a| >= |b|
+		x = a + b;
+		y = b - (x - a);
+	}
+
+	void twoProduct(double a, double b, double& x, double& y)
+	{
+		x = a * b;
+		y = std::fma(a, b, -x);
+	}
+
+	Expansion twoDiff(double a, double b)
+	{
+		double x, y;
+		twoSum(a, -b, x, y);
+		Expansion e;
+		if (y != 0) e.push_back(y);
+		if (x != 0) e.push_back(x);
+		return e;
+	}
+
+	// e + b
+	Expansion grow(const Expansion& e, double b)
+	{
+		Expansion h;
+		h.reserve(e.size() + 1);
+		double q = b;
+		for (double component : e)
+		{
+			double sum, error;
+			twoSum(q, component, sum, error);
+			q = sum;
+			if (error != 0) h.push_back(error);
+		}
+		if (q != 0) h.push_back(q);
+		return h;
+	}
+
+	Expansion add(Expansion e, const Expansion& f)
+	{
+		for (double component : f)
+		{
+			e = grow(e, component);
+		}
+		return e;
+	}
+
+	Expansion negate(Expansion e)
+	{
+		for (double& component : e)
+		{
+			component = -component;
+		}
+		return e;
+	}
+
+	// e * b
+	Expansion scale(const Expansion& e, double b)
+	{
+		Expansion h;
+		if (e.empty() || b == 0)
+		{
+			return h;
+		}
+		h.reserve(2 * e.size());
+		double q, error;
+		twoProduct(e[0], b, q, error);
+		if (error != 0) h.push_back(error);
+		for (size_t i = 1; i < e.size(); ++i)
+		{
+			double high, low, sum;
+			twoProduct(e[i], b, high, low);
+			twoSum(q, low, sum, error);
+			if (error != 0) h.push_back(error);
+			fastTwoSum(high, sum, q, error);
+			if (error != 0) h.push_back(error);
+		}
+		if (q != 0) h.push_back(q);
+		return h;
+	}
+
+	Expansion multiply(const Expansion& e, const Expansion& f)
+	{
+		Expansion h;
+		for (double component : f)
+		{
+			h = add(std::move(h), scale(e, component));
+		}
+		return h;
+	}
+
+	double estimate(const Expansion& e)
+	{
+		return e.empty() ? 0.0 : e.back();
+	}
+
+	double orient2dExact(const Point2& a, const Point2& b, const Point2& c)
+	{
+		const Expansion acx = twoDiff(a.x, c.x);
+		const Expansion acy = twoDiff(a.y, c.y);
+		const Expansion bcx = twoDiff(b.x, c.x);
+		const Expansion bcy = twoDiff(b.y, c.y);
+		return estimate(add(multiply(acx, bcy), negate(multiply(acy, bcx))));
+	}
+
+	double incircleExact(const Point2& a, const Point2& b, const Point2& c, const Point2& d)
+	{
+		const Expansion adx = twoDiff(a.x, d.x);
+		const Expansion ady = twoDiff(a.y, d.y);
+		const Expansion bdx = twoDiff(b.x, d.x);
+		const Expansion bdy = twoDiff(b.y, d.y);
+		const Expansion cdx = twoDiff(c.x, d.x);
+		const Expansion cdy = twoDiff(c.y, d.y);
+		auto lift = [](const Expansion& x, const Expansion& y) { return add(multiply(x, x), multiply(y, y)); };
+		auto cross = [](const Expansion& x1, const Expansion& y1, const Expansion& x2, const Expansion& y2)
+		{
+			return add(multiply(x1, y2), negate(multiply(y1, x2)));
+		};
+		Expansion det = multiply(lift(adx, ady), cross(bdx, bdy, cdx, cdy));
+		det = add(std::move(det), multiply(lift(bdx, bdy), cross(cdx, cdy, adx, ady)));
+		det = add(std::move(det), multiply(lift(cdx, cdy), cross(adx, ady, bdx, bdy)));
+		return estimate(det);
+	}
+
+	double circleSideExact(const Point2& center, double radius, const Point2& point)
+	{
+		const Expansion dx = twoDiff(point.x, center.x);
+		const Expansion dy = twoDiff(point.y, center.y);
+		double r2, r2_error;
+		twoProduct(radius, radius, r2, r2_error);
+		Expansion r;
+		if (r2_error != 0) r.push_back(-r2_error);
+		if (r2 != 0) r.push_back(-r2);
+		return estimate(add(add(multiply(dx, dx), multiply(dy, dy)), r));
+	}
+}
+
+double orient2d(const Point2& a, const Point2& b, const Point2& c)
+{
+	const double left = (a.x - c.x) * (b.y - c.y);
+	const double right = (a.y - c.y) * (b.x - c.x);
+	const double det = left - right;
+	double sum;
+	if (left > 0)
+	{
+		if (right <= 0)
+		{
+			return det;
+		}
+		sum = left + right;
+	}
+	else if (left < 0)
+	{
+		if (right >= 0)
+		{
+			return det;
+		}
+		sum = -left - right;
+	}
+	else
+	{
+		return det;
+	}
+	const double bound = ORIENT_BOUND * sum;
+	if (det >= bound || -det >= bound)
+	{
+		return det;
+	}
+	return orient2dExact(a, b, c);
+}
+
+double incircle(const Point2& a, const Point2& b, const Point2& c, const Point2& d)
+{
+	const double adx = a.x - d.x;
+	const double bdx = b.x - d.x;
+	const double cdx = c.x - d.x;
+	const double ady = a.y - d.y;
+	const double bdy = b.y - d.y;
+	const double cdy = c.y - d.y;
+
+	const double bdxcdy = bdx * cdy;
+	const double cdxbdy = cdx * bdy;
+	const double alift = adx * adx + ady * ady;
+	const double cdxady = cdx * ady;
+	const double adxcdy = adx * cdy;
+	const double blift = bdx * bdx + bdy * bdy;
+	const double adxbdy = adx * bdy;
+	const double bdxady = bdx * ady;
+	const double clift = cdx * cdx + cdy * cdy;
+
+	const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+	const double permanent = (fabs(bdxcdy) + fabs(cdxbdy)) * alift + (fabs(cdxady) + fabs(adxcdy)) * blift +
+		(fabs(adxbdy) + fabs(bdxady)) * clift;
+	const double bound = INCIRCLE_BOUND * permanent;
+	if (det > bound || -det > bound)
+	{
+		return det;
+	}
+	return incircleExact(a, b, c, d);
+}
+
+double circleSide(const Point2& center, double radius, const Point2& point)
+{
+	const double dx = point.x - center.x;
+	const double dy = point.y - center.y;
+	const double d2 = dx * dx + dy * dy;
+	const double r2 = radius * radius;
+	const double det = d2 - r2;
+	const double bound = CIRCLE_BOUND * (d2 + r2);
+	if (det > bound || -det > bound)
+	{
+		return det;
+	}
+	return circleSideExact(center, radius, point);
+}
+
+bool segmentsIntersect(const Point2& a, const Point2& b, const Point2& c, const Point2& d)
+{
+	const int abc = sign(orient2d(a, b, c));
+	const int abd = sign(orient2d(a, b, d));
+	const int cda = sign(orient2d(c, d, a));
+	const int cdb = sign(orient2d(c, d, b));
+	if (abc * abd < 0 && cda * cdb < 0)
+	{
+		return true;
+	}
+	// Touching or collinear: an end point on the other segment
+	auto onSegment = [](const Point2& p, const Point2& q, const Point2& r)
+	{
+		return std::fmin(p.x, q.x) <= r.x && r.x <= std::fmax(p.x, q.x) && std::fmin(p.y, q.y) <= r.y && r.y <= std::fmax(p.y, q.y);
+	};
+	return (abc == 0 && onSegment(a, b, c)) || (abd == 0 && onSegment(a, b, d)) ||
+		(cda == 0 && onSegment(c, d, a)) || (cdb == 0 && onSegment(c, d, b));
+}
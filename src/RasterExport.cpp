@@ -0,0 +1,427 @@
+#include <Config.h>
+#include <RasterExport.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+	struct Edge {
+		double x0, y0, x1, y1;
+	};
+
+	struct ViewTransform {
+		double scale;
+		double offset_x;
+		double offset_y;
+
+		Point2 apply(const Point2& p) const
+		{
+			// Image rows grow downwards, world y grows upwards
+			return Point2({ (p.x - offset_x) * scale, (offset_y - p.y) * scale });
+		}
+	};
+
+	ViewTransform makeTransform(const std::vector<Contour>& contours, const RasterOptions& options)
+	{
+		BoundingBox view = options.view;
+		double margin = 0.0;
+		if (view.isEmpty())
+		{
+			for (const auto& c : contours)
+			{
+				for (const auto& e : c.getElements())
+				{
+					view.expand(std::visit([](const auto& seg) { return seg.getBounds(); }, e));
+				}
+			}
+			margin = options.margin;
+		}
+		if (view.isEmpty())
+		{
+			return ViewTransform{ 1.0, 0.0, 0.0 };
+		}
+
+		const double w = std::max(view.max.x - view.min.x, EPS);
+		const double h = std::max(view.max.y - view.min.y, EPS);
+		const double sx = std::max(1.0, options.width - 2 * margin) / w;
+		const double sy = std::max(1.0, options.height - 2 * margin) / h;
+		const double scale = std::min(sx, sy);
+		// Center the view in the image
+		const double pad_x = (options.width / scale - w) / 2;
+		const double pad_y = (options.height / scale - h) / 2;
+		return ViewTransform{ scale, view.min.x - pad_x, view.max.y + pad_y };
+	}
+
+	// Flattens an element into image space points, arcs and curves get enough chords to stay within flatness pixels
+	void flatten(const ContourElement& element, const ViewTransform& view, double flatness, std::vector<Point2>& out)
+	{
+		if (const Arc* arc = std::get_if<Arc>(&element))
+		{
+			const double r = arc->getRadius() * view.scale;
+			const double sweep = fabs(arc->getEndAngle() - arc->getStartAngle());
+			size_t n = 1;
+			if (r > flatness)
+			{
+				const double step = 2 * std::acos(1 - flatness / r);
+				n = std::max<size_t>(1, static_cast<size_t>(std::ceil(sweep / step)));
+			}
+			for (size_t i = 0; i <= n; ++i)
+			{
+				out.push_back(view.apply(arc->getCoordinate(static_cast<double>(i) / n)));
+			}
+			return;
+		}
+		if (const Line2* line = std::get_if<Line2>(&element))
+		{
+			out.push_back(view.apply(line->getCoordinate(0.0)));
+			out.push_back(view.apply(line->getCoordinate(1.0)));
+			return;
+		}
+		// Curves flatten themselves, with the pixel tolerance taken back to world units
+		std::vector<Point2> strip;
+		if (const CubicBezier* curve = std::get_if<CubicBezier>(&element))
+		{
+			strip = curve->getLineStrip(flatness / view.scale);
+		}
+		else if (const BSpline* spline = std::get_if<BSpline>(&element))
+		{
+			strip = spline->getLineStrip(flatness / view.scale);
+		}
+		else if (const Clothoid* clothoid = std::get_if<Clothoid>(&element))
+		{
+			strip = clothoid->getLineStrip(flatness / view.scale);
+		}
+		for (const auto& p : strip)
+		{
+			out.push_back(view.apply(p));
+		}
+	}
+
+	void collectEdges(const Contour& contour, const ViewTransform& view, double flatness, std::vector<Edge>& edges)
+	{
+		std::vector<Point2> points;
+		for (const auto& e : contour.getElements())
+		{
+			points.clear();
+			flatten(e, view, flatness, points);
+			for (size_t i = 0; i + 1 < points.size(); ++i)
+			{
+				edges.push_back(Edge{ points[i].x, points[i].y, points[i + 1].x, points[i + 1].y });
+			}
+		}
+	}
+
+	double distanceToEdge(const Edge& e, double px, double py)
+	{
+		const double dx = e.x1 - e.x0;
+		const double dy = e.y1 - e.y0;
+		const double len2 = dx * dx + dy * dy;
+		double t = len2 > 0 ? ((px - e.x0) * dx + (py - e.y0) * dy) / len2 : 0.0;
+		t = std::clamp(t, 0.0, 1.0);
+		const double ex = e.x0 + t * dx - px;
+		const double ey = e.y0 + t * dy - py;
+		return std::sqrt(ex * ex + ey * ey);
+	}
+
+	// Anti-aliased stroke coverage per tile. Every tile owns its pixels, so tiles render without locking.
+	void renderStrokes(const std::vector<Edge>& edges, const RasterOptions& options, std::vector<float>& coverage)
+	{
+		const size_t w = options.width;
+		const size_t h = options.height;
+		const size_t tile = std::max<size_t>(8, options.tile_size);
+		const size_t tiles_x = (w + tile - 1) / tile;
+		const size_t tiles_y = (h + tile - 1) / tile;
+		const double half_width = 0.5 * options.stroke_width;
+		const double reach = half_width + 1.0;
+
+		std::vector<std::vector<uint32_t>> bins(tiles_x * tiles_y);
+		for (size_t i = 0; i < edges.size(); ++i)
+		{
+			const Edge& e = edges[i];
+			const double min_x = std::min(e.x0, e.x1) - reach;
+			const double max_x = std::max(e.x0, e.x1) + reach;
+			const double min_y = std::min(e.y0, e.y1) - reach;
+			const double max_y = std::max(e.y0, e.y1) + reach;
+			if (max_x < 0 || max_y < 0 || min_x >= w || min_y >= h)
+			{
+				continue;
+			}
+			const size_t tx0 = static_cast<size_t>(std::max(0.0, min_x)) / tile;
+			const size_t tx1 = std::min(tiles_x - 1, static_cast<size_t>(max_x) / tile);
+			const size_t ty0 = static_cast<size_t>(std::max(0.0, min_y)) / tile;
+			const size_t ty1 = std::min(tiles_y - 1, static_cast<size_t>(max_y) / tile);
+			for (size_t ty = ty0; ty <= ty1; ++ty)
+			{
+				for (size_t tx = tx0; tx <= tx1; ++tx)
+				{
+					bins[ty * tiles_x + tx].push_back(static_cast<uint32_t>(i));
+				}
+			}
+		}
+
+		// Tiles are handed out one at a time, dense tiles do not stall a whole block of work
+		std::atomic<size_t> next_tile{ 0 };
+		const unsigned int threads = resolveThreadCount(options.num_threads, bins.size());
+		parallelFor(threads, threads, [&](size_t, size_t)
+		{
+			for (size_t t = next_tile++; t < bins.size(); t = next_tile++)
+			{
+				const size_t x_begin = (t % tiles_x) * tile;
+				const size_t y_begin = (t / tiles_x) * tile;
+				const size_t x_end = std::min(w, x_begin + tile);
+				const size_t y_end = std::min(h, y_begin + tile);
+				for (uint32_t index : bins[t])
+				{
+					const Edge& e = edges[index];
+					const size_t px0 = std::max(x_begin, static_cast<size_t>(std::max(0.0, std::min(e.x0, e.x1) - reach)));
+					const size_t px1 = std::min(x_end, static_cast<size_t>(std::max(0.0, std::max(e.x0, e.x1) + reach)) + 1);
+					const size_t py0 = std::max(y_begin, static_cast<size_t>(std::max(0.0, std::min(e.y0, e.y1) - reach)));
+					const size_t py1 = std::min(y_end, static_cast<size_t>(std::max(0.0, std::max(e.y0, e.y1) + reach)) + 1);
+					for (size_t y = py0; y < py1; ++y)
+					{
+						for (size_t x = px0; x < px1; ++x)
+						{
+							const double d = distanceToEdge(e, x + 0.5, y + 0.5);
+							const float c = static_cast<float>(std::clamp(half_width + 0.5 - d, 0.0, 1.0));
+							float& target = coverage[y * w + x];
+							target = std::max(target, c);
+						}
+					}
+				}
+			}
+		});
+	}
+
+	// Even-odd scanline fill with fill_samples sub scanlines per row and exact horizontal span coverage.
+	// Rows are split into bands, every band only looks at the edges that reach it.
+	void renderFill(const std::vector<Edge>& edges, const RasterOptions& options, std::vector<float>& coverage)
+	{
+		const size_t w = options.width;
+		const size_t h = options.height;
+		const size_t band = std::max<size_t>(8, options.tile_size);
+		const size_t bands = (h + band - 1) / band;
+		const unsigned int samples = std::max(1u, options.fill_samples);
+
+		std::vector<std::vector<uint32_t>> bins(bands);
+		for (size_t i = 0; i < edges.size(); ++i)
+		{
+			const Edge& e = edges[i];
+			const double min_y = std::min(e.y0, e.y1);
+			const double max_y = std::max(e.y0, e.y1);
+			if (max_y < 0 || min_y >= h || min_y == max_y)
+			{
+				continue;
+			}
+			const size_t b0 = static_cast<size_t>(std::max(0.0, min_y)) / band;
+			const size_t b1 = std::min(bands - 1, static_cast<size_t>(max_y) / band);
+			for (size_t b = b0; b <= b1; ++b)
+			{
+				bins[b].push_back(static_cast<uint32_t>(i));
+			}
+		}
+
+		std::atomic<size_t> next_band{ 0 };
+		const unsigned int threads = resolveThreadCount(options.num_threads, bands);
+		parallelFor(threads, threads, [&](size_t, size_t)
+		{
+			std::vector<double> crossings;
+			std::vector<float> row(w + 1);
+			for (size_t b = next_band++; b < bands; b = next_band++)
+			{
+				const size_t y_end = std::min(h, (b + 1) * band);
+				for (size_t y = b * band; y < y_end; ++y)
+				{
+					std::fill(row.begin(), row.end(), 0.0f);
+					for (unsigned int s = 0; s < samples; ++s)
+					{
+						const double sy = y + (s + 0.5) / samples;
+						crossings.clear();
+						for (uint32_t index : bins[b])
+						{
+							const Edge& e = edges[index];
+							if ((e.y0 > sy) != (e.y1 > sy))
+							{
+								crossings.push_back(e.x0 + (sy - e.y0) * (e.x1 - e.x0) / (e.y1 - e.y0));
+							}
+						}
+						std::sort(crossings.begin(), crossings.end());
+						for (size_t k = 0; k + 1 < crossings.size(); k += 2)
+						{
+							const double xa = std::clamp(crossings[k], 0.0, static_cast<double>(w));
+							const double xb = std::clamp(crossings[k + 1], 0.0, static_cast<double>(w));
+							if (xb <= xa)
+							{
+								continue;
+							}
+							const size_t ia = static_cast<size_t>(xa);
+							const size_t ib = static_cast<size_t>(xb);
+							if (ia == ib)
+							{
+								row[ia] += static_cast<float>(xb - xa);
+								continue;
+							}
+							row[ia] += static_cast<float>(ia + 1 - xa);
+							for (size_t x = ia + 1; x < ib; ++x)
+							{
+								row[x] += 1.0f;
+							}
+							row[ib] += static_cast<float>(xb - ib);
+						}
+					}
+					for (size_t x = 0; x < w; ++x)
+					{
+						coverage[y * w + x] = std::min(1.0f, row[x] / samples);
+					}
+				}
+			}
+		});
+	}
+
+	uint8_t blend(uint8_t from, uint8_t to, float amount)
+	{
+		return static_cast<uint8_t>(std::lround(from + (static_cast<int>(to) - from) * amount));
+	}
+}
+
+RasterImage::RasterImage(size_t width, size_t height, RasterColor background)
+	: _width(width), _height(height), _pixels(width * height * 3)
+{
+	for (size_t i = 0; i < width * height; ++i)
+	{
+		_pixels[3 * i] = background.r;
+		_pixels[3 * i + 1] = background.g;
+		_pixels[3 * i + 2] = background.b;
+	}
+}
+
+RasterColor RasterImage::getPixel(size_t x, size_t y) const
+{
+	const size_t i = 3 * (y * _width + x);
+	return RasterColor{ _pixels[i], _pixels[i + 1], _pixels[i + 2] };
+}
+
+void RasterImage::setPixel(size_t x, size_t y, RasterColor color)
+{
+	const size_t i = 3 * (y * _width + x);
+	_pixels[i] = color.r;
+	_pixels[i + 1] = color.g;
+	_pixels[i + 2] = color.b;
+}
+
+void RasterImage::writePGM(const std::string& filename) const
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open file.");
+	}
+	file << "P5\n" << _width << " " << _height << "\n255\n";
+	std::vector<uint8_t> gray(_width * _height);
+	for (size_t i = 0; i < gray.size(); ++i)
+	{
+		// Rec. 601 luma
+		gray[i] = static_cast<uint8_t>(std::lround(0.299 * _pixels[3 * i] + 0.587 * _pixels[3 * i + 1] + 0.114 * _pixels[3 * i + 2]));
+	}
+	file.write(reinterpret_cast<const char*>(gray.data()), gray.size());
+}
+
+void RasterImage::writePPM(const std::string& filename) const
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open file.");
+	}
+	file << "P6\n" << _width << " " << _height << "\n255\n";
+	file.write(reinterpret_cast<const char*>(_pixels.data()), _pixels.size());
+}
+
+RasterImage renderContours(const std::vector<Contour>& contours, const RasterOptions& options)
+{
+	RasterImage image(options.width, options.height, options.background);
+	if (options.width == 0 || options.height == 0)
+	{
+		return image;
+	}
+
+	const ViewTransform view = makeTransform(contours, options);
+	const double flatness = std::max(options.flatness, 1E-3);
+
+	// Flatten the contours in parallel, then concatenate in order
+	std::vector<std::vector<Edge>> per_contour(contours.size());
+	std::vector<char> closed(contours.size(), 0);
+	parallelFor(contours.size(), options.num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			collectEdges(contours[i], view, flatness, per_contour[i]);
+			closed[i] = options.fill && contours[i].isClosed();
+		}
+	});
+
+	std::vector<Edge> edges;
+	std::vector<Edge> fill_edges;
+	for (size_t i = 0; i < per_contour.size(); ++i)
+	{
+		if (closed[i])
+		{
+			fill_edges.insert(fill_edges.end(), per_contour[i].begin(), per_contour[i].end());
+		}
+		edges.insert(edges.end(), per_contour[i].begin(), per_contour[i].end());
+		std::vector<Edge>().swap(per_contour[i]);
+	}
+
+	const size_t pixels = options.width * options.height;
+	std::vector<float> fill_coverage;
+	std::vector<float> stroke_coverage;
+	if (options.fill && !fill_edges.empty())
+	{
+		fill_coverage.assign(pixels, 0.0f);
+		renderFill(fill_edges, options, fill_coverage);
+	}
+	if (options.stroke && !edges.empty())
+	{
+		stroke_coverage.assign(pixels, 0.0f);
+		renderStrokes(edges, options, stroke_coverage);
+	}
+
+	parallelFor(options.height, options.num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t y = first; y < last; ++y)
+		{
+			for (size_t x = 0; x < options.width; ++x)
+			{
+				const size_t i = y * options.width + x;
+				RasterColor c = options.background;
+				if (!fill_coverage.empty() && fill_coverage[i] > 0)
+				{
+					c = RasterColor{ blend(c.r, options.fill_color.r, fill_coverage[i]),
+						blend(c.g, options.fill_color.g, fill_coverage[i]),
+						blend(c.b, options.fill_color.b, fill_coverage[i]) };
+				}
+				if (!stroke_coverage.empty() && stroke_coverage[i] > 0)
+				{
+					c = RasterColor{ blend(c.r, options.stroke_color.r, stroke_coverage[i]),
+						blend(c.g, options.stroke_color.g, stroke_coverage[i]),
+						blend(c.b, options.stroke_color.b, stroke_coverage[i]) };
+				}
+				image.setPixel(x, y, c);
+			}
+		}
+	});
+	return image;
+}
+
+void exportContoursToPGM(const std::vector<Contour>& contours, const std::string& filename, const RasterOptions& options)
+{
+	renderContours(contours, options).writePGM(filename);
+}
+
+void exportContoursToPPM(const std::vector<Contour>& contours, const std::string& filename, const RasterOptions& options)
+{
+	renderContours(contours, options).writePPM(filename);
+}
@@ -0,0 +1,543 @@
+#include <Config.h>
+#include <Triangulation.h>
+#include <Parallel.h>
+#include <Predicates.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+	constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+	// Sweep order, top to bottom. Equal heights are ordered left to right, as if the plane were turned slightly.
+	bool above(const Point2& a, const Point2& b)
+	{
+		return a.y > b.y || (a.y == b.y && a.x < b.x);
+	}
+
+	void flatten(const ContourElement& element, double flatness, std::vector<Point2>& out)
+	{
+		if (const Arc* arc = std::get_if<Arc>(&element))
+		{
+			const double sweep = fabs(arc->getEndAngle() - arc->getStartAngle());
+			size_t n = 1;
+			if (arc->getRadius() > flatness)
+			{
+				const double step = 2 * std::acos(1 - flatness / arc->getRadius());
+				n = std::max<size_t>(1, static_cast<size_t>(std::ceil(sweep / step)));
+			}
+			for (size_t i = 0; i <= n; ++i)
+			{
+				out.push_back(arc->getCoordinate(static_cast<double>(i) / n));
+			}
+			return;
+		}
+		if (const Line2* line = std::get_if<Line2>(&element))
+		{
+			out.push_back(line->getCoordinate(0.0));
+			out.push_back(line->getCoordinate(1.0));
+			return;
+		}
+		std::vector<Point2> strip;
+		if (const CubicBezier* curve = std::get_if<CubicBezier>(&element))
+		{
+			strip = curve->getLineStrip(flatness);
+		}
+		else if (const BSpline* spline = std::get_if<BSpline>(&element))
+		{
+			strip = spline->getLineStrip(flatness);
+		}
+		else if (const Clothoid* clothoid = std::get_if<Clothoid>(&element))
+		{
+			strip = clothoid->getLineStrip(flatness);
+		}
+		out.insert(out.end(), strip.begin(), strip.end());
+	}
+
+	// All rings in one vertex array, next and prev link each ring into a cycle with the area on its left
+	struct Polygon {
+		std::vector<Point2> points;
+		std::vector<uint32_t> next;
+		std::vector<uint32_t> prev;
+	};
+
+	bool ringContains(const std::vector<Point2>& ring, const Point2& p)
+	{
+		bool inside = false;
+		for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+		{
+			if ((ring[i].y > p.y) != (ring[j].y > p.y) &&
+				p.x < ring[j].x + (p.y - ring[j].y) * (ring[i].x - ring[j].x) / (ring[i].y - ring[j].y))
+			{
+				inside = !inside;
+			}
+		}
+		return inside;
+	}
+
+	Polygon buildPolygon(const std::vector<Contour>& contours, double flatness)
+	{
+		std::vector<std::vector<Point2>> rings;
+		std::vector<Point2> points;
+		for (const auto& contour : contours)
+		{
+			if (!contour.isClosed())
+			{
+				throw std::invalid_argument("triangulate needs closed contours");
+			}
+			std::vector<Point2> ring;
+			for (const auto& e : contour.getElements())
+			{
+				points.clear();
+				flatten(e, flatness, points);
+				for (const auto& p : points)
+				{
+					if (ring.empty() || fabs(p.x - ring.back().x) >= EPS || fabs(p.y - ring.back().y) >= EPS)
+					{
+						ring.push_back(p);
+					}
+				}
+			}
+			ring.pop_back(); // the closing point repeats the first
+			if (ring.size() >= 3)
+			{
+				rings.push_back(std::move(ring));
+			}
+		}
+
+		// Rings nested an odd number of times are holes, they run clockwise so the area stays on the left
+		std::vector<BoundingBox> bounds(rings.size());
+		for (size_t r = 0; r < rings.size(); ++r)
+		{
+			for (const auto& p : rings[r])
+			{
+				bounds[r].expand(p);
+			}
+		}
+		Polygon polygon;
+		for (size_t r = 0; r < rings.size(); ++r)
+		{
+			size_t depth = 0;
+			for (size_t s = 0; s < rings.size(); ++s)
+			{
+				if (s != r && bounds[s].contains(rings[r].front()) && ringContains(rings[s], rings[r].front()))
+				{
+					++depth;
+				}
+			}
+			double area = 0;
+			for (size_t i = 0, j = rings[r].size() - 1; i < rings[r].size(); j = i++)
+			{
+				area += rings[r][j].x * rings[r][i].y - rings[r][i].x * rings[r][j].y;
+			}
+			if ((area > 0) == (depth % 2 == 1))
+			{
+				std::reverse(rings[r].begin(), rings[r].end());
+			}
+
+			const uint32_t first = static_cast<uint32_t>(polygon.points.size());
+			const uint32_t count = static_cast<uint32_t>(rings[r].size());
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				polygon.points.push_back(rings[r][i]);
+				polygon.next.push_back(first + (i + 1) % count);
+				polygon.prev.push_back(first + (i + count - 1) % count);
+			}
+		}
+		if (polygon.points.size() >= NONE)
+		{
+			throw std::invalid_argument("too many vertices to triangulate");
+		}
+		return polygon;
+	}
+
+	enum class VertexType { Start, End, Split, Merge, Regular };
+
+	/* Sweeps top to bottom and adds diagonals at split and merge vertices, which leaves y-monotone pieces.
+	 * Edge i runs from vertex i to next[i]. The status holds the edges with the area to their right, ordered
+	 * left to right where they cross the sweep line, each with the helper vertex a diagonal would go to. */
+	class MonotoneSweep {
+	public:
+		explicit MonotoneSweep(const Polygon& polygon)
+			: _polygon(polygon), _status(Compare{ this }), _types(polygon.points.size()),
+			_helpers(polygon.points.size(), NONE), _positions(polygon.points.size())
+		{
+		}
+
+		std::vector<std::pair<uint32_t, uint32_t>> diagonals()
+		{
+			const auto& points = _polygon.points;
+			std::vector<uint32_t> order(points.size());
+			for (uint32_t v = 0; v < order.size(); ++v)
+			{
+				order[v] = v;
+				_types[v] = classify(v);
+			}
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return above(points[a], points[b]); });
+
+			for (uint32_t v : order)
+			{
+				_sweep = points[v];
+				const uint32_t previous = _polygon.prev[v];
+				switch (_types[v])
+				{
+				case VertexType::Start:
+					insert(v, v);
+					break;
+				case VertexType::End:
+					connectToMergeHelper(v, previous);
+					_status.erase(_positions[previous]);
+					break;
+				case VertexType::Split:
+				{
+					const uint32_t left = leftOf();
+					_diagonals.emplace_back(v, _helpers[left]);
+					_helpers[left] = v;
+					insert(v, v);
+					break;
+				}
+				case VertexType::Merge:
+				{
+					connectToMergeHelper(v, previous);
+					_status.erase(_positions[previous]);
+					const uint32_t left = leftOf();
+					connectToMergeHelper(v, left);
+					_helpers[left] = v;
+					break;
+				}
+				case VertexType::Regular:
+					if (above(points[previous], points[v]))
+					{
+						// Going down, the area lies to the right
+						connectToMergeHelper(v, previous);
+						_status.erase(_positions[previous]);
+						insert(v, v);
+					}
+					else
+					{
+						const uint32_t left = leftOf();
+						connectToMergeHelper(v, left);
+						_helpers[left] = v;
+					}
+					break;
+				}
+			}
+			return std::move(_diagonals);
+		}
+
+	private:
+		struct Compare {
+			const MonotoneSweep* sweep;
+			// NONE stands for the sweep point itself
+			bool operator()(uint32_t a, uint32_t b) const
+			{
+				const double xa = (a == NONE) ? sweep->_sweep.x : sweep->xAt(a);
+				const double xb = (b == NONE) ? sweep->_sweep.x : sweep->xAt(b);
+				return xa < xb;
+			}
+		};
+
+		VertexType classify(uint32_t v) const
+		{
+			const Point2& p = _polygon.points[v];
+			const Point2& previous = _polygon.points[_polygon.prev[v]];
+			const Point2& next = _polygon.points[_polygon.next[v]];
+			const bool previous_above = above(previous, p);
+			const bool next_above = above(next, p);
+			if (previous_above != next_above)
+			{
+				return VertexType::Regular;
+			}
+			const bool convex = orient2d(previous, p, next) > 0;
+			if (!previous_above)
+			{
+				return convex ? VertexType::Start : VertexType::Split;
+			}
+			return convex ? VertexType::End : VertexType::Merge;
+		}
+
+		// Where edge crosses the sweep line through the current vertex
+		double xAt(uint32_t edge) const
+		{
+			const Point2& a = _polygon.points[edge];
+			const Point2& b = _polygon.points[_polygon.next[edge]];
+			if (a.y == b.y)
+			{
+				// The turned sweep line meets a horizontal edge only in the sweep point
+				return std::clamp(_sweep.x, std::min(a.x, b.x), std::max(a.x, b.x));
+			}
+			if (_sweep.y == a.y)
+			{
+				return a.x;
+			}
+			if (_sweep.y == b.y)
+			{
+				return b.x;
+			}
+			return a.x + (_sweep.y - a.y) * (b.x - a.x) / (b.y - a.y);
+		}
+
+		void insert(uint32_t edge, uint32_t helper)
+		{
+			_positions[edge] = _status.insert(edge).first;
+			_helpers[edge] = helper;
+		}
+
+		uint32_t leftOf() const
+		{
+			auto it = _status.lower_bound(NONE);
+			if (it == _status.begin())
+			{
+				throw std::invalid_argument("triangulate needs rings that do not intersect");
+			}
+			return *std::prev(it);
+		}
+
+		void connectToMergeHelper(uint32_t v, uint32_t edge)
+		{
+			const uint32_t helper = _helpers[edge];
+			if (helper != NONE && _types[helper] == VertexType::Merge)
+			{
+				_diagonals.emplace_back(v, helper);
+			}
+		}
+
+		const Polygon& _polygon;
+		Point2 _sweep;
+		std::set<uint32_t, Compare> _status;
+		std::vector<VertexType> _types;
+		std::vector<uint32_t> _helpers;
+		std::vector<std::set<uint32_t, Compare>::iterator> _positions;
+		std::vector<std::pair<uint32_t, uint32_t>> _diagonals;
+	};
+
+	void emitTriangle(const Polygon& polygon, uint32_t a, uint32_t b, uint32_t c, std::vector<uint32_t>& indices)
+	{
+		if (orient2d(polygon.points[a], polygon.points[b], polygon.points[c]) < 0)
+		{
+			std::swap(b, c);
+		}
+		indices.push_back(a);
+		indices.push_back(b);
+		indices.push_back(c);
+	}
+
+	// Stack based triangulation of a y-monotone piece given counter clockwise
+	void triangulateMonotone(const Polygon& polygon, const std::vector<uint32_t>& piece, std::vector<uint32_t>& indices)
+	{
+		const auto& points = polygon.points;
+		const size_t n = piece.size();
+		if (n == 3)
+		{
+			emitTriangle(polygon, piece[0], piece[1], piece[2], indices);
+			return;
+		}
+		size_t top = 0;
+		size_t bottom = 0;
+		for (size_t i = 1; i < n; ++i)
+		{
+			if (above(points[piece[i]], points[piece[top]])) top = i;
+			if (above(points[piece[bottom]], points[piece[i]])) bottom = i;
+		}
+
+		// Merge the chains, counter clockwise from the top runs down the left chain
+		std::vector<std::pair<uint32_t, bool>> sorted; // vertex, on the left chain
+		sorted.reserve(n);
+		size_t left = top;
+		size_t right = (top + n - 1) % n;
+		sorted.emplace_back(piece[top], true);
+		left = (left + 1) % n;
+		while (sorted.size() < n)
+		{
+			if (left != bottom && (right == bottom || above(points[piece[left]], points[piece[right]])))
+			{
+				sorted.emplace_back(piece[left], true);
+				left = (left + 1) % n;
+			}
+			else if (right != bottom)
+			{
+				sorted.emplace_back(piece[right], false);
+				right = (right + n - 1) % n;
+			}
+			else
+			{
+				sorted.emplace_back(piece[bottom], true);
+			}
+		}
+
+		std::vector<std::pair<uint32_t, bool>> stack{ sorted[0], sorted[1] };
+		for (size_t j = 2; j + 1 < n; ++j)
+		{
+			const auto [u, on_left] = sorted[j];
+			if (on_left != stack.back().second)
+			{
+				for (size_t k = stack.size() - 1; k > 0; --k)
+				{
+					emitTriangle(polygon, u, stack[k].first, stack[k - 1].first, indices);
+				}
+				stack = { sorted[j - 1], sorted[j] };
+				continue;
+			}
+			auto last = stack.back();
+			stack.pop_back();
+			while (!stack.empty())
+			{
+				const double turn = orient2d(points[stack.back().first], points[last.first], points[u]);
+				if (on_left ? turn <= 0 : turn >= 0)
+				{
+					break;
+				}
+				emitTriangle(polygon, u, last.first, stack.back().first, indices);
+				last = stack.back();
+				stack.pop_back();
+			}
+			stack.push_back(last);
+			stack.emplace_back(u, on_left);
+		}
+		for (size_t k = stack.size() - 1; k > 0; --k)
+		{
+			emitTriangle(polygon, sorted[n - 1].first, stack[k].first, stack[k - 1].first, indices);
+		}
+	}
+
+	// Walks the faces cut out by the diagonals, each face keeps the area on its left
+	void triangulatePieces(const Polygon& polygon, const std::vector<std::pair<uint32_t, uint32_t>>& diagonals,
+		std::vector<uint32_t>& indices)
+	{
+		const auto& points = polygon.points;
+		const size_t n = points.size();
+
+		// Outgoing half edges per vertex, the ring edge first
+		std::vector<uint32_t> offsets(n + 1, 0);
+		for (uint32_t v = 0; v < n; ++v)
+		{
+			offsets[v + 1] = 1;
+		}
+		for (const auto& [a, b] : diagonals)
+		{
+			++offsets[a + 1];
+			++offsets[b + 1];
+		}
+		for (size_t v = 0; v < n; ++v)
+		{
+			offsets[v + 1] += offsets[v];
+		}
+		std::vector<uint32_t> targets(offsets[n]);
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (uint32_t v = 0; v < n; ++v)
+		{
+			targets[fill[v]++] = polygon.next[v];
+		}
+		for (const auto& [a, b] : diagonals)
+		{
+			targets[fill[a]++] = b;
+			targets[fill[b]++] = a;
+		}
+
+		// Arriving at v from u the face continues along the first edge clockwise from the way back to u
+		auto nextHalfEdge = [&](uint32_t u, uint32_t v)
+		{
+			const uint32_t first = offsets[v];
+			const uint32_t count = offsets[v + 1] - first;
+			if (count == 1)
+			{
+				return first;
+			}
+			const double back = atan2(points[u].y - points[v].y, points[u].x - points[v].x);
+			uint32_t best = first;
+			double best_angle = std::numeric_limits<double>::max();
+			for (uint32_t h = first; h < first + count; ++h)
+			{
+				const Point2& w = points[targets[h]];
+				double angle = back - atan2(w.y - points[v].y, w.x - points[v].x);
+				while (angle <= 0)
+				{
+					angle += 2 * PI;
+				}
+				if (angle < best_angle)
+				{
+					best_angle = angle;
+					best = h;
+				}
+			}
+			return best;
+		};
+
+		std::vector<char> visited(targets.size(), 0);
+		std::vector<uint32_t> piece;
+		for (uint32_t v = 0; v < n; ++v)
+		{
+			for (uint32_t h = offsets[v]; h < offsets[v + 1]; ++h)
+			{
+				if (visited[h])
+				{
+					continue;
+				}
+				piece.clear();
+				uint32_t from = v;
+				uint32_t edge = h;
+				while (!visited[edge])
+				{
+					visited[edge] = 1;
+					piece.push_back(from);
+					const uint32_t to = targets[edge];
+					edge = nextHalfEdge(from, to);
+					from = to;
+				}
+				if (piece.size() >= 3)
+				{
+					triangulateMonotone(polygon, piece, indices);
+				}
+			}
+		}
+	}
+}
+
+TriangleMesh triangulate(const std::vector<Contour>& rings, const TriangulationOptions& options)
+{
+	if (options.flatness <= 0)
+	{
+		throw std::invalid_argument("flatness must be positive and non zero");
+	}
+	const Polygon polygon = buildPolygon(rings, options.flatness);
+
+	TriangleMesh mesh;
+	mesh.vertices.reserve(2 * polygon.points.size());
+	for (const auto& p : polygon.points)
+	{
+		mesh.vertices.push_back(p.x);
+		mesh.vertices.push_back(p.y);
+	}
+	if (polygon.points.empty())
+	{
+		return mesh;
+	}
+	MonotoneSweep sweep(polygon);
+	const auto diagonals = sweep.diagonals();
+	mesh.indices.reserve(3 * (polygon.points.size() + 2 * diagonals.size()));
+	triangulatePieces(polygon, diagonals, mesh.indices);
+	return mesh;
+}
+
+TriangleMesh triangulate(const Contour& contour, const TriangulationOptions& options)
+{
+	return triangulate(std::vector<Contour>{ contour }, options);
+}
+
+std::vector<TriangleMesh> triangulateBatch(const std::vector<std::vector<Contour>>& shapes, const TriangulationOptions& options)
+{
+	std::vector<TriangleMesh> meshes(shapes.size());
+	parallelFor(shapes.size(), options.num_threads, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			meshes[i] = triangulate(shapes[i], options);
+		}
+	});
+	return meshes;
+}
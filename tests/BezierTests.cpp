@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourSink.h"
+#include "CubicBezier.h"
+#include "BSpline.h"
+#include "Point2.h"
+#include "Line2.h"
+
+#include <sstream>
+
+// Distance from p to the closest chord of a strip
+static double distanceToStrip(const std::vector<Point2>& strip, const Point2& p)
+{
+    double best = 1E300;
+    for (size_t i = 0; i + 1 < strip.size(); ++i) {
+        double dx = strip[i + 1].x - strip[i].x;
+        double dy = strip[i + 1].y - strip[i].y;
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0 ? ((p.x - strip[i].x) * dx + (p.y - strip[i].y) * dy) / len2 : 0.0;
+        t = std::clamp(t, 0.0, 1.0);
+        best = std::min(best, std::hypot(strip[i].x + t * dx - p.x, strip[i].y + t * dy - p.y));
+    }
+    return best;
+}
+
+TEST(BezierTests, CubicBezierEndPointsAndMidpoint) {
+    CubicBezier curve(Point2({ 0, 0 }), Point2({ 0, 1 }), Point2({ 1, 1 }), Point2({ 1, 0 }));
+
+    EXPECT_TRUE(curve.getCoordinate(0.0).isCloseTo(Point2({ 0, 0 }), EPS));
+    EXPECT_TRUE(curve.getCoordinate(1.0).isCloseTo(Point2({ 1, 0 }), EPS));
+    EXPECT_TRUE(curve.getCoordinate(0.5).isCloseTo(Point2({ 0.5, 0.75 }), 1E-12));
+    EXPECT_THROW(curve.getCoordinate(1.5), std::invalid_argument);
+    EXPECT_THROW(CubicBezier(Point2({ 1, 1 }), Point2({ 1, 1 }), Point2({ 1, 1 }), Point2({ 1, 1 })), std::invalid_argument);
+}
+
+TEST(BezierTests, FlatteningStaysWithinFlatness) {
+    const double flatness = 1E-4;
+    CubicBezier curve(Point2({ 0, 0 }), Point2({ 10, 30 }), Point2({ 20, -30 }), Point2({ 30, 0 }), flatness);
+    auto strip = curve.getLineStrip();
+
+    ASSERT_GT(strip.size(), 10);
+    EXPECT_TRUE(strip.front().isCloseTo(curve.getCoordinate(0.0), EPS));
+    EXPECT_TRUE(strip.back().isCloseTo(curve.getCoordinate(1.0), EPS));
+    for (int i = 0; i <= 1000; ++i) {
+        EXPECT_LE(distanceToStrip(strip, curve.getCoordinate(i / 1000.0)), flatness * 1.01);
+    }
+
+    // A coarser tolerance needs far fewer points
+    EXPECT_LT(curve.getLineStrip(1E-2).size(), strip.size() / 5);
+}
+
+TEST(BezierTests, BoundsAndClosestParameter) {
+    CubicBezier curve(Point2({ 0, 0 }), Point2({ 0, 1 }), Point2({ 1, 1 }), Point2({ 1, 0 }));
+    BoundingBox box = curve.getBounds();
+
+    EXPECT_NEAR(box.min.x, 0.0, 1E-12);
+    EXPECT_NEAR(box.max.x, 1.0, 1E-12);
+    EXPECT_NEAR(box.min.y, 0.0, 1E-12);
+    EXPECT_NEAR(box.max.y, 0.75, 1E-12);
+
+    EXPECT_NEAR(curve.getClosestParameter(Point2({ 0.5, 2 })), 0.5, 1E-9);
+    EXPECT_NEAR(curve.getClosestParameter(Point2({ -1, -1 })), 0.0, 1E-9);
+}
+
+TEST(BezierTests, BSplineInterpolatesClampedEnds) {
+    std::vector<Point2> points = { {0, 0}, {1, 2}, {3, 2}, {4, 0}, {6, 1}, {7, 3} };
+    BSpline spline(points);
+
+    EXPECT_EQ(spline.getBezierPieces().size(), 3);
+    EXPECT_TRUE(spline.getCoordinate(0.0).isCloseTo(points.front(), EPS));
+    EXPECT_TRUE(spline.getCoordinate(1.0).isCloseTo(points.back(), 1E-12));
+
+    // Pieces join continuously, and their cached end points are their own
+    const auto& pieces = spline.getBezierPieces();
+    for (size_t i = 0; i + 1 < pieces.size(); ++i) {
+        EXPECT_TRUE(pieces[i].getEnd().isCloseTo(pieces[i + 1].getStart(), 1E-12));
+        EXPECT_TRUE(pieces[i].endPoint().isCloseTo(pieces[i + 1].startPoint(), 1E-12));
+    }
+    EXPECT_TRUE(pieces.front().startPoint().isCloseTo(points.front(), EPS));
+    EXPECT_TRUE(pieces.back().endPoint().isCloseTo(points.back(), 1E-12));
+}
+
+TEST(BezierTests, BSplineMatchesDeBoor) {
+    std::vector<Point2> points = { {0, 0}, {1, 3}, {2, -1}, {4, 2}, {5, 0} };
+    std::vector<double> knots = { 0, 0, 0, 0.2, 0.7, 1, 1, 1 };
+    BSpline spline(points, knots, 2);
+
+    // Reference de Boor evaluation
+    auto deBoor = [&](double u) {
+        const int p = 2;
+        int k = p;
+        while (k + 1 < static_cast<int>(points.size()) && knots[k + 1] <= u) ++k;
+        std::vector<Point2> d(points.begin() + k - p, points.begin() + k + 1);
+        for (int r = 1; r <= p; ++r) {
+            for (int j = p; j >= r; --j) {
+                int i = j + k - p;
+                double alpha = (u - knots[i]) / (knots[i + 1 + p - r] - knots[i]);
+                d[j] = Point2({ (1 - alpha) * d[j - 1].x + alpha * d[j].x, (1 - alpha) * d[j - 1].y + alpha * d[j].y });
+            }
+        }
+        return d[p];
+    };
+
+    for (int i = 0; i < 100; ++i) {
+        double t = i / 100.0;
+        EXPECT_TRUE(spline.getCoordinate(t).isCloseTo(deBoor(t), 1E-12)) << "t = " << t;
+    }
+    EXPECT_THROW(BSpline(points, { 0, 0, 0.2, 0.7, 1, 1, 1, 1 }, 2), std::invalid_argument);
+}
+
+TEST(BezierTests, CurvesParticipateInContours) {
+    Contour contour;
+    contour.addItem(Line2(Point2({ -1, 0 }), Point2({ 0, 0 })));
+    contour.addItem(CubicBezier(Point2({ 0, 0 }), Point2({ 0, 1 }), Point2({ 1, 1 }), Point2({ 1, 0 })));
+    contour.addItem(BSpline({ {1, 0}, {2, -1}, {3, 1}, {4, 0} }));
+    EXPECT_TRUE(contour.isValid());
+
+    Contour copy = contour;
+    EXPECT_TRUE(copy == contour);
+
+    // Round trip through the binary stream
+    std::stringstream stream;
+    BinarySink writer(stream);
+    for (const auto& e : contour.getElements()) {
+        writer.push(e);
+    }
+    writer.finish();
+    Contour read;
+    ContourCollectorSink collector(read);
+    EXPECT_EQ(readBinaryStream(stream, collector), 3);
+    EXPECT_TRUE(read == contour);
+}
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "ChunkedVector.h"
+#include "Contour.h"
+#include <random>
+#include <vector>
+
+// Small chunks so that splits, merges and Fenwick rebuilds happen constantly
+using SmallChunks = ChunkedVector<int, 8>;
+
+static void expectSame(const SmallChunks& chunked, const std::vector<int>& reference)
+{
+    ASSERT_EQ(chunked.size(), reference.size());
+    for (size_t i = 0; i < reference.size(); ++i)
+        ASSERT_EQ(chunked[i], reference[i]) << "at index " << i;
+
+    size_t i = 0;
+    for (int value : chunked)
+        ASSERT_EQ(value, reference[i++]);
+    ASSERT_EQ(i, reference.size());
+}
+
+TEST(ChunkedVectorTests, PushBackAndIterate) {
+    SmallChunks chunked;
+    std::vector<int> reference;
+    for (int i = 0; i < 100; ++i) {
+        chunked.push_back(i);
+        reference.push_back(i);
+    }
+    expectSame(chunked, reference);
+    EXPECT_EQ(chunked.front(), 0);
+    EXPECT_EQ(chunked.back(), 99);
+    EXPECT_EQ(chunked.end() - chunked.begin(), 100);
+    EXPECT_EQ(*(chunked.begin() + 37), 37);
+    EXPECT_EQ(*(--chunked.end()), 99);
+}
+
+TEST(ChunkedVectorTests, RandomEditsMatchVector) {
+    SmallChunks chunked;
+    std::vector<int> reference;
+    std::mt19937 rng(1234);
+
+    for (int step = 0; step < 5000; ++step) {
+        int op = rng() % 6;
+        size_t index = reference.empty() ? 0 : rng() % (reference.size() + 1);
+        if (op <= 2 || reference.empty()) {
+            chunked.insert(chunked.begin() + index, step);
+            reference.insert(reference.begin() + index, step);
+        }
+        else if (op == 3 && index < reference.size()) {
+            chunked.erase(chunked.begin() + index);
+            reference.erase(reference.begin() + index);
+        }
+        else if (op == 4) {
+            std::vector<int> items(rng() % 20, step);
+            chunked.insert(chunked.begin() + index, items.begin(), items.end());
+            reference.insert(reference.begin() + index, items.begin(), items.end());
+        }
+        else {
+            size_t last = std::min(reference.size(), index + rng() % 30);
+            chunked.erase(chunked.begin() + index, chunked.begin() + last);
+            reference.erase(reference.begin() + index, reference.begin() + last);
+        }
+        if (step % 250 == 0) expectSame(chunked, reference);
+    }
+    expectSame(chunked, reference);
+
+    chunked.clear();
+    EXPECT_TRUE(chunked.empty());
+    EXPECT_EQ(chunked.begin(), chunked.end());
+}
+
+TEST(ChunkedVectorTests, MiddleInsertTouchesOneChunk) {
+    ChunkedVector<int, 64> chunked;
+    for (int i = 0; i < 6400; ++i) chunked.push_back(i);
+    size_t chunks = chunked.chunkCount();
+
+    chunked.insert(chunked.begin() + 3200, -1);
+    EXPECT_EQ(chunked[3200], -1);
+    EXPECT_EQ(chunked[3201], 3200);
+    EXPECT_LE(chunked.chunkCount(), chunks + 1);
+}
+
+TEST(ChunkedVectorTests, HoldsContourElements) {
+    ChunkedVector<ContourElement, 4> elements;
+    for (int i = 0; i < 10; ++i)
+        elements.push_back(Line2(Point2({ double(i), 0 }), Point2({ double(i + 1), 0 })));
+    elements.insert(elements.begin() + 5, Arc(Point2({ 0, 0 }), 1, 0, PI));
+
+    EXPECT_EQ(elements.size(), 11);
+    EXPECT_TRUE(std::holds_alternative<Arc>(elements[5]));
+    std::vector<ContourElement> copy(elements.begin(), elements.end());
+    EXPECT_EQ(copy.size(), 11);
+}
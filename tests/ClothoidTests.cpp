@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "Clothoid.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+// Composite Simpson quadrature of the clothoid position, reference only
+static Point2 integrate(const Point2& start, double heading, double curvature, double sharpness, double s)
+{
+    const int n = 20000;
+    const double h = s / n;
+    double x = 0, y = 0;
+    for (int i = 0; i <= n; ++i) {
+        double u = i * h;
+        double w = (i == 0 || i == n) ? 1 : (i % 2 ? 4 : 2);
+        double theta = heading + curvature * u + 0.5 * sharpness * u * u;
+        x += w * std::cos(theta);
+        y += w * std::sin(theta);
+    }
+    return Point2({ start.x + x * h / 3, start.y + y * h / 3 });
+}
+
+TEST(ClothoidTests, FresnelIntegralsMatchReferenceValues) {
+    double c, s;
+    fresnelIntegrals(1.0, c, s);
+    EXPECT_NEAR(c, 0.7798934003768228, 1E-15);
+    EXPECT_NEAR(s, 0.4382591473903548, 1E-15);
+    fresnelIntegrals(-2.0, c, s);
+    EXPECT_NEAR(c, -0.4882534060753408, 1E-15);
+    EXPECT_NEAR(s, -0.3434156783636982, 1E-15);
+    fresnelIntegrals(1E4, c, s);
+    EXPECT_NEAR(c, 0.5, 1E-4);
+    EXPECT_NEAR(s, 0.5, 1E-4);
+}
+
+TEST(ClothoidTests, PositionsMatchQuadrature) {
+    // Sharp spirals use Fresnel integrals, gentle ones the series, both must agree with quadrature
+    const double sharpnesses[] = { 0.8, -0.3, 1E-3, -1E-6, 0.0 };
+    for (double sharpness : sharpnesses) {
+        Clothoid clothoid(Point2({ 1, 2 }), 0.3, 0.5, sharpness, 3.0);
+        for (double t : { 0.1, 0.5, 1.0 }) {
+            Point2 expected = integrate(Point2({ 1, 2 }), 0.3, 0.5, sharpness, 3.0 * t);
+            EXPECT_TRUE(clothoid.getCoordinate(t).isCloseTo(expected, 1E-10)) << "sharpness " << sharpness << " t " << t;
+        }
+    }
+}
+
+TEST(ClothoidTests, DegeneratesToLineAndArc) {
+    Clothoid line(Point2({ 0, 0 }), PI / 4, 0.0, 0.0, std::sqrt(2.0));
+    EXPECT_TRUE(line.getCoordinate(1.0).isCloseTo(Point2({ 1, 1 }), 1E-14));
+
+    // Curvature 1 and no sharpness is a unit circle through the origin
+    Clothoid circle(Point2({ 0, 0 }), 0.0, 1.0, 0.0, PI);
+    EXPECT_TRUE(circle.getCoordinate(0.5).isCloseTo(Point2({ 1, 1 }), 1E-14));
+    EXPECT_TRUE(circle.getCoordinate(1.0).isCloseTo(Point2({ 0, 2 }), 1E-14));
+    EXPECT_NEAR(circle.getHeading(1.0), PI, 1E-15);
+
+    EXPECT_THROW(Clothoid(Point2({ 0, 0 }), 0.0, 1.0, 0.0, 0.0), std::invalid_argument);
+}
+
+TEST(ClothoidTests, BatchBoundsAndClosestParameter) {
+    Clothoid clothoid(Point2({ 0, 0 }), 0.0, 0.0, 2.0, 2.5);
+    std::vector<double> ts;
+    for (int i = 0; i <= 100; ++i) ts.push_back(i / 100.0);
+    auto points = clothoid.getCoordinates(ts);
+    EXPECT_THROW(clothoid.getCoordinates({ 0.5, 1.5 }), std::invalid_argument);
+
+    BoundingBox box = clothoid.getBounds();
+    for (size_t i = 0; i < ts.size(); ++i) {
+        EXPECT_TRUE(points[i].isCloseTo(clothoid.getCoordinate(ts[i]), EPS));
+        EXPECT_TRUE(box.contains(points[i]));
+        EXPECT_NEAR(clothoid.getClosestParameter(points[i]), ts[i], 1E-9);
+    }
+    // The spiral turns past PI, so the box is wider than the end points alone
+    EXPECT_GT(box.max.y, std::max(points.front().y, points.back().y) + 0.1);
+}
+
+TEST(ClothoidTests, FitG1MatchesEndsAndHeadings) {
+    Point2 p0({ 0, 0 });
+    Point2 p1({ 4, 1 });
+    Clothoid clothoid = Clothoid::fitG1(p0, 0.2, p1, 1.1);
+
+    EXPECT_TRUE(clothoid.getCoordinate(0.0).isCloseTo(p0, EPS));
+    EXPECT_TRUE(clothoid.getCoordinate(1.0).isCloseTo(p1, 1E-9));
+    EXPECT_NEAR(clothoid.getHeading(0.0), 0.2, 1E-12);
+    EXPECT_NEAR(clothoid.getHeading(1.0), 1.1, 1E-9);
+}
+
+TEST(ClothoidTests, ConnectsLineToArcInAContour) {
+    Line2 line(Point2({ -2, 0 }), Point2({ 0, 0 }));
+    Arc arc(Point2({ 3, 2 }), 1.0, -PI / 2, 0.0);
+    Clothoid transition = connectWithClothoid(line, arc);
+
+    EXPECT_NEAR(transition.getHeading(0.0), 0.0, 1E-12);
+    EXPECT_NEAR(transition.getHeading(1.0), elementHeading(arc, 0.0), 1E-9);
+
+    Contour contour;
+    contour.addItem(line);
+    contour.addItem(transition);
+    contour.addItem(arc);
+    EXPECT_TRUE(contour.isValid());
+}
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "CompactContour.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <cmath>
+#include <random>
+
+static std::vector<ContourElement> polyline(size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(-1, 1);
+    std::vector<ContourElement> elements;
+    Point2 p{ 100.0, -40.0 };
+    for (size_t i = 0; i < count; ++i) {
+        Point2 q{ p.x + 0.5 + u(rng), p.y + u(rng) };
+        elements.push_back(Line2(p, q));
+        p = q;
+    }
+    return elements;
+}
+
+TEST(CompactContourTests, RoundTripIsExact) {
+    Line2 reversed(Point2({ 1, 0 }), Point2({ 0, 0 }), false);
+    Arc arc(Point2({ 2, 1 }), 1, -0.5 * PI, 0.0, 10);
+    Arc backwards(Point2({ 1, 1 }), 1, 0.0, 0.5 * PI, 12, false);
+    std::vector<ContourElement> elements = {
+        reversed,
+        Line2(reversed.endPoint(), arc.startPoint()),
+        arc,
+        backwards,
+        Line2(backwards.endPoint(), Point2({ 0, 3 })),
+        CubicBezier(Point2({ 0, 3 }), Point2({ -1, 3 }), Point2({ -1, 2 }), Point2({ -2, 2 })),
+        BSpline({ {-2, 2}, {-3, 1}, {-2, 0}, {-3, -1}, {-2, -2} }, 3),
+        Clothoid(Point2({ -2, -2 }), 0.3, 0.1, 0.2, 2.0),
+    };
+    Contour contour;
+    contour.addItems(elements);
+    CompactContour compact(contour);
+    ASSERT_EQ(compact.size(), elements.size());
+    EXPECT_FALSE(compact.isQuantized());
+    EXPECT_TRUE(compact.toContour() == contour);
+
+    auto decoded = compact.elements();
+    for (size_t i = 0; i < elements.size(); ++i) {
+        const Segment& a = asSegment(elements[i]);
+        const Segment& b = asSegment(decoded[i]);
+        EXPECT_EQ(a.startPoint().x, b.startPoint().x) << i;
+        EXPECT_EQ(a.startPoint().y, b.startPoint().y) << i;
+        EXPECT_EQ(a.endPoint().x, b.endPoint().x) << i;
+        EXPECT_EQ(a.endPoint().y, b.endPoint().y) << i;
+        EXPECT_TRUE(compact.at(i) == decoded[i]) << i;
+    }
+    EXPECT_EQ(compact.toContour().isValid(), contour.isValid());
+    EXPECT_THROW(compact.at(elements.size()), std::out_of_range);
+}
+
+TEST(CompactContourTests, QuantizedChainsStayClosed) {
+    auto elements = polyline(2000, 5);
+    elements.push_back(Line2(asSegment(elements.back()).endPoint(), asSegment(elements.front()).startPoint()));
+    CompactOptions options;
+    options.quantize = true;
+    options.quantum = 1E-6;
+    CompactContour compact(elements, options);
+    EXPECT_TRUE(compact.isQuantized());
+
+    Contour decoded = compact.toContour();
+    EXPECT_TRUE(decoded.isValid());
+    auto result = decoded.getElements();
+    ASSERT_EQ(result.size(), elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+        EXPECT_TRUE(asSegment(result[i]).endPoint().isCloseTo(asSegment(elements[i]).endPoint(), 1E-6)) << i;
+    }
+
+    // Lines shorter than the grid and coordinates beyond its range are rejected
+    options.quantum = 10.0;
+    EXPECT_THROW(CompactContour(elements, options), std::invalid_argument);
+    options.quantum = 1E-12;
+    EXPECT_THROW(CompactContour(elements, options), std::invalid_argument);
+}
+
+TEST(CompactContourTests, QuantizedJointsNextToArcsStayClosed) {
+    // Closed loop that starts with an Arc, with Arcs and a CubicBezier between Line2s at coordinates off the grid
+    Arc first(Point2({ 3.1234567, 2.7654321 }), 1.3, 0.1, 1.9, 20);
+    Arc second(Point2({ -4.2222222, 5.3333333 }), 0.7777777, -0.3, 2.2, 20, false);
+    Line2 toSecond(first.endPoint(), second.startPoint());
+    Point2 corner({ -7.7777777, -1.1111111 });
+    CubicBezier curve(second.endPoint(), Point2({ -6.1, 7.2 }), Point2({ -8.3, 2.9 }), corner);
+    std::vector<ContourElement> elements = {
+        first,
+        toSecond,
+        second,
+        curve,
+        Line2(first.startPoint(), corner, false),
+    };
+
+    CompactOptions options;
+    options.quantize = true;
+    options.quantum = 1E-6;
+    CompactContour compact(elements, options);
+    Contour decoded = compact.toContour();
+    EXPECT_TRUE(decoded.isValid());
+    EXPECT_TRUE(decoded.isClosed());
+    auto result = decoded.getElements();
+    ASSERT_EQ(result.size(), elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+        EXPECT_TRUE(asSegment(result[i]).startPoint().isCloseTo(asSegment(elements[i]).startPoint(), 1E-6)) << i;
+        // Random access decodes the same points as the sequential pass
+        const ContourElement single = compact.at(i);
+        EXPECT_EQ(asSegment(single).startPoint().x, asSegment(result[i]).startPoint().x) << i;
+        EXPECT_EQ(asSegment(single).endPoint().y, asSegment(result[i]).endPoint().y) << i;
+    }
+    EXPECT_FALSE(std::get<Line2>(result.back()).isForwards());
+
+    // Without quantization the same loop decodes exactly
+    CompactContour exact(elements);
+    Contour original;
+    original.addItems(elements);
+    EXPECT_TRUE(exact.toContour() == original);
+}
+
+TEST(CompactContourTests, MemoryReport) {
+    auto lines = polyline(10000, 2);
+    ContourMemoryReport report = memoryReport(lines);
+    EXPECT_EQ(report.elements, lines.size());
+    EXPECT_EQ(report.element_bytes, lines.size() * sizeof(ContourElement));
+    // Joined lines keep a tag, their end point and an offset
+    EXPECT_LE(report.compact_bytes, lines.size() * (1 + 2 * sizeof(double) + sizeof(uint32_t)) + 2 * sizeof(double));
+    EXPECT_LT(report.quantized_bytes, report.compact_bytes);
+    EXPECT_GT(report.element_bytes, 4 * report.compact_bytes);
+    EXPECT_NE(report.toString().find("sizeof ContourElement"), std::string::npos);
+}
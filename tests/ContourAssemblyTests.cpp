@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourAssembly.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <algorithm>
+#include <random>
+
+static std::vector<ContourElement> shuffledSoup(const Contour& contour, unsigned seed)
+{
+    std::vector<ContourElement> soup = contour.getElements();
+    std::mt19937 rng(seed);
+    std::shuffle(soup.begin(), soup.end(), rng);
+    for (auto& e : soup) {
+        if (rng() % 2) e = reverseElement(e);
+    }
+    return soup;
+}
+
+TEST(ContourAssemblyTests, ReverseElementRunsBackwards) {
+    std::vector<ContourElement> elements = {
+        Line2(Point2({ 0, 0 }), Point2({ 2, 1 })),
+        Arc(Point2({ 0, 0 }), 2.0, 0.2, 1.4),
+        CubicBezier(Point2({ 0, 0 }), Point2({ 1, 2 }), Point2({ 2, -1 }), Point2({ 3, 0 })),
+        BSpline({ {0, 0}, {1, 2}, {3, 2}, {4, 0}, {5, 1} }, { 0, 0, 0, 0, 0.3, 1, 1, 1, 1 }),
+        Clothoid(Point2({ 1, 1 }), 0.3, 0.2, 0.5, 2.0),
+    };
+    for (const auto& e : elements) {
+        ContourElement r = reverseElement(e);
+        for (double t : { 0.0, 0.25, 0.6, 1.0 }) {
+            Point2 a = std::visit([&](const auto& seg) { return seg.getCoordinate(t); }, e);
+            Point2 b = std::visit([&](const auto& seg) { return seg.getCoordinate(1 - t); }, r);
+            EXPECT_TRUE(a.isCloseTo(b, 1E-12)) << "element " << e.index() << " t " << t;
+        }
+        // The strip runs backwards too
+        std::vector<Point2> forward = std::visit([](const auto& seg) { return seg.getLineStrip(); }, e);
+        std::vector<Point2> backward = std::visit([](const auto& seg) { return seg.getLineStrip(); }, r);
+        EXPECT_TRUE(forward.front().isCloseTo(backward.back(), 1E-12)) << "element " << e.index();
+        EXPECT_TRUE(forward.back().isCloseTo(backward.front(), 1E-12)) << "element " << e.index();
+    }
+}
+
+TEST(ContourAssemblyTests, AssemblesClosedLoop) {
+    Contour square = contourFromPoints({ {0, 0}, {1, 0}, {1, 1}, {0, 1}, {0, 0} });
+    auto contours = assembleContours(shuffledSoup(square, 1));
+
+    ASSERT_EQ(contours.size(), 1);
+    EXPECT_EQ(contours[0].getElements().size(), 4);
+    EXPECT_TRUE(contours[0].isValid());
+    EXPECT_TRUE(contours[0].isClosed());
+
+    // Reversed lines are drawn in traversal order, every strip starts where the previous one ended
+    const std::vector<Point2> strip = contours[0].getLineStrip();
+    ASSERT_EQ(strip.size(), 8);
+    for (size_t i = 1; i + 1 < strip.size(); i += 2) {
+        EXPECT_TRUE(strip[i].isCloseTo(strip[i + 1], 1E-12)) << i;
+    }
+    EXPECT_TRUE(strip.back().isCloseTo(strip.front(), 1E-12));
+    TessellationSettings settings;
+    settings.tolerance = 0.01;
+    const std::vector<Point2>& points = contours[0].tessellate(settings)->points;
+    ASSERT_EQ(points.size(), strip.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_TRUE(points[i].isCloseTo(strip[i], 1E-12)) << i;
+    }
+}
+
+TEST(ContourAssemblyTests, AssemblesOpenChainsWithArcs) {
+    Contour first;
+    first.addItem(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    first.addItem(Arc(Point2({ 1, 1 }), 1.0, -PI / 2, 0.0));
+    first.addItem(Line2(Point2({ 2, 1 }), Point2({ 2, 3 })));
+    Contour second = contourFromPoints({ {10, 10}, {11, 10}, {12, 11} });
+
+    std::vector<ContourElement> soup = shuffledSoup(first, 2);
+    auto more = shuffledSoup(second, 3);
+    soup.insert(soup.end(), more.begin(), more.end());
+    std::shuffle(soup.begin(), soup.end(), std::mt19937(4));
+
+    auto contours = assembleContours(soup);
+    ASSERT_EQ(contours.size(), 2);
+    for (const auto& c : contours) {
+        EXPECT_TRUE(c.isValid());
+        EXPECT_FALSE(c.isClosed());
+    }
+    EXPECT_EQ(contours[0].getElements().size() + contours[1].getElements().size(), 5);
+}
+
+TEST(ContourAssemblyTests, LargeSoupWithinTolerance) {
+    // A ring of 100000 Line2s, joints perturbed below the tolerance
+    const int n = 100000;
+    std::vector<Point2> points;
+    for (int i = 0; i < n; ++i) {
+        double a = 2 * PI * i / n;
+        points.push_back(Point2{ 1000 * std::cos(a), 1000 * std::sin(a) });
+    }
+    std::vector<ContourElement> soup;
+    for (int i = 0; i < n; ++i) {
+        Point2 next = points[(i + 1) % n];
+        soup.push_back(Line2(points[i], Point2({ next.x + 1E-10, next.y })));
+    }
+    std::shuffle(soup.begin(), soup.end(), std::mt19937(5));
+
+    auto contours = assembleContours(soup, 1E-9);
+    ASSERT_EQ(contours.size(), 1);
+    EXPECT_EQ(contours[0].getElements().size(), n);
+}
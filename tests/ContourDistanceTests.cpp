@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourDistance.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+// Unit square built from Line2s, counter clockwise
+static Contour makeSquare()
+{
+    return contourFromPoints({ Point2{0, 0}, Point2{1, 0}, Point2{1, 1}, Point2{0, 1}, Point2{0, 0} });
+}
+
+// Capsule of two half circles joined by lines
+static Contour makeCapsule()
+{
+    Contour capsule;
+    capsule.addItem(Line2(Point2({ 0, -1 }), Point2({ 4, -1 })));
+    capsule.addItem(Arc(Point2({ 4, 0 }), 1, -0.5 * PI, 0.5 * PI));
+    capsule.addItem(Line2(Point2({ 4, 1 }), Point2({ 0, 1 })));
+    capsule.addItem(Arc(Point2({ 0, 0 }), 1, 0.5 * PI, 1.5 * PI));
+    return capsule;
+}
+
+TEST(ContourDistanceTests, ClosestPointOnLine) {
+    Contour contour = makeSquare();
+    ClosestPoint c = closestPoint(contour, Point2{ 0.5, -2 });
+
+    EXPECT_NEAR(c.distance, 2.0, 1e-12);
+    EXPECT_EQ(c.element_index, 0);
+    EXPECT_NEAR(c.t, 0.5, 1e-12);
+    EXPECT_FALSE(c.inside);
+    EXPECT_NEAR(c.signed_distance, 2.0, 1e-12);
+}
+
+TEST(ContourDistanceTests, SignedDistanceInsideClosedContour) {
+    Contour contour = makeSquare();
+    ASSERT_TRUE(contour.isClosed());
+
+    ClosestPoint c = closestPoint(contour, Point2{ 0.25, 0.5 });
+    EXPECT_TRUE(c.inside);
+    EXPECT_NEAR(c.signed_distance, -0.25, 1e-12);
+    EXPECT_EQ(c.element_index, 3);
+}
+
+TEST(ContourDistanceTests, ClosestPointOnArc) {
+    Contour capsule = makeCapsule();
+    ASSERT_TRUE(capsule.isClosed());
+
+    ClosestPoint c = closestPoint(capsule, Point2{ 7, 0 });
+    EXPECT_EQ(c.element_index, 1);
+    EXPECT_NEAR(c.distance, 2.0, 1e-12);
+    EXPECT_NEAR(c.t, 0.5, 1e-12);
+    EXPECT_NEAR(c.point.x, 5.0, 1e-12);
+
+    // Inside the left half disc, only the arc decides containment
+    ClosestPoint inside = closestPoint(capsule, Point2{ -0.5, 0.1 });
+    EXPECT_TRUE(inside.inside);
+    EXPECT_LT(inside.signed_distance, 0.0);
+}
+
+TEST(ContourDistanceTests, OpenContourIsUnsigned) {
+    Contour contour = contourFromPoints({ Point2{0, 0}, Point2{1, 0}, Point2{1, 1} });
+    EXPECT_FALSE(contour.isClosed());
+
+    ClosestPoint c = closestPoint(contour, Point2{ 0.5, 0.25 });
+    EXPECT_FALSE(c.inside);
+    EXPECT_NEAR(c.signed_distance, 0.25, 1e-12);
+}
+
+TEST(ContourDistanceTests, IndexMatchesLinearScan) {
+    // Long closed polyline approximating a wobbly circle
+    std::vector<Point2> points;
+    const int n = 2000;
+    for (int i = 0; i < n; ++i) {
+        double a = 2 * PI * i / n;
+        double r = 10 + std::sin(7 * a);
+        points.push_back(Point2{ r * std::cos(a), r * std::sin(a) });
+    }
+    points.push_back(points.front());
+    Contour contour = contourFromPoints(points);
+    ContourDistanceIndex index(contour);
+    ASSERT_TRUE(index.isClosed());
+
+    std::vector<Point2> queries;
+    for (int j = -15; j <= 15; j += 3)
+        for (int i = -15; i <= 15; i += 3)
+            queries.push_back(Point2{ i + 0.1, j + 0.2 });
+
+    auto batched = index.closestPoints(queries, 4);
+    ASSERT_EQ(batched.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        ClosestPoint expected = closestPoint(contour, queries[i]);
+        EXPECT_NEAR(batched[i].distance, expected.distance, 1e-12);
+        EXPECT_EQ(batched[i].inside, expected.inside);
+    }
+}
+
+TEST(ContourDistanceTests, SignedDistanceField) {
+    ContourDistanceIndex index(makeSquare());
+    DistanceFieldGrid grid{ Point2{ -0.5, -0.5 }, 0.5, 5, 5 };
+
+    auto field = index.signedDistanceField(grid, 2);
+    ASSERT_EQ(field.size(), 25);
+    EXPECT_NEAR(field[2 * 5 + 2], -0.5, 1e-12); // center of the square
+    EXPECT_NEAR(field[0], std::sqrt(0.5), 1e-12); // outside corner
+    EXPECT_NEAR(field[1 * 5 + 1], 0.0, 1e-12); // on the boundary
+}
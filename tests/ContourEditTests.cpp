@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+#include <atomic>
+#include <thread>
+
+static Line2 segment(double x0, double x1)
+{
+    return Line2(Point2({ x0, 0 }), Point2({ x1, 0 }));
+}
+
+TEST(ContourEditTests, AppliesOperationsInOrder) {
+    Contour contour;
+    contour.addItem(segment(0, 1));
+    contour.addItem(segment(5, 6));
+
+    ContourEdit edit;
+    edit.insert(1, std::vector<ContourElement>{ segment(1, 2), segment(2, 3), segment(3, 4) })
+        .replace(4, segment(4, 5))
+        .append(segment(5, 6))
+        .erase(5);
+
+    EXPECT_TRUE(contour.apply(edit));
+    auto elements = contour.getElements();
+    ASSERT_EQ(elements.size(), 5);
+    for (size_t i = 0; i < elements.size(); ++i)
+        EXPECT_EQ(std::get<Line2>(elements[i]), segment(static_cast<double>(i), static_cast<double>(i + 1)));
+}
+
+TEST(ContourEditTests, OutOfRangeLeavesContourUnchanged) {
+    Contour contour = contourFromPoints({ Point2{0, 0}, Point2{1, 0}, Point2{2, 0} });
+
+    ContourEdit edit;
+    edit.erase(0, 2).replace(0, segment(0, 1));
+
+    EXPECT_THROW(contour.apply(edit), std::out_of_range);
+    EXPECT_EQ(contour.getElements().size(), 2);
+    EXPECT_TRUE(contour.isValid());
+}
+
+TEST(ContourEditTests, ApplyRevalidates) {
+    Contour contour = contourFromPoints({ Point2{0, 0}, Point2{1, 0}, Point2{2, 0} });
+    EXPECT_TRUE(contour.isValid());
+
+    EXPECT_FALSE(contour.apply(ContourEdit().replace(1, segment(3, 4))));
+    EXPECT_FALSE(contour.isValid());
+    EXPECT_TRUE(contour.apply(ContourEdit().clear()));
+    EXPECT_EQ(contour.getElements().size(), 0);
+}
+
+TEST(ContourEditTests, RangeInsertAndErase) {
+    Contour contour;
+    contour.addItems({ segment(0, 1), segment(3, 4) });
+    contour.insertItems(1, { segment(1, 2), segment(2, 3) });
+    EXPECT_EQ(contour.getElements().size(), 4);
+    EXPECT_TRUE(contour.isValid());
+
+    contour.eraseRange(1, 3);
+    EXPECT_EQ(contour.getElements().size(), 2);
+    EXPECT_FALSE(contour.isValid());
+
+    EXPECT_THROW(contour.insertItems(3, { segment(0, 1) }), std::out_of_range);
+    EXPECT_THROW(contour.eraseRange(1, 3), std::out_of_range);
+}
+
+TEST(ContourEditTests, ReadersNeverSeeHalfAppliedEdits) {
+    Contour contour = contourFromPoints({ Point2{0, 0}, Point2{1, 0}, Point2{2, 0} });
+    std::atomic<bool> stop{ false };
+    std::atomic<int> bad_states{ 0 };
+
+    std::thread reader([&]() {
+        while (!stop) {
+            size_t n = contour.getElements().size();
+            if (n != 2 && n != 4) ++bad_states;
+        }
+    });
+
+    for (int i = 0; i < 200; ++i) {
+        contour.apply(ContourEdit().append(segment(2, 3)).append(segment(3, 4)));
+        contour.apply(ContourEdit().erase(2, 4));
+    }
+    stop = true;
+    reader.join();
+    EXPECT_EQ(bad_states, 0);
+}
@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourImport.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+static std::string dxfLine(double x1, double y1, double x2, double y2)
+{
+    std::ostringstream out;
+    out.precision(17);
+    out << "  0\nLINE\n  8\n0\n 10\n" << x1 << "\n 20\n" << y1 << "\n 11\n" << x2 << "\n 21\n" << y2 << "\n";
+    return out.str();
+}
+
+static std::string dxfSection(const std::string& entities)
+{
+    return "  0\nSECTION\n  2\nHEADER\n  9\n$ACADVER\n  1\nAC1015\n  0\nENDSEC\n"
+        "  0\nSECTION\n  2\nENTITIES\n" + entities + "  0\nENDSEC\n  0\nEOF\n";
+}
+
+TEST(ContourImportTests, DXFChainsLinesAndArcs) {
+    // Square with a rounded corner, the ARC end points only meet the lines up to rounding
+    std::string entities = dxfLine(0, 0, 2, 0) +
+        "  0\nARC\n 10\n2\n 20\n1\n 40\n1\n 50\n270\n 51\n0\n" +
+        dxfLine(3, 1, 3, 3) + dxfLine(3, 3, 0, 3) + dxfLine(0, 3, 0, 0) +
+        // Far away, starts a new contour
+        dxfLine(10, 10, 11, 10) +
+        "  0\nCIRCLE\n 10\n5\n 20\n5\n 40\n0.5\n" +
+        "  0\nTEXT\n  1\nignored\n";
+    auto contours = parseDXF(dxfSection(entities));
+    ASSERT_EQ(contours.size(), 3);
+    EXPECT_EQ(contours[0].getElements().size(), 5);
+    EXPECT_TRUE(contours[0].isValid());
+    EXPECT_TRUE(contours[0].isClosed());
+    EXPECT_TRUE(std::holds_alternative<Arc>(contours[0].getElements()[1]));
+    EXPECT_EQ(contours[1].getElements().size(), 1);
+    EXPECT_TRUE(contours[2].isClosed());
+}
+
+TEST(ContourImportTests, DXFPolylineBulges) {
+    // Closed slot: two straight sides and two half circles given by bulge 1
+    std::string polyline = "  0\nLWPOLYLINE\n 90\n4\n 70\n1\n"
+        " 10\n0\n 20\n0\n"
+        " 10\n4\n 20\n0\n 42\n1\n"
+        " 10\n4\n 20\n2\n"
+        " 10\n0\n 20\n2\n 42\n1.0\n";
+    auto contours = parseDXF(polyline);
+    ASSERT_EQ(contours.size(), 1);
+    auto elements = contours[0].getElements();
+    ASSERT_EQ(elements.size(), 4);
+    EXPECT_TRUE(contours[0].isValid());
+    EXPECT_TRUE(contours[0].isClosed());
+    const Arc* arc = std::get_if<Arc>(&elements[1]);
+    ASSERT_NE(arc, nullptr);
+    Point2 middle = arc->getCoordinate(0.5);
+    EXPECT_TRUE(middle.isCloseTo(Point2({ 5, 1 }), 1E-9));
+
+    EXPECT_THROW(parseDXF("  0\nLINE\n 10\nabc\n"), std::invalid_argument);
+}
+
+TEST(ContourImportTests, SVGPathCommands) {
+    auto contours = parseSVGPath("M 0,0 h 4 A 1 1 0 0 1 5 1 v2 L0 3 z m 10 0 c 1 1 2 1 3 0 M20 20 a2 1 0 1 0 4 0");
+    ASSERT_EQ(contours.size(), 3);
+    EXPECT_TRUE(contours[0].isValid());
+    EXPECT_TRUE(contours[0].isClosed());
+    auto square = contours[0].getElements();
+    ASSERT_EQ(square.size(), 5);
+    EXPECT_TRUE(std::holds_alternative<Arc>(square[1]));
+
+    auto curve = contours[1].getElements();
+    ASSERT_EQ(curve.size(), 1);
+    EXPECT_TRUE(std::holds_alternative<CubicBezier>(curve[0]));
+    Point2 end = std::get<CubicBezier>(curve[0]).getCoordinate(1.0);
+    EXPECT_TRUE(end.isCloseTo(Point2({ 13, 0 }), 1E-12));
+
+    // Elliptical arcs are sampled, the large flag picks the long way round
+    EXPECT_TRUE(contours[2].isValid());
+    EXPECT_GT(contours[2].getElements().size(), 8);
+    for (const auto& e : contours[2].getElements()) {
+        EXPECT_TRUE(std::holds_alternative<Line2>(e));
+    }
+
+    EXPECT_THROW(parseSVGPath("M 0 0 Q 1 1 2 0"), std::invalid_argument);
+    EXPECT_THROW(parseSVGPath("M 0 0 L 1"), std::invalid_argument);
+}
+
+TEST(ContourImportTests, FilesAreParsedInChunks) {
+    std::string entities;
+    for (int i = 0; i < 300; ++i) {
+        // Triangles, each a chain of three LINE entities
+        const double x = 3.0 * i;
+        entities += dxfLine(x, 0, x + 1, 0) + dxfLine(x + 1, 0, x, 1) + dxfLine(x, 1, x, 0);
+    }
+    const std::string text = dxfSection(entities);
+    const std::string filename = "contour_import_test.dxf";
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file << text;
+    }
+
+    ImportOptions options;
+    options.chunk_size = 1000;
+    options.num_threads = 4;
+    auto expected = parseDXF(text);
+    size_t streamed = 0;
+    size_t count = importDXF(filename, [&](Contour&& contour) {
+        ASSERT_LT(streamed, expected.size());
+        EXPECT_TRUE(contour == expected[streamed]);
+        EXPECT_TRUE(contour.isClosed());
+        ++streamed;
+    }, options);
+    std::remove(filename.c_str());
+    EXPECT_EQ(count, 300);
+    EXPECT_EQ(streamed, 300);
+
+    std::string svg = "<svg xmlns=\"http://www.w3.org/2000/svg\">\n";
+    for (int i = 0; i < 200; ++i) {
+        svg += "<path id=\"p" + std::to_string(i) + "\" d='M" + std::to_string(i) + " 0 l1 0 l0 1 Z'/>\n";
+    }
+    svg += "</svg>\n";
+    const std::string svg_name = "contour_import_test.svg";
+    {
+        std::ofstream file(svg_name, std::ios::binary);
+        file << svg;
+    }
+    auto paths = importSVG(svg_name, options);
+    std::remove(svg_name.c_str());
+    ASSERT_EQ(paths.size(), 200);
+    EXPECT_TRUE(paths[199].getElements().front() == ContourElement(Line2(Point2({ 199, 0 }), Point2({ 200, 0 }))));
+    EXPECT_THROW(importSVG("missing_file.svg"), std::runtime_error);
+}
@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourLOD.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+// Closed wavy ring with many short Line2s
+static Contour makeRing(int n)
+{
+    std::vector<Point2> points;
+    for (int i = 0; i < n; ++i) {
+        double a = 2 * PI * i / n;
+        double r = 100 + 5 * std::sin(12 * a);
+        points.push_back(Point2{ r * std::cos(a), r * std::sin(a) });
+    }
+    points.push_back(points.front());
+    return contourFromPoints(points);
+}
+
+TEST(ContourLODTests, SimplifyPolylineKeepsEndsAndCorners) {
+    std::vector<Point2> points = { {0, 0}, {1, 0.001}, {2, 0}, {3, 0.001}, {4, 0}, {4, 4} };
+    auto simplified = simplifyPolyline(points, 0.01);
+
+    ASSERT_EQ(simplified.size(), 3);
+    EXPECT_TRUE(simplified[0].isCloseTo(Point2({ 0, 0 }), EPS));
+    EXPECT_TRUE(simplified[1].isCloseTo(Point2({ 4, 0 }), EPS));
+    EXPECT_TRUE(simplified[2].isCloseTo(Point2({ 4, 4 }), EPS));
+}
+
+TEST(ContourLODTests, LevelsGetCoarserWithBoundedError) {
+    Contour ring = makeRing(20000);
+    ContourLOD lod(ring, 1e-3);
+    lod.wait();
+    ASSERT_TRUE(lod.isReady());
+    ASSERT_GT(lod.levelCount(), 5);
+
+    EXPECT_EQ(lod.level(0)->points.size(), 20001);
+    for (size_t k = 1; k < lod.levelCount(); ++k) {
+        EXPECT_LE(lod.level(k)->points.size(), lod.level(k - 1)->points.size());
+        EXPECT_GT(lod.level(k)->max_error, lod.level(k - 1)->max_error);
+    }
+}
+
+TEST(ContourLODTests, SelectPicksCoarsestLevelWithinTolerance) {
+    Contour ring = makeRing(20000);
+    ContourLOD lod(ring, 1e-3);
+    lod.wait();
+
+    // Zoomed out: one unit is a tenth of a pixel, half a pixel allows 5 units of error
+    auto coarse = lod.select(0.1, 0.5);
+    ASSERT_NE(coarse, nullptr);
+    EXPECT_LE(coarse->max_error, 5.0);
+    EXPECT_LT(coarse->points.size(), 2000);
+
+    size_t k = 0;
+    while (lod.level(k)->points.size() != coarse->points.size()) {
+        ++k;
+    }
+    if (k + 1 < lod.levelCount()) {
+        EXPECT_GT(lod.level(k + 1)->max_error, 5.0);
+    }
+
+    // Zoomed far in, only the full tessellation is good enough
+    auto fine = lod.select(1e6, 0.5);
+    EXPECT_EQ(fine->points.size(), 20001);
+}
+
+TEST(ContourLODTests, RebuildsWhenContourChanges) {
+    Contour contour = contourFromPoints({ Point2{0, 0}, Point2{10, 0}, Point2{10, 10} });
+    ContourLOD lod(contour);
+    lod.wait();
+    EXPECT_FALSE(lod.isStale());
+    EXPECT_EQ(lod.level(0)->points.size(), 3);
+
+    contour.addItem(Line2(Point2({ 10, 10 }), Point2({ 0, 10 })));
+    EXPECT_TRUE(lod.isStale());
+    EXPECT_TRUE(lod.update());
+    lod.wait();
+    EXPECT_FALSE(lod.isStale());
+    EXPECT_EQ(lod.level(0)->points.size(), 4);
+}
+
+TEST(ContourLODTests, SelectDoesNotWaitForRebuilds) {
+    Contour ring = makeRing(100000);
+    ContourLOD lod(ring, 1e-3);
+    lod.wait();
+    auto before = lod.select(1.0);
+    ASSERT_NE(before, nullptr);
+
+    // The ring ends at (100, 0), the second edit lands while the rebuild for the first runs
+    ring.addItem(Line2(Point2({ 100, 0 }), Point2({ 0, 0 })));
+    EXPECT_TRUE(lod.update());
+    ring.addItem(Line2(Point2({ 0, 0 }), Point2({ 0, -10 })));
+    EXPECT_FALSE(lod.update());
+    auto during = lod.select(1.0);
+    EXPECT_EQ(during.get(), before.get());
+    EXPECT_TRUE(lod.isStale());
+
+    // The running rebuild chains the one for the second edit
+    lod.wait();
+    EXPECT_FALSE(lod.isStale());
+    EXPECT_EQ(lod.level(0)->points.size(), 100001 + 2);
+}
+
+TEST(ContourLODTests, GapsStartNewRuns) {
+    Contour contour;
+    contour.addItem(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    contour.addItem(Arc(Point2({ 5, 0 }), 1, 0, PI, 10));
+    ContourLOD lod(contour);
+    lod.wait();
+
+    auto base = lod.level(0);
+    ASSERT_EQ(base->run_offsets.size(), 2);
+    EXPECT_EQ(base->run_offsets[1], 2);
+    EXPECT_EQ(base->points.size(), 2 + 11);
+    EXPECT_GT(base->max_error, 0.0);
+}
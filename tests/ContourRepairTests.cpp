@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourRepair.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+TEST(ContourRepairTests, MergesCollinearLines) {
+    Contour contour = contourFromPoints({ {0, 0}, {1, 0}, {2, 0}, {3, 0}, {3, 1}, {3, 2} });
+    RepairReport report;
+    Contour repaired = repairContour(contour, RepairOptions(), &report);
+
+    auto elements = repaired.getElements();
+    ASSERT_EQ(elements.size(), 2);
+    EXPECT_TRUE(std::get<Line2>(elements[0]) == Line2(Point2({ 0, 0 }), Point2({ 3, 0 })));
+    EXPECT_TRUE(std::get<Line2>(elements[1]) == Line2(Point2({ 3, 0 }), Point2({ 3, 2 })));
+    EXPECT_TRUE(repaired.isValid());
+    EXPECT_EQ(report.input_elements, 5);
+    EXPECT_EQ(report.output_elements, 2);
+    EXPECT_EQ(report.merged_lines, 3);
+}
+
+TEST(ContourRepairTests, SnapsNearMissJointsAndDropsDegenerates) {
+    Contour contour;
+    contour.addItem(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    contour.addItem(Line2(Point2({ 1, 1E-8 }), Point2({ 1, 1 })));           // near miss
+    contour.addItem(Line2(Point2({ 1, 1 }), Point2({ 1 + 1E-9, 1 + 1E-9 }))); // degenerate
+    contour.addItem(Line2(Point2({ 1, 1 }), Point2({ 0, 1 })));
+    contour.addItem(Line2(Point2({ 0, 1 }), Point2({ 0, 1E-8 })));           // nearly closed
+    EXPECT_FALSE(contour.isValid());
+
+    RepairReport report;
+    Contour repaired = repairContour(contour, RepairOptions(), &report);
+
+    EXPECT_TRUE(repaired.isValid());
+    EXPECT_TRUE(repaired.isClosed());
+    EXPECT_EQ(repaired.getElements().size(), 4);
+    EXPECT_EQ(report.dropped_degenerate, 1);
+    EXPECT_EQ(report.snapped_joints, 2);
+    EXPECT_EQ(report.open_gaps, 0);
+}
+
+TEST(ContourRepairTests, SnapsCurveEnds) {
+    // The Arc is rigid, the Bezier start moves onto its end
+    Arc arc(Point2({ 0, 0 }), 1.0, 0.0, PI / 2, 10);
+    const Point2 joint = arc.endPoint();
+    Contour contour;
+    contour.addItem(arc);
+    contour.addItem(CubicBezier(Point2({ joint.x + 1E-4, joint.y }), Point2({ -1, 1 }), Point2({ -1, 0.5 }), Point2({ -2, 0 })));
+    EXPECT_FALSE(contour.isValid());
+
+    RepairOptions options;
+    options.snap_tolerance = 1E-3;
+    RepairReport report;
+    Contour repaired = repairContour(contour, options, &report);
+
+    EXPECT_EQ(report.snapped_joints, 1);
+    EXPECT_EQ(report.open_gaps, 0);
+    EXPECT_TRUE(repaired.isValid());
+    auto elements = repaired.getElements();
+    ASSERT_EQ(elements.size(), 2);
+    const CubicBezier& curve = std::get<CubicBezier>(elements[1]);
+    EXPECT_TRUE(curve.startPoint().isCloseTo(joint, EPS));
+    EXPECT_TRUE(curve.getCoordinate(0.0).isCloseTo(curve.startPoint(), EPS));
+}
+
+TEST(ContourRepairTests, MergesCoCircularArcs) {
+    Contour contour;
+    contour.addItem(Arc(Point2({ 0, 0 }), 2.0, 0.0, PI / 4, 10));
+    contour.addItem(Arc(Point2({ 0, 0 }), 2.0, PI / 4, PI / 2, 10));
+    contour.addItem(Arc(Point2({ 0, 0 }), 2.0, PI / 2, PI, 10));
+    contour.addItem(Line2(Point2({ -2, 0 }), Point2({ 2, 0 })));
+
+    RepairReport report;
+    Contour repaired = repairContour(contour, RepairOptions(), &report);
+
+    auto elements = repaired.getElements();
+    ASSERT_EQ(elements.size(), 2);
+    const Arc& arc = std::get<Arc>(elements[0]);
+    EXPECT_NEAR(arc.getStartAngle(), 0.0, EPS);
+    EXPECT_NEAR(arc.getEndAngle(), PI, 1E-12);
+    EXPECT_EQ(report.merged_arcs, 2);
+    EXPECT_TRUE(repaired.isValid());
+    EXPECT_TRUE(repaired.isClosed());
+}
+
+TEST(ContourRepairTests, BridgesRigidPairsAndReportsOpenGaps) {
+    Contour contour;
+    contour.addItem(Arc(Point2({ 0, 0 }), 1.0, 0.0, PI / 2));
+    contour.addItem(Arc(Point2({ 1E-7, 2 }), 1.0, -PI / 2, -PI)); // starts 1E-7 from the first arc's end
+    contour.addItem(Line2(Point2({ 5, 5 }), Point2({ 6, 5 })));     // far away
+
+    RepairReport report;
+    Contour repaired = repairContour(contour, RepairOptions(), &report);
+
+    EXPECT_EQ(report.bridged_joints, 1);
+    EXPECT_EQ(report.open_gaps, 1);
+    EXPECT_EQ(repaired.getElements().size(), 4);
+    EXPECT_FALSE(repaired.isValid());
+}
@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourDistance.h"
+#include "ContourSampler.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <cmath>
+
+static void lorenz(double, const OdeState& y, OdeState& dydt)
+{
+    dydt[0] = 10.0 * (y[1] - y[0]);
+    dydt[1] = y[0] * (28.0 - y[2]) - y[1];
+    dydt[2] = y[0] * y[1] - 8.0 / 3.0 * y[2];
+}
+
+// Classic RK4 with a tiny fixed step, the reference trajectory
+static std::vector<Point2> lorenzReference(OdeState y, double t1, double dt)
+{
+    std::vector<Point2> points{ Point2({ y[0], y[1] }) };
+    OdeState k1(3), k2(3), k3(3), k4(3), tmp(3);
+    const size_t steps = static_cast<size_t>(std::llround(t1 / dt));
+    for (size_t n = 0; n < steps; ++n) {
+        lorenz(0, y, k1);
+        for (int i = 0; i < 3; ++i) tmp[i] = y[i] + 0.5 * dt * k1[i];
+        lorenz(0, tmp, k2);
+        for (int i = 0; i < 3; ++i) tmp[i] = y[i] + 0.5 * dt * k2[i];
+        lorenz(0, tmp, k3);
+        for (int i = 0; i < 3; ++i) tmp[i] = y[i] + dt * k3[i];
+        lorenz(0, tmp, k4);
+        for (int i = 0; i < 3; ++i) y[i] += dt / 6.0 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+        points.push_back(Point2({ y[0], y[1] }));
+    }
+    return points;
+}
+
+TEST(ContourSamplerTests, CirclesBecomeArcs) {
+    SamplerOptions options;
+    options.tolerance = 1E-4;
+    auto circle = [](double t) { return Point2({ 3 + 2 * std::cos(t), -1 + 2 * std::sin(t) }); };
+    Contour contour = sampleCurve(circle, 0.0, 2 * PI, options);
+    ASSERT_GT(contour.getElements().size(), 0);
+    EXPECT_LE(contour.getElements().size(), 2);
+    EXPECT_TRUE(contour.isValid());
+    for (const auto& element : contour.getElements()) {
+        ASSERT_TRUE(std::holds_alternative<Arc>(element));
+        EXPECT_NEAR(std::get<Arc>(element).getRadius(), 2.0, options.tolerance);
+    }
+
+    // Without arcs the same circle needs chords, and more of them for a tighter tolerance
+    options.fit_arcs = false;
+    Contour chords = sampleCurve(circle, 0.0, 2 * PI, options);
+    EXPECT_TRUE(chords.isValid());
+    EXPECT_GT(chords.getElements().size(), 50);
+    ContourDistanceIndex index(chords);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_LE(index.closestPoint(circle(2 * PI * i / 1000)).distance, options.tolerance);
+    }
+    options.tolerance = 1E-2;
+    EXPECT_LT(sampleCurve(circle, 0.0, 2 * PI, options).getElements().size(), chords.getElements().size() / 5);
+
+    // A straight parametric line is a single Line2 whatever the initial spans
+    Contour line = sampleCurve([](double t) { return Point2({ t, 2 * t + 1 }); }, -1.0, 4.0, options);
+    ASSERT_EQ(line.getElements().size(), 1);
+    EXPECT_TRUE(std::holds_alternative<Line2>(line.getElements()[0]));
+}
+
+TEST(ContourSamplerTests, LorenzTrajectoryWithinTolerance) {
+    SamplerOptions options;
+    options.tolerance = 1E-2;
+    const double t1 = 2.0;
+    Contour contour = sampleOde(lorenz, { 1.0, 1.0, 1.0 }, 0.0, t1, options);
+    EXPECT_TRUE(contour.isValid());
+
+    // Every point of an accurate reference lies close to the sampled contour
+    const std::vector<Point2> reference = lorenzReference({ 1.0, 1.0, 1.0 }, t1, 1E-4);
+    ContourDistanceIndex index(contour);
+    for (size_t i = 0; i < reference.size(); i += 10) {
+        EXPECT_LE(index.closestPoint(reference[i]).distance, options.tolerance) << i;
+    }
+    const Point2 end = asSegment(contour.getElements().back()).endPoint();
+    EXPECT_NEAR(end.x, reference.back().x, options.tolerance);
+    EXPECT_NEAR(end.y, reference.back().y, options.tolerance);
+
+    // Fewer elements than the 200 Line2s of fixed step Euler at dt = 0.01, which strays much further,
+    // and Arcs replace most of the Line2s a chord only fit needs
+    EXPECT_LT(contour.getElements().size(), 150);
+    options.fit_arcs = false;
+    const size_t lines = sampleOde(lorenz, { 1.0, 1.0, 1.0 }, 0.0, t1, options).getElements().size();
+    EXPECT_LT(contour.getElements().size(), lines * 6 / 10);
+    bool has_arc = false;
+    for (const auto& element : contour.getElements()) {
+        has_arc = has_arc || std::holds_alternative<Arc>(element);
+    }
+    EXPECT_TRUE(has_arc);
+}
+
+TEST(ContourSamplerTests, ParallelTrajectoriesMatchSerial) {
+    SamplerOptions options;
+    options.tolerance = 1E-2;
+    options.num_threads = 4;
+    std::vector<OdeState> initial;
+    for (int i = 0; i < 8; ++i) {
+        initial.push_back({ 1.0 + 0.1 * i, 1.0, 1.0 + 0.5 * i });
+    }
+    // Projection onto the x-z plane
+    auto xz = [](const OdeState& y) { return Point2({ y[0], y[2] }); };
+    std::vector<Contour> contours = sampleOdes(lorenz, initial, 0.0, 1.0, options, xz);
+    ASSERT_EQ(contours.size(), initial.size());
+    for (size_t i = 0; i < initial.size(); ++i) {
+        EXPECT_TRUE(contours[i] == sampleOde(lorenz, initial[i], 0.0, 1.0, options, xz)) << i;
+        EXPECT_TRUE(contours[i].isValid()) << i;
+    }
+
+    EXPECT_THROW(sampleOde(lorenz, { 1.0, 1.0, 1.0 }, 1.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(sampleOde([](double, const OdeState&, OdeState& d) { d[0] = 1; }, { 1.0 }, 0.0, 1.0), std::invalid_argument);
+    options.tolerance = 0.0;
+    EXPECT_THROW(sampleCurve([](double t) { return Point2({ t, t }); }, 0.0, 1.0, options), std::invalid_argument);
+}
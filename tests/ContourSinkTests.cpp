@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourSink.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+#include <sstream>
+
+// Records what reaches the end of a pipeline
+class RecordingSink : public ContourSink {
+public:
+    void push(const ContourElement& element) override { elements.push_back(element); }
+    void finish() override { ++finished; }
+
+    std::vector<ContourElement> elements;
+    int finished = 0;
+};
+
+TEST(ContourSinkTests, PointSinkBuildsConnectedLines) {
+    Contour contour;
+    ContourCollectorSink collector(contour);
+    PointSink points(collector);
+
+    points.push(Point2{ 0, 0 });
+    points.push(Point2{ 1, 0 });
+    points.push(Point2{ 1, 0 }); // duplicate is skipped
+    points.push(Point2{ 1, 1 });
+    points.finish();
+
+    EXPECT_EQ(contour.getElements().size(), 2);
+    EXPECT_TRUE(contour.isValid());
+}
+
+TEST(ContourSinkTests, ValidatingSinkCountsGaps) {
+    RecordingSink record;
+    ValidatingSink validate(record);
+
+    validate.push(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    validate.push(Line2(Point2({ 1, 0 }), Point2({ 1, 1 })));
+    validate.push(Line2(Point2({ 5, 5 }), Point2({ 6, 6 })));
+    validate.finish();
+
+    EXPECT_EQ(validate.elementCount(), 3);
+    EXPECT_EQ(validate.gapCount(), 1);
+    EXPECT_EQ(record.elements.size(), 3);
+    EXPECT_EQ(record.finished, 1);
+
+    ValidatingSink strict(record, EPS, true);
+    strict.push(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    EXPECT_THROW(strict.push(Line2(Point2({ 2, 0 }), Point2({ 3, 0 }))), std::runtime_error);
+}
+
+TEST(ContourSinkTests, SimplifyingSinkMergesCollinearRuns) {
+    RecordingSink record;
+    SimplifyingSink simplify(record, 1e-6);
+    PointSink points(simplify);
+
+    for (int i = 0; i <= 10; ++i)
+        points.push(Point2{ static_cast<double>(i), 0 });
+    for (int i = 1; i <= 10; ++i)
+        points.push(Point2{ 10, static_cast<double>(i) });
+    simplify.push(Arc(Point2({ 9, 10 }), 1, 0, PI));
+    points.finish();
+
+    ASSERT_EQ(record.elements.size(), 3);
+    EXPECT_EQ(std::get<Line2>(record.elements[0]), Line2(Point2({ 0, 0 }), Point2({ 10, 0 })));
+    EXPECT_EQ(std::get<Line2>(record.elements[1]), Line2(Point2({ 10, 0 }), Point2({ 10, 10 })));
+    EXPECT_TRUE(std::holds_alternative<Arc>(record.elements[2]));
+    EXPECT_EQ(simplify.inputCount(), 21);
+    EXPECT_EQ(simplify.outputCount(), 3);
+}
+
+TEST(ContourSinkTests, SimplifyingSinkKeepsShapeWithinTolerance) {
+    RecordingSink record;
+    SimplifyingSink simplify(record, 0.01);
+    PointSink points(simplify);
+
+    for (int i = 0; i <= 1000; ++i) {
+        double a = PI * i / 1000;
+        points.push(Point2{ std::cos(a), std::sin(a) });
+    }
+    points.finish();
+
+    EXPECT_LT(record.elements.size(), 100);
+    EXPECT_GT(record.elements.size(), 5);
+    // Every merged line stays close to the unit circle in its middle
+    for (const auto& e : record.elements) {
+        Point2 mid = std::get<Line2>(e).getCoordinate(0.5);
+        EXPECT_GT(std::hypot(mid.x, mid.y), 1 - 0.011);
+    }
+}
+
+TEST(ContourSinkTests, BinaryRoundTrip) {
+    std::stringstream buffer;
+    BinarySink binary(buffer);
+    binary.push(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    binary.push(Arc(Point2({ 1, 1 }), 1, -0.5 * PI, 0.5 * PI, 30, false));
+    binary.finish();
+
+    Contour contour;
+    ContourCollectorSink collector(contour);
+    EXPECT_EQ(readBinaryStream(buffer, collector), 2);
+
+    auto elements = contour.getElements();
+    ASSERT_EQ(elements.size(), 2);
+    EXPECT_EQ(std::get<Line2>(elements[0]), Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    EXPECT_EQ(std::get<Arc>(elements[1]), Arc(Point2({ 1, 1 }), 1, -0.5 * PI, 0.5 * PI, 30, false));
+    EXPECT_EQ(std::get<Arc>(elements[1]).getResolution(), 30);
+}
+
+TEST(ContourSinkTests, ThreadedPipelineKeepsOrder) {
+    Contour contour;
+    ContourCollectorSink collector(contour);
+    ThreadedSink second(collector, 2, 16);
+    ValidatingSink validate(second);
+    ThreadedSink first(validate, 2, 7);
+    PointSink points(first);
+
+    const int n = 5000;
+    for (int i = 0; i <= n; ++i)
+        points.push(Point2{ static_cast<double>(i), static_cast<double>(i % 2) });
+    points.finish();
+
+    EXPECT_EQ(validate.gapCount(), 0);
+    EXPECT_EQ(contour.getElements().size(), n);
+    EXPECT_TRUE(contour.isValid());
+}
+
+TEST(ContourSinkTests, ThreadedSinkRethrowsDownstreamErrors) {
+    RecordingSink record;
+    ValidatingSink strict(record, EPS, true);
+    ThreadedSink stage(strict, 1, 1);
+
+    stage.push(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    stage.push(Line2(Point2({ 3, 0 }), Point2({ 4, 0 })));
+    EXPECT_THROW(stage.finish(), std::runtime_error);
+}
@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourStats.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+#include <thread>
+
+TEST(ContourStatsTests, JSONListsAllCounters) {
+    std::string json = contourStatisticsToJSON();
+
+    EXPECT_NE(json.find("\"enabled\""), std::string::npos);
+    for (size_t i = 0; i < static_cast<size_t>(ContourStat::Count); ++i) {
+        std::string key = std::string("\"") + contourStatName(static_cast<ContourStat>(i)) + "\"";
+        EXPECT_NE(json.find(key), std::string::npos) << key << " is missing from " << json;
+    }
+}
+
+TEST(ContourStatsTests, CountsHotPaths) {
+    if (!contourStatisticsEnabled()) {
+        GTEST_SKIP() << "Built without CONTOUR_INSTRUMENTATION";
+    }
+    resetContourStatistics();
+
+    Contour contour;
+    contour.addItem(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    contour.addItem(Arc(Point2({ 1, 1 }), 1, -0.5 * PI, 0.0, 10));
+
+    EXPECT_TRUE(contour.isValid());  // recompute
+    EXPECT_TRUE(contour.isValid());  // cache hit
+    auto elements = contour.getElements();
+    auto strip = contour.getLineStrip();
+
+    ContourStatistics stats = getContourStatistics();
+    EXPECT_EQ(stats[ContourStat::ValidityRecomputes], 1);
+    EXPECT_EQ(stats[ContourStat::ValidityCacheHits], 1);
+    EXPECT_EQ(stats[ContourStat::ElementVectorCopies], 1);
+    EXPECT_EQ(stats[ContourStat::ElementsCopied], 2);
+    EXPECT_EQ(stats[ContourStat::TessellationCalls], 1);
+    EXPECT_EQ(stats[ContourStat::TessellatedPoints], strip.size());
+    EXPECT_GE(stats[ContourStat::ExclusiveLocks], 3);
+}
+
+TEST(ContourStatsTests, ExitedThreadsAreKeptUntilReset) {
+    if (!contourStatisticsEnabled()) {
+        GTEST_SKIP() << "Built without CONTOUR_INSTRUMENTATION";
+    }
+    resetContourStatistics();
+
+    Contour contour = contourFromPoints({ Point2{0, 0}, Point2{1, 0}, Point2{1, 1} });
+    std::thread worker([&]() { contour.getElements(); });
+    worker.join();
+    EXPECT_EQ(getContourStatistics()[ContourStat::ElementVectorCopies], 1);
+
+    resetContourStatistics();
+    EXPECT_EQ(getContourStatistics()[ContourStat::ElementVectorCopies], 0);
+}
@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourStore.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+// Mixed contours, every fifth one has a gap
+static std::vector<Contour> randomContours(size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(-50, 50);
+    std::vector<Contour> contours(count);
+    for (size_t c = 0; c < count; ++c) {
+        Point2 p{ u(rng), u(rng) };
+        const size_t n = 1 + rng() % 8;
+        for (size_t i = 0; i < n; ++i) {
+            if (rng() % 3 == 0) {
+                const double a = u(rng) / 10;
+                Arc arc(Point2({ p.x - std::cos(a), p.y - std::sin(a) }), 1.0, a, a + 1.0, 8, true);
+                contours[c].addItem(arc);
+                p = arc.getCoordinate(1.0);
+            } else {
+                Point2 q{ p.x + 1 + u(rng) / 100, p.y + u(rng) / 10 };
+                contours[c].addItem(Line2(p, q));
+                p = q;
+            }
+            if (c % 5 == 0 && i == 0) {
+                p.x += 0.5;
+            }
+        }
+    }
+    return contours;
+}
+
+static BoundingBox elementBounds(const Contour& contour)
+{
+    BoundingBox box;
+    for (const auto& e : contour.getElements()) {
+        box.expand(std::visit([](const auto& seg) { return seg.getBounds(); }, e));
+    }
+    return box;
+}
+
+TEST(ContourStoreTests, RoundTrip) {
+    Contour contour;
+    contour.addItem(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    contour.addItem(Arc(Point2({ 1, 1 }), 1, -0.5 * PI, 0.0, 10));
+    contour.addItem(CubicBezier(Point2({ 2, 1 }), Point2({ 2, 2 }), Point2({ 1, 2 }), Point2({ 0, 2 })));
+    contour.addItem(Arc(Point2({ 0, 1 }), 1, 1.5 * PI, 0.5 * PI, 12, false));
+
+    ContourStore store(4);
+    ContourHandle handle = store.add(contour);
+    EXPECT_TRUE(store.contains(handle));
+    EXPECT_EQ(store.size(), 1);
+    EXPECT_EQ(store.segmentCount(handle), 4);
+    EXPECT_TRUE(store.get(handle) == contour);
+    EXPECT_EQ(store.isValid(handle), contour.isValid());
+
+    BoundingBox a = store.bounds(handle);
+    BoundingBox b = elementBounds(contour);
+    EXPECT_TRUE(a.min.isCloseTo(b.min, 1E-12));
+    EXPECT_TRUE(a.max.isCloseTo(b.max, 1E-12));
+
+    store.replace(handle, contourFromPoints({ {0, 0}, {1, 0}, {5, 5} }).getElements());
+    EXPECT_EQ(store.segmentCount(handle), 2);
+    EXPECT_TRUE(std::holds_alternative<Line2>(store.elements(handle)[1]));
+}
+
+TEST(ContourStoreTests, HandlesStayStableAcrossRemoveAndCompact) {
+    auto contours = randomContours(3000, 3);
+    ContourStore store(8);
+    std::vector<ContourHandle> handles;
+    for (const auto& c : contours) {
+        handles.push_back(store.add(c));
+    }
+    const size_t full = store.memoryUsage();
+
+    for (size_t i = 0; i < handles.size(); i += 2) {
+        store.remove(handles[i]);
+    }
+    store.compact();
+    EXPECT_EQ(store.size(), 1500);
+    EXPECT_LT(store.memoryUsage(), full);
+    EXPECT_EQ(store.handles().size(), 1500);
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (i % 2 == 0) {
+            EXPECT_FALSE(store.contains(handles[i]));
+            EXPECT_THROW(store.elements(handles[i]), std::out_of_range);
+        } else {
+            ASSERT_TRUE(store.get(handles[i]) == contours[i]) << i;
+        }
+    }
+    EXPECT_THROW(store.remove(handles[0]), std::out_of_range);
+
+    // New contours never take over old handles
+    ContourHandle fresh = store.add(contours[0]);
+    EXPECT_EQ(std::find(handles.begin(), handles.end(), fresh), handles.end());
+}
+
+TEST(ContourStoreTests, BulkOperationsMatchContours) {
+    auto contours = randomContours(20000, 9);
+    ContourStore store;
+    std::vector<ContourHandle> handles = store.addBatch(contours, 4);
+    ASSERT_EQ(handles.size(), contours.size());
+    EXPECT_EQ(store.size(), contours.size());
+
+    auto valid = store.validate(handles, 4);
+    auto boxes = store.bounds(handles, 4);
+    auto copies = store.toContours(handles, 4);
+    size_t invalid = 0;
+    for (size_t i = 0; i < contours.size(); ++i) {
+        ASSERT_EQ(valid[i] != 0, contours[i].isValid()) << i;
+        invalid += valid[i] ? 0 : 1;
+        BoundingBox expected = elementBounds(contours[i]);
+        ASSERT_TRUE(boxes[i].min.isCloseTo(expected.min, 1E-12)) << i;
+        ASSERT_TRUE(boxes[i].max.isCloseTo(expected.max, 1E-12)) << i;
+        ASSERT_TRUE(copies[i] == contours[i]) << i;
+    }
+    EXPECT_GT(invalid, 0);
+
+    // Structure of arrays beats a ContourElement per segment
+    size_t segments = 0;
+    for (const auto& c : contours) {
+        segments += c.getElements().size();
+    }
+    EXPECT_LT(store.memoryUsage(), segments * sizeof(ContourElement));
+}
+
+TEST(ContourStoreTests, ConcurrentWriters) {
+    auto contours = randomContours(400, 5);
+    ContourStore store(16);
+    std::vector<std::thread> writers;
+    std::vector<std::vector<ContourHandle>> kept(4);
+    for (size_t t = 0; t < 4; ++t) {
+        writers.emplace_back([&, t]() {
+            for (size_t i = 0; i < contours.size(); ++i) {
+                ContourHandle h = store.add(contours[i]);
+                if (i % 4 == t) {
+                    store.remove(h);
+                } else {
+                    kept[t].push_back(h);
+                    store.isValid(h);
+                }
+            }
+        });
+    }
+    for (auto& w : writers) {
+        w.join();
+    }
+    EXPECT_EQ(store.size(), 4 * 300);
+    for (size_t t = 0; t < 4; ++t) {
+        for (ContourHandle h : kept[t]) {
+            EXPECT_TRUE(store.contains(h));
+        }
+    }
+}
+
+TEST(ContourStoreTests, ExportToSVG) {
+    ContourStore store;
+    std::vector<ContourHandle> handles = store.addBatch(randomContours(50, 1));
+    const std::string filename = "contour_store_test.svg";
+    store.exportToSVG(filename, handles, 2);
+
+    std::ifstream file(filename);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string svg = buffer.str();
+    size_t paths = 0;
+    for (size_t at = svg.find("<path"); at != std::string::npos; at = svg.find("<path", at + 1)) {
+        ++paths;
+    }
+    EXPECT_EQ(paths, 50);
+    EXPECT_NE(svg.find("</svg>"), std::string::npos);
+}
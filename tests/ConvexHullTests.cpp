@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ConvexHull.h"
+#include "ContourDistance.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <algorithm>
+#include <random>
+
+// Every sample of every element lies inside the hull or on it
+static void expectEncloses(const Contour& hull, const std::vector<ContourElement>& elements)
+{
+    ASSERT_TRUE(hull.isValid());
+    ASSERT_TRUE(hull.isClosed());
+    ContourDistanceIndex index(hull);
+    for (const auto& e : elements) {
+        for (double t = 0; t <= 1.0; t += 0.125) {
+            Point2 p = std::visit([&](const auto& seg) { return seg.getCoordinate(t); }, e);
+            EXPECT_LT(index.closestPoint(p).signed_distance, 1E-9);
+        }
+    }
+}
+
+TEST(ConvexHullTests, PointSet) {
+    std::vector<Point2> points = { {0, 0}, {2, 0}, {1, 1}, {2, 2}, {0, 2}, {1, 0}, {0.5, 1.5} };
+    Contour hull = convexHull(points);
+
+    auto elements = hull.getElements();
+    ASSERT_EQ(elements.size(), 4); // the collinear (1, 0) is dropped
+    EXPECT_TRUE(hull.isClosed());
+    for (const auto& e : elements) {
+        EXPECT_TRUE(std::holds_alternative<Line2>(e));
+    }
+    EXPECT_TRUE(convexHull(std::vector<Point2>{ {3, 3} }).getElements().empty());
+}
+
+TEST(ConvexHullTests, KeepsArcsOnTheHull) {
+    // Stadium with a dent: the dent is bridged, the round ends stay arcs
+    Contour stadium;
+    stadium.addItem(Line2(Point2({ 0, 0 }), Point2({ 4, 0 })));
+    stadium.addItem(Arc(Point2({ 4, 1 }), 1.0, -PI / 2, PI / 2));
+    stadium.addItem(Line2(Point2({ 4, 2 }), Point2({ 3, 2 })));
+    stadium.addItem(Arc(Point2({ 2, 2 }), 1.0, 0.0, -PI, 20, false)); // dent, clockwise
+    stadium.addItem(Line2(Point2({ 1, 2 }), Point2({ 0, 2 })));
+    stadium.addItem(Arc(Point2({ 0, 1 }), 1.0, PI / 2, 3 * PI / 2));
+
+    Contour hull = convexHull(stadium);
+    auto elements = hull.getElements();
+    ASSERT_EQ(elements.size(), 4);
+    size_t arcs = 0;
+    for (const auto& e : elements) {
+        if (const Arc* arc = std::get_if<Arc>(&e)) {
+            ++arcs;
+            EXPECT_NEAR(arc->getEndAngle() - arc->getStartAngle(), PI, 1E-12);
+            EXPECT_NEAR(arc->getRadius(), 1.0, 0.0);
+        }
+    }
+    EXPECT_EQ(arcs, 2);
+    expectEncloses(hull, stadium.getElements());
+}
+
+TEST(ConvexHullTests, PartialArcsAndCircles) {
+    // A circle sticking out of a square keeps only the part outside
+    std::vector<ContourElement> elements = contourFromPoints({ {-1, -1}, {1, -1}, {1, 1}, {-1, 1}, {-1, -1} }).getElements();
+    elements.push_back(Arc(Point2({ 1, 0 }), 0.5, 0.0, 2 * PI));
+
+    Contour hull = convexHull(elements);
+    auto hull_elements = hull.getElements();
+    const Arc* arc = nullptr;
+    for (const auto& e : hull_elements) {
+        if (std::holds_alternative<Arc>(e)) {
+            ASSERT_EQ(arc, nullptr);
+            arc = &std::get<Arc>(e);
+        }
+    }
+    ASSERT_NE(arc, nullptr);
+    // Tangents from the corners (1, +-1) touch the circle 30 degrees above and below the x axis
+    EXPECT_NEAR(arc->getEndAngle() - arc->getStartAngle(), PI / 3, 1E-9);
+    expectEncloses(hull, elements);
+}
+
+TEST(ConvexHullTests, RandomSoupSerialAndParallel) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> u(-100, 100);
+    std::uniform_real_distribution<double> angle(-PI, PI);
+    std::vector<ContourElement> elements;
+    for (int i = 0; i < 40000; ++i) {
+        Point2 p{ u(rng), u(rng) };
+        if (i % 3 == 0) {
+            double a = angle(rng);
+            elements.push_back(Arc(p, 1 + std::fabs(u(rng)) / 5, a, a + angle(rng) * 2));
+        } else {
+            elements.push_back(Line2(p, Point2({ p.x + u(rng) / 10, p.y + u(rng) / 10 })));
+        }
+    }
+
+    HullOptions serial;
+    serial.num_threads = 1;
+    HullOptions parallel;
+    parallel.num_threads = 4;
+    Contour a = convexHull(elements, serial);
+    Contour b = convexHull(elements, parallel);
+
+    expectEncloses(a, elements);
+    auto ea = a.getElements();
+    auto eb = b.getElements();
+    EXPECT_GT(std::count_if(ea.begin(), ea.end(), [](const ContourElement& e) { return std::holds_alternative<Arc>(e); }), 0);
+    ASSERT_EQ(ea.size(), eb.size());
+    for (size_t i = 0; i < ea.size(); ++i) {
+        Point2 pa = std::visit([](const auto& seg) { return seg.getCoordinate(0.0); }, ea[i]);
+        Point2 pb = std::visit([](const auto& seg) { return seg.getCoordinate(0.0); }, eb[i]);
+        EXPECT_TRUE(pa.isCloseTo(pb, 1E-9));
+    }
+}
+
+TEST(ConvexHullTests, Batch) {
+    std::vector<Contour> contours;
+    for (int i = 1; i <= 10; ++i) {
+        Contour c;
+        c.addItem(Arc(Point2({ 0, 0 }), i, 0.0, PI));
+        c.addItem(Line2(Point2({ -1.0 * i, 0 }), Point2({ 0, -1.0 * i })));
+        c.addItem(Line2(Point2({ 0, -1.0 * i }), Point2({ 1.0 * i, 0 })));
+        contours.push_back(c);
+    }
+    auto hulls = convexHullBatch(contours);
+    ASSERT_EQ(hulls.size(), contours.size());
+    for (size_t i = 0; i < hulls.size(); ++i) {
+        EXPECT_EQ(hulls[i].getElements().size(), 3);
+        expectEncloses(hulls[i], contours[i].getElements());
+    }
+}
@@ -0,0 +1,115 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "GCodeExport.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+static std::string toGCode(const std::vector<ContourElement>& elements, const GCodeOptions& options = GCodeOptions())
+{
+    std::ostringstream out;
+    GCodeSink sink(out, options);
+    for (const auto& e : elements) {
+        sink.push(e);
+    }
+    sink.finish();
+    return out.str();
+}
+
+TEST(GCodeExportTests, LinesAndArcs) {
+    // Rounded corner: counter clockwise quarter arc between two lines
+    std::vector<ContourElement> elements = {
+        Line2(Point2({ 0, 0 }), Point2({ 2, 0 })),
+        Arc(Point2({ 2, 1 }), 1, -0.5 * PI, 0.0, 20),
+        Line2(Point2({ 3, 1 }), Point2({ 3, 2.5 })),
+    };
+    GCodeOptions options;
+    options.feed_rate = 600;
+    EXPECT_EQ(toGCode(elements, options),
+        "G90 G17\n"
+        "G0 X0 Y0\n"
+        "G1 X2 Y0 F600\n"
+        "G3 X3 Y1 I0 J1\n"
+        "G1 X3 Y2.5\n"
+        "M2\n");
+}
+
+TEST(GCodeExportTests, ArcDirectionFollowsTraversal) {
+    // The order of the angles sets the direction: a falling sweep is clockwise, a rising one counter clockwise
+    // even with forwards unset, which does not change the traversal of an Arc
+    Arc falling(Point2({ 0, 0 }), 2, 0.5 * PI, 0.0, 20);
+    Arc rising(Point2({ 0, 0 }), 2, 0.0, 0.5 * PI, 20, false);
+    const std::pair<const Arc*, const char*> cases[] = {
+        { &falling, "G0 X0 Y2\nG2 X2 Y0 I0 J-2\n" },
+        { &rising, "G0 X2 Y0\nG3 X0 Y2 I-2 J0\n" },
+    };
+    for (const auto& [arc, moves] : cases) {
+        EXPECT_EQ(toGCode({ *arc }), std::string("G90 G17\n") + moves + "M2\n");
+    }
+    // The program ends where getCoordinate(1) is
+    EXPECT_TRUE(rising.getCoordinate(1.0).isCloseTo(Point2({ 0, 2 }), 1E-12));
+
+    // Zero sweep arcs have no motion, a full turn comes back to its start
+    std::string full = toGCode({ Arc(Point2({ 1, 1 }), 1, 0.0, 2 * PI) });
+    EXPECT_NE(full.find("G3 X2 Y1 I-1 J0\n"), std::string::npos);
+    GCodeOptions bare;
+    bare.program = false;
+    EXPECT_EQ(toGCode({ Arc(Point2({ 1, 1 }), 1, 0.5, 0.5) }, bare), "");
+}
+
+TEST(GCodeExportTests, GapsAreRapidMoves) {
+    std::vector<ContourElement> elements = {
+        Line2(Point2({ 0, 0 }), Point2({ 1.23456, 0 })),
+        Line2(Point2({ 5, 5 }), Point2({ 5, -1E-9 })),
+        CubicBezier(Point2({ 5, -1E-9 }), Point2({ 6, 1 }), Point2({ 7, 1 }), Point2({ 8, 0 })),
+    };
+    GCodeOptions options;
+    options.use_z = true;
+    options.safe_z = 2;
+    options.cut_z = -0.5;
+    options.precision = 3;
+    std::string code = toGCode(elements, options);
+    EXPECT_EQ(code.substr(0, code.find("G0 X5")),
+        "G90 G17\n"
+        "G0 Z2\n"
+        "G0 X0 Y0\n"
+        "G1 Z-0.5\n"
+        "G1 X1.235 Y0\n"
+        "G0 Z2\n");
+    // Rounded to -0, written as 0
+    EXPECT_NE(code.find("G1 X5 Y0\n"), std::string::npos);
+    EXPECT_EQ(code.find("G2"), std::string::npos);
+    EXPECT_EQ(code.find("G0 X8"), std::string::npos);
+    EXPECT_EQ(code.substr(code.size() - 9), "G0 Z2\nM2\n");
+}
+
+TEST(GCodeExportTests, BatchWritesOneFilePerContour) {
+    std::vector<Contour> contours(12);
+    std::vector<std::string> filenames;
+    for (size_t i = 0; i < contours.size(); ++i) {
+        const double r = 1.0 + i;
+        contours[i].addItem(Line2(Point2({ 0, 0 }), Point2({ r, 0 })));
+        contours[i].addItem(Arc(Point2({ 0, 0 }), r, 0.0, 0.5 * PI));
+        contours[i].addItem(Line2(Point2({ 0, r }), Point2({ 0, 0 })));
+        filenames.push_back("gcode_export_test_" + std::to_string(i) + ".nc");
+    }
+    GCodeOptions options;
+    options.num_threads = 4;
+    options.buffer_size = 16; // raised to the smallest buffer, several writes per file
+    exportContoursToGCode(contours, filenames, options);
+    for (size_t i = 0; i < contours.size(); ++i) {
+        std::ifstream file(filenames[i]);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        file.close();
+        std::remove(filenames[i].c_str());
+        EXPECT_EQ(buffer.str(), toGCode(contours[i].getElements())) << i;
+    }
+    EXPECT_THROW(exportContoursToGCode(contours, { "one.nc" }), std::invalid_argument);
+}
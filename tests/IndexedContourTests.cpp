@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "IndexedContour.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <cmath>
+#include <random>
+
+static std::vector<Point2> randomWalk(size_t count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(-1, 1);
+    std::vector<Point2> points{ { 0.0, 0.0 } };
+    for (size_t i = 1; i < count; ++i) {
+        points.push_back(Point2({ points.back().x + 0.5 + u(rng), points.back().y + u(rng) }));
+    }
+    return points;
+}
+
+TEST(IndexedContourTests, PolylineSharesVertices) {
+    auto points = randomWalk(10000, 3);
+    IndexedContour indexed(points);
+    EXPECT_EQ(indexed.size(), points.size() - 1);
+    EXPECT_EQ(indexed.vertices().size(), points.size());
+    EXPECT_FALSE(indexed.isClosed());
+
+    Contour contour = contourFromPoints(points);
+    EXPECT_TRUE(indexed.toContour() == contour);
+    EXPECT_TRUE(indexed.toContour().isValid());
+    EXPECT_EQ(indexed.getLineStrip().size(), points.size());
+
+    // One point and a 4 byte record per Line2 instead of a ContourElement holding both end points
+    EXPECT_LE(indexed.memoryUsage(), points.size() * (sizeof(Point2) + sizeof(uint32_t)));
+    EXPECT_LT(indexed.memoryUsage(), (points.size() - 1) * 2 * sizeof(Point2));
+
+    // Duplicate points are skipped, a repeated first point is shared when closing
+    IndexedContour square({ {0, 0}, {1, 0}, {1, 0}, {1, 1}, {0, 1}, {0, 0} }, true);
+    EXPECT_TRUE(square.isClosed());
+    EXPECT_EQ(square.size(), 4);
+    EXPECT_EQ(square.vertices().size(), 4);
+    EXPECT_TRUE(square.toContour().isClosed());
+    EXPECT_TRUE(square.toContour().isValid());
+}
+
+TEST(IndexedContourTests, ConvertsMixedContours) {
+    // Rounded rectangle, the arc end points only meet the lines up to rounding
+    Contour contour;
+    contour.addItem(Line2(Point2({ 0, 0 }), Point2({ 3, 0 })));
+    contour.addItem(Arc(Point2({ 3, 1 }), 1, -0.5 * PI, 0.0, 10));
+    contour.addItem(Line2(Point2({ 4, 1 }), Point2({ 4, 3 })));
+    contour.addItem(Arc(Point2({ 3, 3 }), 1, 0.0, 0.5 * PI, 10));
+    contour.addItem(Line2(Point2({ 3, 4 }), Point2({ 0, 4 }), false).reversed());
+    contour.addItem(Line2(Point2({ 0, 4 }), Point2({ 0, 0 })));
+
+    IndexedContour indexed(contour);
+    EXPECT_TRUE(indexed.isClosed());
+    EXPECT_EQ(indexed.size(), 6);
+    EXPECT_EQ(indexed.vertices().size(), 6);
+    Contour back = indexed.toContour();
+    EXPECT_TRUE(back == contour);
+    EXPECT_TRUE(back.isValid());
+    EXPECT_TRUE(back.isClosed());
+
+    // Lines end exactly on the cached end points of the arcs
+    auto elements = back.getElements();
+    for (size_t i = 0; i < elements.size(); ++i) {
+        const Point2& end = asSegment(elements[i]).endPoint();
+        const Point2& start = asSegment(elements[(i + 1) % elements.size()]).startPoint();
+        EXPECT_EQ(end.x, start.x) << i;
+        EXPECT_EQ(end.y, start.y) << i;
+    }
+
+    BoundingBox box = indexed.getBounds();
+    EXPECT_TRUE(box.max.isCloseTo(Point2({ 4, 4 }), 1E-12));
+
+    // A full circle closes on its own
+    IndexedContour circle(std::vector<ContourElement>{ Arc(Point2({ 0, 0 }), 1, 0.0, 2 * PI) });
+    EXPECT_TRUE(circle.isClosed());
+    EXPECT_EQ(circle.vertices().size(), 1);
+}
+
+TEST(IndexedContourTests, RejectsOpenJoints) {
+    std::vector<ContourElement> gap = {
+        Line2(Point2({ 0, 0 }), Point2({ 1, 0 })),
+        Line2(Point2({ 1, 1E-3 }), Point2({ 2, 0 })),
+    };
+    EXPECT_THROW(IndexedContour{ gap }, std::invalid_argument);
+    IndexedContour snapped(gap, 1E-2);
+    EXPECT_TRUE(snapped.toContour().isValid());
+
+    IndexedContour open({ {0, 0}, {1, 0}, {1, 1} });
+    EXPECT_THROW(open.element(2), std::out_of_range);
+    open.close();
+    EXPECT_EQ(open.size(), 3);
+    EXPECT_TRUE(open.toContour().isClosed());
+    EXPECT_THROW(open.addPoint(Point2({ 5, 5 })), std::invalid_argument);
+}
+
+TEST(IndexedContourTests, CurveJointsMeetWithinEps) {
+    // Two curves keep their own end points, a gap the tolerance would accept is not closed
+    Arc upper(Point2({ 0, 0 }), 1, 0.0, PI);
+    Arc lower(Point2({ 1E-7, 0 }), 1, PI, 2 * PI);
+    IndexedContour chain;
+    chain.addElement(upper, 1E-6);
+    EXPECT_THROW(chain.addElement(lower, 1E-6), std::invalid_argument);
+    EXPECT_THROW(IndexedContour({ upper, lower }, 1E-6), std::invalid_argument);
+
+    // Closing two curves 1E-7 apart bridges them with a Line2 instead of sharing the joint
+    Arc touching(Point2({ 0, 0 }), 1, PI, 2 * PI - 1E-7);
+    IndexedContour ring({ upper, touching }, 1E-6);
+    EXPECT_TRUE(ring.isClosed());
+    EXPECT_EQ(ring.size(), 3);
+    EXPECT_TRUE(std::holds_alternative<Line2>(ring.element(2)));
+    EXPECT_TRUE(ring.toContour().isValid());
+    EXPECT_TRUE(ring.toContour().isClosed());
+}
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "JointValidity.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+TEST(JointValidityTests, FindsTheFirstOpenJoint) {
+    const size_t n = 1000;
+    std::vector<double> ex(n), ey(n), sx(n), sy(n);
+    for (size_t i = 0; i < n; ++i) {
+        ex[i] = sx[i] = 0.5 * i;
+        ey[i] = sy[i] = -0.25 * i;
+    }
+    EXPECT_EQ(firstOpenJoint(ex.data(), ey.data(), sx.data(), sy.data(), n), n);
+    EXPECT_EQ(firstOpenJoint(ex.data(), ey.data(), sx.data(), sy.data(), 0), 0);
+
+    sx[700] += 1E-3;
+    sy[900] = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_EQ(firstOpenJoint(ex.data(), ey.data(), sx.data(), sy.data(), n), 700);
+    EXPECT_EQ(firstOpenJoint(ex.data(), ey.data(), sx.data(), sy.data(), n, 1E-2), 900);
+    // Same rule as isCloseTo, a gap of exactly the tolerance is open
+    EXPECT_EQ(firstOpenJoint(ex.data() + 700, ey.data() + 700, sx.data() + 700, sy.data() + 700, 1, 1E-3),
+        Point2({ sx[700], sy[700] }).isCloseTo(Point2({ ex[700], ey[700] }), 1E-3) ? 1 : 0);
+}
+
+TEST(JointValidityTests, SegmentsCacheTheirEndPoints) {
+    std::vector<ContourElement> elements = {
+        Line2(Point2({ 0, 0 }), Point2({ 1, 2 }), false),
+        Arc(Point2({ 1, 1 }), 2, 0.3, 2.9, 20, false),
+        CubicBezier(Point2({ 0, 0 }), Point2({ 1, 3 }), Point2({ 2, -1 }), Point2({ 3, 0 })),
+        BSpline({ {0, 0}, {1, 2}, {2, -1}, {3, 1}, {4, 0} }, 3),
+        Clothoid(Point2({ 1, 1 }), 0.4, 0.1, 0.3, 5.0),
+    };
+    for (const auto& e : elements) {
+        const Segment& segment = asSegment(e);
+        Point2 a = std::visit([](const auto& seg) { return seg.getCoordinate(0.0); }, e);
+        Point2 b = std::visit([](const auto& seg) { return seg.getCoordinate(1.0); }, e);
+        EXPECT_EQ(segment.startPoint().x, a.x);
+        EXPECT_EQ(segment.startPoint().y, a.y);
+        EXPECT_EQ(segment.endPoint().x, b.x);
+        EXPECT_EQ(segment.endPoint().y, b.y);
+    }
+}
+
+TEST(JointValidityTests, BatchMatchesJointByJointCheck) {
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> angle(-PI, PI);
+    std::vector<Contour> contours(500);
+    std::vector<bool> expected(contours.size());
+    for (size_t c = 0; c < contours.size(); ++c) {
+        // Chains of arcs longer than a packing block, some broken by a tiny gap
+        Point2 p{ 0, 0 };
+        const size_t n = 1 + rng() % 600;
+        const size_t gap = (c % 3 == 0) ? rng() % n : n;
+        for (size_t i = 0; i < n; ++i) {
+            const double a = angle(rng);
+            Arc arc(Point2({ p.x - std::cos(a), p.y - std::sin(a) }), 1.0, a, a + 0.5, 8, i % 2 == 0);
+            contours[c].addItem(arc);
+            p = arc.getCoordinate(1.0);
+            if (i == gap && i + 1 < n) {
+                p.y += 1E-12;
+            }
+        }
+        bool valid = true;
+        auto elements = contours[c].getElements();
+        for (size_t i = 0; i + 1 < elements.size(); ++i) {
+            Point2 end = std::visit([](const auto& seg) { return seg.getCoordinate(1.0); }, elements[i]);
+            Point2 start = std::visit([](const auto& seg) { return seg.getCoordinate(0.0); }, elements[i + 1]);
+            valid = valid && start.isCloseTo(end, EPS);
+        }
+        expected[c] = valid;
+    }
+
+    auto result = validateContours(contours, 4);
+    size_t invalid = 0;
+    for (size_t c = 0; c < contours.size(); ++c) {
+        EXPECT_EQ(result[c] != 0, expected[c]) << c;
+        invalid += expected[c] ? 0 : 1;
+    }
+    EXPECT_GT(invalid, 100);
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourSink.h"
+#include "LSystem.h"
+#include "Point2.h"
+
+// Counts the stream and remembers the last element's end point
+class CountingSink : public ContourSink {
+public:
+    void push(const ContourElement& element) override {
+        ++count;
+        last = std::visit([](const auto& seg) { return seg.getCoordinate(1.0); }, element);
+    }
+    void finish() override { finished = true; }
+
+    size_t count = 0;
+    Point2 last{ 0, 0 };
+    bool finished = false;
+};
+
+static LSystem koch()
+{
+    LSystem system("F");
+    system.addRule('F', "F+F--F+F");
+    return system;
+}
+
+TEST(LSystemTests, ExpandsInOrder) {
+    LSystem system("A");
+    system.addRule('A', "AB").addRule('B', "A");
+
+    EXPECT_EQ(system.expandToString(0), "A");
+    EXPECT_EQ(system.expandToString(1), "AB");
+    EXPECT_EQ(system.expandToString(4), "ABAABABA");
+    EXPECT_EQ(system.length(4), 8);
+    EXPECT_EQ(system.length(10), system.expandToString(10).size());
+}
+
+TEST(LSystemTests, LengthSaturatesInsteadOfOverflowing) {
+    EXPECT_EQ(koch().length(3), 148);
+    EXPECT_EQ(koch().length(100), std::numeric_limits<uint64_t>::max());
+}
+
+TEST(LSystemTests, KochCurveIsValidContour) {
+    TurtleOptions options;
+    options.angle = PI / 3;
+
+    Contour contour;
+    size_t count = generateLSystem(koch(), 5, contour, options);
+
+    EXPECT_EQ(count, 1024);
+    EXPECT_EQ(contour.getElements().size(), 1024);
+    EXPECT_TRUE(contour.isValid());
+    Point2 end = std::visit([](const auto& seg) { return seg.getCoordinate(1.0); }, contour.getElements().back());
+    EXPECT_TRUE(end.isCloseTo(Point2({ 243, 0 }), 1E-9));
+}
+
+TEST(LSystemTests, StreamsLargeExpansionsWithoutMaterializing) {
+    TurtleOptions options;
+    options.angle = PI / 3;
+    CountingSink sink;
+
+    // 4^9 segments from a string of 2.6 million symbols, only the cursor stack is kept
+    size_t count = generateLSystem(koch(), 9, sink, options);
+
+    EXPECT_EQ(count, 262144);
+    EXPECT_EQ(sink.count, 262144);
+    EXPECT_TRUE(sink.finished);
+    EXPECT_TRUE(sink.last.isCloseTo(Point2({ 19683, 0 }), 1E-6));
+}
+
+TEST(LSystemTests, ArcsBranchesAndMoves) {
+    // Four quarter arcs make a closed circle
+    Contour circle;
+    generateLSystem(LSystem("(((("), 0, circle);
+    EXPECT_EQ(circle.getElements().size(), 4);
+    EXPECT_TRUE(circle.isValid());
+    EXPECT_TRUE(circle.isClosed());
+
+    // A branch returns to the saved position, moves leave gaps
+    CountingSink sink;
+    Turtle turtle(sink);
+    for (char c : std::string("F[+F]F f)")) {
+        turtle.interpret(c);
+    }
+    EXPECT_EQ(turtle.elementCount(), 4);
+    EXPECT_TRUE(turtle.position().isCloseTo(Point2({ 4, -1 }), 1E-12));
+    EXPECT_NEAR(turtle.heading(), -PI / 2, 1E-15);
+}
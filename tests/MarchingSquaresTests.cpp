@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "MarchingSquares.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+
+static std::vector<double> sampleField(const DistanceFieldGrid& grid, const std::function<double(double, double)>& f)
+{
+    std::vector<double> values(grid.width * grid.height);
+    for (size_t j = 0; j < grid.height; ++j) {
+        for (size_t i = 0; i < grid.width; ++i) {
+            values[j * grid.width + i] = f(grid.origin.x + i * grid.spacing, grid.origin.y + j * grid.spacing);
+        }
+    }
+    return values;
+}
+
+static double signedArea(const Contour& contour)
+{
+    double area = 0;
+    for (const auto& e : contour.getElements()) {
+        Point2 a = std::visit([](const auto& seg) { return seg.getCoordinate(0.0); }, e);
+        Point2 b = std::visit([](const auto& seg) { return seg.getCoordinate(1.0); }, e);
+        area += a.x * b.y - b.x * a.y;
+        if (const Arc* arc = std::get_if<Arc>(&e)) {
+            // Circular segment between the chord and the arc
+            double sweep = arc->getEndAngle() - arc->getStartAngle();
+            area += arc->getRadius() * arc->getRadius() * (sweep - std::sin(sweep));
+        }
+    }
+    return area / 2;
+}
+
+TEST(MarchingSquaresTests, CircleIsClosedAndCounterClockwise) {
+    DistanceFieldGrid grid{ Point2{ -2, -2 }, 0.05, 81, 81 };
+    auto values = sampleField(grid, [](double x, double y) { return 1.0 - std::hypot(x - 0.1, y + 0.2); });
+
+    IsolineOptions options;
+    options.tile_size = 7; // the circle crosses many tiles
+    options.num_threads = 4;
+    auto contours = extractIsolines(values, grid, 0.0, options);
+
+    ASSERT_EQ(contours.size(), 1);
+    EXPECT_TRUE(contours[0].isValid());
+    EXPECT_TRUE(contours[0].isClosed());
+    EXPECT_NEAR(signedArea(contours[0]), PI, 1E-2);
+    for (const auto& e : contours[0].getElements()) {
+        Point2 p = std::get<Line2>(e).getCoordinate(0.0);
+        EXPECT_NEAR(std::hypot(p.x - 0.1, p.y + 0.2), 1.0, 2E-3);
+    }
+
+    IsolineOptions single;
+    single.tile_size = 1000;
+    auto reference = extractIsolines(values, grid, 0.0, single);
+    ASSERT_EQ(reference.size(), 1);
+    EXPECT_EQ(reference[0].getElements().size(), contours[0].getElements().size());
+}
+
+TEST(MarchingSquaresTests, SeveralLevelsInOnePass) {
+    DistanceFieldGrid grid{ Point2{ 0, 0 }, 0.1, 101, 51 };
+    // Two bumps, joined below the saddle level 0.21 and apart above it
+    auto values = sampleField(grid, [](double x, double y) {
+        return std::exp(-((x - 3.5) * (x - 3.5) + (y - 2.5) * (y - 2.5))) + std::exp(-((x - 6.5) * (x - 6.5) + (y - 2.5) * (y - 2.5)));
+    });
+
+    IsolineOptions options;
+    options.tile_size = 16;
+    auto levels = extractIsolines(values, grid, { 0.1, 0.15, 0.8 }, options);
+
+    ASSERT_EQ(levels.size(), 3);
+    EXPECT_EQ(levels[0].size(), 1);
+    EXPECT_EQ(levels[1].size(), 1);
+    EXPECT_EQ(levels[2].size(), 2);
+    for (const auto& contours : levels) {
+        for (const auto& c : contours) {
+            EXPECT_TRUE(c.isValid());
+            EXPECT_TRUE(c.isClosed());
+            EXPECT_GT(signedArea(c), 0);
+        }
+    }
+}
+
+TEST(MarchingSquaresTests, OpenIsolinesLeaveTheGrid) {
+    DistanceFieldGrid grid{ Point2{ 0, 0 }, 1.0, 40, 30 };
+    auto values = sampleField(grid, [](double x, double) { return x; });
+
+    IsolineOptions options;
+    options.tile_size = 4;
+    auto contours = extractIsolines(values, grid, 12.5, options);
+
+    ASSERT_EQ(contours.size(), 1);
+    EXPECT_TRUE(contours[0].isValid());
+    EXPECT_FALSE(contours[0].isClosed());
+    auto elements = contours[0].getElements();
+    EXPECT_EQ(elements.size(), 29);
+    // Larger x on the left, so the line runs downwards
+    EXPECT_TRUE(std::get<Line2>(elements.front()).getCoordinate(0.0).isCloseTo(Point2({ 12.5, 29 }), 1E-12));
+    EXPECT_TRUE(std::get<Line2>(elements.back()).getCoordinate(1.0).isCloseTo(Point2({ 12.5, 0 }), 1E-12));
+}
+
+TEST(MarchingSquaresTests, FitsArcsAlongSmoothRuns) {
+    DistanceFieldGrid grid{ Point2{ -3, -3 }, 0.02, 301, 301 };
+    auto values = sampleField(grid, [](double x, double y) { return 2.0 - std::hypot(x, y); });
+
+    IsolineOptions options;
+    options.tile_size = 64;
+    options.fit_arcs = true;
+    auto contours = extractIsolines(values, grid, 0.0, options);
+
+    ASSERT_EQ(contours.size(), 1);
+    EXPECT_TRUE(contours[0].isValid());
+    EXPECT_TRUE(contours[0].isClosed());
+    auto elements = contours[0].getElements();
+    EXPECT_LT(elements.size(), 40);
+    for (const auto& e : elements) {
+        if (const Arc* arc = std::get_if<Arc>(&e)) {
+            EXPECT_NEAR(arc->getRadius(), 2.0, 1E-3);
+            EXPECT_TRUE(arc->getCenter().isCloseTo(Point2({ 0, 0 }), 1E-3));
+        }
+    }
+    EXPECT_NEAR(signedArea(contours[0]), 4 * PI, 0.05);
+}
+
+TEST(MarchingSquaresTests, NoDataCellsAndBadInput) {
+    DistanceFieldGrid grid{ Point2{ 0, 0 }, 1.0, 20, 20 };
+    auto values = sampleField(grid, [](double x, double) { return x; });
+    values[10 * grid.width + 5] = std::numeric_limits<double>::quiet_NaN();
+
+    // The NaN sample sits next to the isoline at x = 5.5, which splits around it
+    auto contours = extractIsolines(values, grid, 5.5);
+    EXPECT_EQ(contours.size(), 2);
+    for (const auto& c : contours) {
+        EXPECT_TRUE(c.isValid());
+    }
+
+    EXPECT_THROW(extractIsolines(std::vector<double>(10), grid, 0.5), std::invalid_argument);
+    IsolineOptions options;
+    options.tile_size = 0;
+    EXPECT_THROW(extractIsolines(values, grid, 0.5, options), std::invalid_argument);
+}
@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "PointRange.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+static std::vector<ContourElement> mixedElements()
+{
+    Line2 reversed(Point2({ 1, 0 }), Point2({ 0, 0 }), false);
+    Arc arc(Point2({ 2, 1 }), 1, -0.5 * PI, 0.0, 10);
+    Arc backwards(Point2({ 1, 1 }), 1, 0.0, 0.5 * PI, 12, false);
+    return {
+        reversed,
+        Line2(reversed.endPoint(), arc.startPoint()),
+        arc,
+        backwards,
+        Line2(backwards.endPoint(), Point2({ 0, 3 })),
+        CubicBezier(Point2({ 0, 3 }), Point2({ -1, 3 }), Point2({ -1, 2 }), Point2({ -2, 2 })),
+        BSpline({ {-2, 2}, {-3, 1}, {-2, 0}, {-3, -1}, {-2, -2} }, 3),
+        Clothoid(Point2({ -2, -2 }), 0.3, 0.1, 0.2, 2.0),
+    };
+}
+
+static void expectSamePoints(const std::vector<Point2>& expected, const std::vector<Point2>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].x, actual[i].x) << i;
+        EXPECT_EQ(expected[i].y, actual[i].y) << i;
+    }
+}
+
+static double distanceToSegment(const Point2& p, const Point2& a, const Point2& b)
+{
+    const double abx = b.x - a.x;
+    const double aby = b.y - a.y;
+    const double len2 = abx * abx + aby * aby;
+    const double t = len2 > 0 ? std::clamp(((p.x - a.x) * abx + (p.y - a.y) * aby) / len2, 0.0, 1.0) : 0.0;
+    return std::hypot(p.x - a.x - t * abx, p.y - a.y - t * aby);
+}
+
+TEST(PointRangeTests, ViewMatchesTessellation) {
+    Contour contour;
+    contour.addItems(mixedElements());
+    const std::vector<Point2> strip = contour.getLineStrip();
+    TessellationSettings fine;
+    fine.tolerance = 0.01;
+    const std::vector<Point2> tessellated = contour.tessellate(fine)->points;
+
+    {
+        ContourPointView view(contour);
+        expectSamePoints(strip, std::vector<Point2>(view.begin(), view.end()));
+    }
+    {
+        ContourPointView view(contour, fine);
+        expectSamePoints(tessellated, std::vector<Point2>(view.begin(), view.end()));
+    }
+
+    // Iterators are multi pass
+    ContourPointView view(contour);
+    auto it = view.begin();
+    auto copy = it;
+    ++it;
+    EXPECT_EQ(copy->x, strip[0].x);
+    EXPECT_EQ(it->x, strip[1].x);
+    EXPECT_EQ(static_cast<size_t>(std::distance(view.begin(), view.end())), strip.size());
+}
+
+TEST(PointRangeTests, ElementVectorsAndEmptyRanges) {
+    const auto elements = mixedElements();
+    Contour contour;
+    contour.addItems(elements);
+    auto points = pointsOf(elements);
+    expectSamePoints(contour.getLineStrip(), std::vector<Point2>(points.begin(), points.end()));
+
+    const std::vector<ContourElement> none;
+    auto empty = pointsOf(none);
+    EXPECT_TRUE(empty.begin() == empty.end());
+    auto simplified = simplifyPoints(pointsOf(none), 0.1);
+    EXPECT_TRUE(simplified.begin() == simplified.end());
+
+    // A single Line2 keeps both of its points
+    const std::vector<ContourElement> one = { Line2(Point2({ 0, 0 }), Point2({ 1, 0 })) };
+    auto line = simplifyPoints(pointsOf(one), 10.0);
+    std::vector<Point2> kept(line.begin(), line.end());
+    ASSERT_EQ(kept.size(), 2);
+    EXPECT_EQ(kept[1].x, 1.0);
+}
+
+TEST(PointRangeTests, TransformAndSimplifyCompose) {
+    // Noisy walk along a slowly turning direction, tessellated finely so there is a lot to drop
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> noise(-0.01, 0.01);
+    std::vector<Point2> walk{ { 0.0, 0.0 } };
+    for (int i = 1; i < 2000; ++i) {
+        const double heading = 0.002 * i;
+        walk.push_back(Point2({ walk.back().x + 0.05 * std::cos(heading) + noise(rng), walk.back().y + 0.05 * std::sin(heading) + noise(rng) }));
+    }
+    Contour contour = contourFromPoints(walk);
+    ContourPointView view(contour);
+
+    auto shifted = transformPoints(view, [](const Point2& p) { return Point2({ p.x + 100, p.y - 50 }); });
+    std::vector<Point2> moved(shifted.begin(), shifted.end());
+    const std::vector<Point2> strip(view.begin(), view.end());
+    ASSERT_EQ(moved.size(), strip.size());
+    EXPECT_EQ(moved[7].x, strip[7].x + 100);
+    EXPECT_EQ(moved[7].y, strip[7].y - 50);
+
+    const double tolerance = 0.1;
+    auto simplified = simplifyPoints(shifted, tolerance);
+    std::vector<Point2> kept(simplified.begin(), simplified.end());
+    EXPECT_LT(kept.size(), moved.size() / 10);
+    EXPECT_EQ(kept.front().x, moved.front().x);
+    EXPECT_EQ(kept.back().x, moved.back().x);
+    EXPECT_EQ(kept.back().y, moved.back().y);
+
+    // Kept points are input points in order, everything dropped between two of them is within tolerance of their chord
+    size_t from = 0;
+    for (size_t k = 1; k < kept.size(); ++k) {
+        size_t to = from + 1;
+        while (to < moved.size() && !(moved[to].x == kept[k].x && moved[to].y == kept[k].y)) {
+            ++to;
+        }
+        ASSERT_LT(to, moved.size()) << k;
+        for (size_t i = from + 1; i < to; ++i) {
+            EXPECT_LE(distanceToSegment(moved[i], kept[k - 1], kept[k]), tolerance + 1E-9) << i;
+        }
+        from = to;
+    }
+    EXPECT_EQ(from, moved.size() - 1);
+}
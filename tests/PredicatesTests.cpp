@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourDistance.h"
+#include "Predicates.h"
+#include "Point2.h"
+
+#include <cmath>
+#include <random>
+
+// Coordinates are BASE + k * STEP with integer k, so exact references can work on k in 128 bit integers
+static const double BASE = std::ldexp(1.0, 30);
+static const double STEP = std::ldexp(1.0, -22);
+
+static Point2 gridPoint(int64_t kx, int64_t ky)
+{
+    return Point2({ BASE + kx * STEP, BASE + ky * STEP });
+}
+
+static int sign128(__int128 v)
+{
+    return (v > 0) - (v < 0);
+}
+
+static int orientReference(int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t cx, int64_t cy)
+{
+    return sign128(__int128(bx - ax) * (cy - ay) - __int128(by - ay) * (cx - ax));
+}
+
+TEST(PredicatesTests, OrientationNearCollinearPoints) {
+    // Points next to the line through (12, 12) and (24, 24), a classic failure of the plain determinant
+    const double ulp = std::ldexp(1.0, -53);
+    const Point2 q{ 12, 12 };
+    const Point2 r{ 24, 24 };
+    size_t naive_wrong = 0;
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 64; ++j) {
+            const Point2 p{ 0.5 + i * ulp, 0.5 + j * ulp };
+            // In units of ulp: p = (2^52 + i, 2^52 + j), q = 12 * 2^53, r = 24 * 2^53
+            const int64_t half = int64_t(1) << 52;
+            const int expected = orientReference(half + i, half + j, 12 * (half << 1), 12 * (half << 1), 24 * (half << 1), 24 * (half << 1));
+            EXPECT_EQ(sign(orient2d(p, q, r)), expected) << i << " " << j;
+            EXPECT_EQ(sign(orient2d(q, r, p)), expected) << i << " " << j;
+            const double naive = (q.x - p.x) * (r.y - p.y) - (q.y - p.y) * (r.x - p.x);
+            naive_wrong += sign(naive) != expected ? 1 : 0;
+        }
+    }
+    EXPECT_GT(naive_wrong, 0);
+}
+
+TEST(PredicatesTests, IncircleFarFromTheOrigin) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> angle(0, 2 * PI);
+    const double radius = std::ldexp(1.0, 27);
+    size_t checked = 0;
+    for (int n = 0; n < 2000; ++n) {
+        // Four points rounded to the grid from one circle, nearly cocircular
+        int64_t k[8];
+        for (int i = 0; i < 4; ++i) {
+            const double a = angle(rng);
+            k[2 * i] = std::llround(radius * std::cos(a));
+            k[2 * i + 1] = std::llround(radius * std::sin(a));
+        }
+        if (orientReference(k[0], k[1], k[2], k[3], k[4], k[5]) <= 0) {
+            continue;
+        }
+        __int128 m[3][3];
+        for (int i = 0; i < 3; ++i) {
+            const __int128 dx = k[2 * i] - k[6];
+            const __int128 dy = k[2 * i + 1] - k[7];
+            m[i][0] = dx;
+            m[i][1] = dy;
+            m[i][2] = dx * dx + dy * dy;
+        }
+        const __int128 det = m[0][2] * (m[1][0] * m[2][1] - m[2][0] * m[1][1]) +
+            m[1][2] * (m[2][0] * m[0][1] - m[0][0] * m[2][1]) +
+            m[2][2] * (m[0][0] * m[1][1] - m[1][0] * m[0][1]);
+        const Point2 a = gridPoint(k[0], k[1]);
+        const Point2 b = gridPoint(k[2], k[3]);
+        const Point2 c = gridPoint(k[4], k[5]);
+        const Point2 d = gridPoint(k[6], k[7]);
+        ASSERT_EQ(sign(incircle(a, b, c, d)), sign128(det)) << n;
+        ++checked;
+    }
+    EXPECT_GT(checked, 500);
+
+    // Exactly cocircular, then nudged inside and outside by one ulp
+    const Point2 a{ BASE + 1, BASE };
+    const Point2 b{ BASE, BASE + 1 };
+    const Point2 c{ BASE - 1, BASE };
+    EXPECT_EQ(incircle(a, b, c, Point2({ BASE, BASE - 1 })), 0.0);
+    EXPECT_GT(incircle(a, b, c, Point2({ BASE, std::nextafter(BASE - 1, BASE) })), 0.0);
+    EXPECT_LT(incircle(a, b, c, Point2({ BASE, std::nextafter(BASE - 1, 0.0) })), 0.0);
+    EXPECT_EQ(circleSide(Point2({ BASE, BASE }), 1.0, Point2({ BASE, BASE - 1 })), 0.0);
+    EXPECT_LT(circleSide(Point2({ BASE, BASE }), 1.0, Point2({ BASE, std::nextafter(BASE - 1, BASE) })), 0.0);
+}
+
+TEST(PredicatesTests, ContainmentMatchesExactOrientation) {
+    // Slanted triangle far from the origin, queried right next to its edges
+    const int64_t v[6] = { 0, 0, 200000003, 100000001, 50000017, 300000007 };
+    Contour triangle = contourFromPoints({ gridPoint(v[0], v[1]), gridPoint(v[2], v[3]), gridPoint(v[4], v[5]), gridPoint(v[0], v[1]) });
+    ContourDistanceIndex index(triangle);
+    ASSERT_TRUE(index.isClosed());
+
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<int64_t> t(0, 1000000);
+    std::uniform_int_distribution<int64_t> jitter(-2, 2);
+    size_t checked = 0;
+    for (int n = 0; n < 3000; ++n) {
+        // A point on a random edge, moved by a couple of grid steps
+        const int e = n % 3;
+        const int64_t* p0 = v + 2 * e;
+        const int64_t* p1 = v + 2 * ((e + 1) % 3);
+        const __int128 s = t(rng);
+        const int64_t x = int64_t(p0[0] + (__int128(p1[0] - p0[0]) * s) / 1000000) + jitter(rng);
+        const int64_t y = int64_t(p0[1] + (__int128(p1[1] - p0[1]) * s) / 1000000) + jitter(rng);
+        const int o0 = orientReference(v[0], v[1], v[2], v[3], x, y);
+        const int o1 = orientReference(v[2], v[3], v[4], v[5], x, y);
+        const int o2 = orientReference(v[4], v[5], v[0], v[1], x, y);
+        if (o0 == 0 || o1 == 0 || o2 == 0) {
+            continue; // on an edge, either answer is acceptable
+        }
+        const bool inside = o0 > 0 && o1 > 0 && o2 > 0;
+        ASSERT_EQ(index.contains(gridPoint(x, y)), inside) << n;
+        ++checked;
+    }
+    EXPECT_GT(checked, 1000);
+}
+
+TEST(PredicatesTests, SegmentIntersection) {
+    EXPECT_TRUE(segmentsIntersect(Point2({ 0, 0 }), Point2({ 2, 2 }), Point2({ 0, 2 }), Point2({ 2, 0 })));
+    EXPECT_FALSE(segmentsIntersect(Point2({ 0, 0 }), Point2({ 1, 1 }), Point2({ 0, 2 }), Point2({ 0.9, 1.1 })));
+    // Touching at an end point, collinear overlap and collinear but apart
+    EXPECT_TRUE(segmentsIntersect(Point2({ 0, 0 }), Point2({ 1, 1 }), Point2({ 1, 1 }), Point2({ 2, 0 })));
+    EXPECT_TRUE(segmentsIntersect(Point2({ 0, 0 }), Point2({ 2, 2 }), Point2({ 1, 1 }), Point2({ 3, 3 })));
+    EXPECT_FALSE(segmentsIntersect(Point2({ 0, 0 }), Point2({ 1, 1 }), Point2({ 2, 2 }), Point2({ 3, 3 })));
+    EXPECT_EQ(lineSide(Point2({ 0, 0 }), Point2({ 1, 0 }), Point2({ 5, 1E-300 })), 1);
+}
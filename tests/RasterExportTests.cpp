@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "RasterExport.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+#include <filesystem>
+#include <fstream>
+
+// 100x100 pixels mapped one to one onto the world window [0, 100] x [0, 100]
+static RasterOptions unitOptions()
+{
+    RasterOptions options;
+    options.width = 100;
+    options.height = 100;
+    options.view.expand(Point2{ 0, 0 });
+    options.view.expand(Point2{ 100, 100 });
+    options.num_threads = 4;
+    options.tile_size = 16;
+    return options;
+}
+
+static Contour square(double x0, double y0, double x1, double y1)
+{
+    return contourFromPoints({ Point2{x0, y0}, Point2{x1, y0}, Point2{x1, y1}, Point2{x0, y1}, Point2{x0, y0} });
+}
+
+TEST(RasterExportTests, StrokeCoversEdgesOnly) {
+    RasterOptions options = unitOptions();
+    RasterImage image = renderContours({ square(20.5, 20.5, 80.5, 80.5) }, options);
+
+    // World y = 20.5 lands on image row 79.5, the center of row 79
+    EXPECT_EQ(image.getPixel(50, 79).r, 0);
+    EXPECT_EQ(image.getPixel(50, 50).r, 255);
+    EXPECT_EQ(image.getPixel(5, 5).r, 255);
+}
+
+TEST(RasterExportTests, FillWithHole) {
+    RasterOptions options = unitOptions();
+    options.stroke = false;
+    options.fill = true;
+    options.fill_color = RasterColor{ 0, 0, 0 };
+    RasterImage image = renderContours({ square(10, 10, 90, 90), square(40, 40, 60, 60) }, options);
+
+    EXPECT_EQ(image.getPixel(20, 50).r, 0);    // inside the outer square
+    EXPECT_EQ(image.getPixel(50, 50).r, 255);  // inside the hole
+    EXPECT_EQ(image.getPixel(5, 50).r, 255);   // outside
+}
+
+TEST(RasterExportTests, FillIsAntiAliased) {
+    RasterOptions options = unitOptions();
+    options.stroke = false;
+    options.fill = true;
+    options.fill_color = RasterColor{ 0, 0, 0 };
+    RasterImage image = renderContours({ square(10.5, 10, 90, 90) }, options);
+
+    // Half of pixel column 10 is covered
+    EXPECT_NEAR(image.getPixel(10, 50).r, 128, 2);
+}
+
+TEST(RasterExportTests, ArcsAreFlattened) {
+    Contour circle;
+    circle.addItem(Arc(Point2({ 50, 50 }), 30, 0, PI));
+    circle.addItem(Arc(Point2({ 50, 50 }), 30, PI, 2 * PI));
+    RasterOptions options = unitOptions();
+    options.fill = true;
+    RasterImage image = renderContours({ circle }, options);
+
+    EXPECT_EQ(image.getPixel(50, 50).r, options.fill_color.r);
+    EXPECT_EQ(image.getPixel(95, 50).r, 255);
+    EXPECT_LT(image.getPixel(50, 19).r, 200); // the top of the circle at world y = 80 touches row 19
+}
+
+TEST(RasterExportTests, WritesNetpbmFiles) {
+    auto dir = std::filesystem::temp_directory_path();
+    std::string pgm = (dir / "contour_raster_test.pgm").string();
+    std::string ppm = (dir / "contour_raster_test.ppm").string();
+
+    RasterOptions options;
+    options.width = 32;
+    options.height = 16;
+    exportContoursToPGM({ square(0, 0, 1, 1) }, pgm, options);
+    exportContoursToPPM({ square(0, 0, 1, 1) }, ppm, options);
+
+    EXPECT_EQ(std::filesystem::file_size(pgm), std::string("P5\n32 16\n255\n").size() + 32 * 16);
+    EXPECT_EQ(std::filesystem::file_size(ppm), std::string("P6\n32 16\n255\n").size() + 32 * 16 * 3);
+    std::filesystem::remove(pgm);
+    std::filesystem::remove(ppm);
+}
@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "ContourStats.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <random>
+#include <thread>
+
+// Line strips of all elements end to end, tessellated from scratch
+static std::vector<Point2> freshStrip(const Contour& contour)
+{
+    std::vector<Point2> points;
+    for (const auto& e : contour.getElements()) {
+        auto strip = std::visit([](const auto& seg) { return seg.getLineStrip(); }, e);
+        points.insert(points.end(), strip.begin(), strip.end());
+    }
+    return points;
+}
+
+static void expectSamePoints(const std::vector<Point2>& a, const std::vector<Point2>& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].x, b[i].x) << i;
+        EXPECT_EQ(a[i].y, b[i].y) << i;
+    }
+}
+
+static ContourElement randomElement(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> u(-10, 10);
+    Point2 p{ u(rng), u(rng) };
+    if (rng() % 2) {
+        return Arc(p, 1 + std::fabs(u(rng)), 0.0, u(rng) / 4, 3 + rng() % 10);
+    }
+    return Line2(p, Point2({ u(rng), u(rng) }));
+}
+
+TEST(TessellationCacheTests, SharedUntilMutation) {
+    Contour contour;
+    contour.addItem(Line2(Point2({ 0, 0 }), Point2({ 1, 0 })));
+    contour.addItem(Arc(Point2({ 1, 1 }), 1, -0.5 * PI, 0.0, 10));
+
+    auto a = contour.tessellate();
+    auto b = contour.tessellate();
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_EQ(a->offsets, (std::vector<size_t>{ 0, 2, 13 }));
+    expectSamePoints(a->points, freshStrip(contour));
+    expectSamePoints(contour.getLineStrip(), a->points);
+
+    contour.addItem(Line2(Point2({ 2, 1 }), Point2({ 2, 2 })));
+    auto c = contour.tessellate();
+    EXPECT_NE(a.get(), c.get());
+    EXPECT_EQ(a->points.size(), 13); // strips handed out earlier are left alone
+    expectSamePoints(c->points, freshStrip(contour));
+
+    // Copies share the cache
+    Contour copy(contour);
+    EXPECT_EQ(copy.tessellate().get(), c.get());
+}
+
+TEST(TessellationCacheTests, SettingsAreSeparateKeys) {
+    Contour contour;
+    contour.addItem(Arc(Point2({ 0, 0 }), 1, 0.0, PI, 20));
+    contour.addItem(CubicBezier(Point2({ -1, 0 }), Point2({ -1, -1 }), Point2({ 1, -1 }), Point2({ 1, 0 })));
+
+    auto standard = contour.tessellate();
+    TessellationSettings coarse;
+    coarse.arc_resolution = 4;
+    EXPECT_EQ(contour.tessellate(coarse)->offsets[1], 5);
+
+    TessellationSettings loose;
+    loose.tolerance = 1E-2;
+    TessellationSettings tight;
+    tight.tolerance = 1E-5;
+    auto a = contour.tessellate(loose);
+    auto b = contour.tessellate(tight);
+    EXPECT_GT(b->points.size(), 10 * a->points.size());
+    // Chord error of the arc is within the tolerance
+    const double half_step = PI / (b->offsets[1] - 1) / 2;
+    EXPECT_LE(1 - std::cos(half_step), 1E-5);
+
+    EXPECT_EQ(contour.tessellate().get(), standard.get());
+}
+
+TEST(TessellationCacheTests, EditsRetessellateOnlyTheirRange) {
+    std::mt19937 rng(5);
+    Contour contour;
+    for (int i = 0; i < 200; ++i) {
+        contour.addItem(randomElement(rng));
+    }
+    contour.tessellate();
+
+    for (int round = 0; round < 200; ++round) {
+        const size_t size = contour.getElements().size();
+        switch (rng() % 6) {
+        case 0: contour.addItem(randomElement(rng)); break;
+        case 1: contour.addItemAt(randomElement(rng), static_cast<unsigned int>(rng() % (size + 1))); break;
+        case 2: contour.addItemToCenter(randomElement(rng)); break;
+        case 3: if (size > 0) contour.clearAtIndex(static_cast<int>(rng() % size)); break;
+        case 4: {
+            size_t first = rng() % (size + 1);
+            contour.eraseRange(first, std::min(size, first + rng() % 4));
+            break;
+        }
+        case 5: {
+            ContourEdit edit;
+            edit.insert(0, randomElement(rng)).replace(size / 2, randomElement(rng)).erase(size).append(randomElement(rng));
+            contour.apply(edit);
+            break;
+        }
+        }
+        if (round % 3 == 0) {
+            auto strip = contour.tessellate();
+            ASSERT_EQ(strip->offsets.size(), contour.getElements().size() + 1);
+            expectSamePoints(strip->points, freshStrip(contour));
+        }
+    }
+
+    if (!contourStatisticsEnabled()) {
+        return;
+    }
+    contour.tessellate();
+    resetContourStatistics();
+    contour.addItemAt(Line2(Point2({ 0, 0 }), Point2({ 1, 1 })), 7);
+    contour.tessellate();
+    contour.tessellate();
+    ContourStatistics stats = getContourStatistics();
+    EXPECT_EQ(stats[ContourStat::TessellatedPoints], 2); // the Line2 only
+    EXPECT_EQ(stats[ContourStat::TessellationCalls], 2);
+    EXPECT_EQ(stats[ContourStat::TessellationCacheHits], 1);
+}
+
+TEST(TessellationCacheTests, ReadersDuringWrites) {
+    Contour contour = contourFromPoints({ Point2{0, 0}, Point2{1, 0}, Point2{1, 1} });
+    std::thread writer([&]() {
+        for (int i = 0; i < 500; ++i) {
+            contour.addItem(Arc(Point2({ 1.0 * i, 0 }), 1, 0.0, PI, 4));
+        }
+    });
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            for (int i = 0; i < 500; ++i) {
+                auto strip = contour.tessellate();
+                // Two Line2s and the arcs added so far, five points each
+                const size_t arcs = strip->offsets.size() - 3;
+                EXPECT_EQ(strip->points.size(), 4 + 5 * arcs);
+            }
+        });
+    }
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    expectSamePoints(contour.tessellate()->points, freshStrip(contour));
+}
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include "Contour.h"
+#include "Triangulation.h"
+#include "Point2.h"
+#include "Line2.h"
+#include "Arc.h"
+
+#include <cmath>
+#include <random>
+
+// Sum of the triangle areas, fails if a triangle is clockwise
+static double meshArea(const TriangleMesh& mesh)
+{
+    double total = 0;
+    for (size_t t = 0; t < mesh.triangleCount(); ++t) {
+        const uint32_t* tri = &mesh.indices[3 * t];
+        double ax = mesh.vertices[2 * tri[0]], ay = mesh.vertices[2 * tri[0] + 1];
+        double bx = mesh.vertices[2 * tri[1]], by = mesh.vertices[2 * tri[1] + 1];
+        double cx = mesh.vertices[2 * tri[2]], cy = mesh.vertices[2 * tri[2] + 1];
+        double area = ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax)) / 2;
+        EXPECT_GE(area, 0.0) << "triangle " << t;
+        total += area;
+    }
+    return total;
+}
+
+TEST(TriangulationTests, Square) {
+    TriangleMesh mesh = triangulate(contourFromPoints({ {0, 0}, {1, 0}, {1, 1}, {0, 1}, {0, 0} }));
+
+    EXPECT_EQ(mesh.vertexCount(), 4);
+    EXPECT_EQ(mesh.triangleCount(), 2);
+    EXPECT_NEAR(meshArea(mesh), 1.0, 1E-12);
+}
+
+TEST(TriangulationTests, HolesFollowTheEvenOddRule) {
+    // Both rings counter clockwise, the inner one is still a hole
+    Contour outer = contourFromPoints({ {0, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0} });
+    Contour hole = contourFromPoints({ {1, 1}, {3, 1}, {2, 3}, {1, 1} });
+    Contour island = contourFromPoints({ {1.8, 1.5}, {2.2, 1.5}, {2, 2}, {1.8, 1.5} });
+
+    TriangleMesh mesh = triangulate({ outer, hole });
+    EXPECT_EQ(mesh.triangleCount(), 4 + 3 + 2 - 2);
+    EXPECT_NEAR(meshArea(mesh), 16.0 - 2.0, 1E-12);
+
+    mesh = triangulate({ outer, hole, island });
+    EXPECT_NEAR(meshArea(mesh), 16.0 - 2.0 + 0.1, 1E-12);
+}
+
+TEST(TriangulationTests, FlattensArcsAdaptively) {
+    Contour circle;
+    circle.addItem(Arc(Point2({ 0, 0 }), 1.0, 0.0, PI));
+    circle.addItem(Arc(Point2({ 0, 0 }), 1.0, PI, 2 * PI));
+
+    TriangulationOptions coarse;
+    coarse.flatness = 1E-2;
+    TriangulationOptions fine;
+    fine.flatness = 1E-5;
+    TriangleMesh a = triangulate(circle, coarse);
+    TriangleMesh b = triangulate(circle, fine);
+
+    EXPECT_GT(b.vertexCount(), 10 * a.vertexCount());
+    EXPECT_EQ(b.triangleCount(), b.vertexCount() - 2);
+    // The inscribed polygon misses at most flatness times the perimeter
+    EXPECT_NEAR(meshArea(a), PI, 2 * PI * 1E-2);
+    EXPECT_NEAR(meshArea(b), PI, 2 * PI * 1E-5);
+}
+
+TEST(TriangulationTests, LargeNonMonotoneOutline) {
+    // A star with random radii, full of split and merge vertices
+    const int n = 100000;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> radius(0.5, 1.5);
+    std::vector<Point2> points;
+    for (int i = 0; i < n; ++i) {
+        double a = 2 * PI * i / n;
+        double r = radius(rng);
+        points.push_back(Point2{ r * std::cos(a), r * std::sin(a) });
+    }
+    points.push_back(points.front());
+    double area = 0;
+    for (int i = 0; i < n; ++i) {
+        area += points[i].x * points[i + 1].y - points[i + 1].x * points[i].y;
+    }
+    area /= 2;
+
+    TriangleMesh mesh = triangulate(contourFromPoints(points));
+    EXPECT_EQ(mesh.triangleCount(), n - 2);
+    EXPECT_NEAR(meshArea(mesh), area, 1E-9);
+}
+
+TEST(TriangulationTests, BatchAndOpenContours) {
+    std::vector<std::vector<Contour>> shapes;
+    for (int i = 0; i < 20; ++i) {
+        double s = 1 + i;
+        shapes.push_back({ contourFromPoints({ {0, 0}, {s, 0}, {s, s}, {0, s}, {0, 0} }) });
+    }
+    TriangulationOptions options;
+    options.num_threads = 4;
+    auto meshes = triangulateBatch(shapes, options);
+    ASSERT_EQ(meshes.size(), shapes.size());
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        EXPECT_NEAR(meshArea(meshes[i]), (1.0 + i) * (1.0 + i), 1E-9);
+    }
+
+    EXPECT_THROW(triangulate(contourFromPoints({ {0, 0}, {1, 0}, {1, 1} })), std::invalid_argument);
+}